@@ -5,11 +5,15 @@ $RUN
 $RUN --compileropt=
 $RUN --compileropt= --buildtype=o3
 $RUN --compileropt= --buildtype=debug
+$RUN --compileropt= --buildtype=pgo
 
 $RUN --compileropt=-ffast-math
 $RUN --compileropt=-flto
 $RUN --compileropt=-fno-math-errno
 $RUN --compileropt=-fomit-frame-pointer
-$RUN --compileropt=-fprofile-generate
 $RUN --compileropt=-ftree-vectorize
 $RUN --compileropt=-funroll-loops
+
+PYTHONPATH=src/py python3 -m benchmark.compare --trend --name=lists
+PYTHONPATH=src/py python3 -m benchmark.compare --name=lists \
+  --baseline=-o3.json --candidate=-pgo.json
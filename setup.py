@@ -21,8 +21,10 @@ FLAGS = arguments.extract_env(
     benchmark='lists',
     benchmark_size=10240,
     benchmark_number=1000,
+    benchmark_repeat=5,
     buildtype='o3',
     compileropt=OPTS,
+    instrument=False,
     name='',
     tiny=False,
     models=''
@@ -42,20 +44,28 @@ BUILD_OPTIONS = dict(
     o2=['-O2', '-DNDEBUG'],
     o3=['-O3', '-DNDEBUG'],
     debug=['-O0', '-DDEBUG'],
+    pgo=['-O3', '-DNDEBUG'],
     )
 
+"""The pgo buildtype is profile-guided optimization: build_ext builds an
+   extension instrumented to write a profile to PGO_DIR, runs the training
+   workload in src/py/benchmark/training.py with it, and then rebuilds the
+   extension optimized with that profile.
+"""
+PGO_DIR = 'build/pgo'
+
 """See http://ithare.com/c-performance-common-wisdoms-and-common-wisdoms/
 Other possibilities include:
     -ffast-math
     -flto
     -fno-math-errno
     -fomit-frame-pointer
-    -fprofile-generate
     -ftree-vectorize
     -funroll-loops
 """
 
-import datetime, errno, glob, os, platform, re, shutil, subprocess, unittest
+import datetime, errno, glob, os, platform, re, shutil, subprocess, sysconfig
+import unittest
 import setuptools.extension
 from distutils.dir_util import copy_tree
 from setuptools.command.build_ext import build_ext as _build_ext
@@ -110,7 +120,9 @@ if IS_LINUX or IS_MAC:
         '-Wpedantic',
         '-Wno-unused-function',
         '-Wno-extended-offsetof',
+        '-pthread',
     ]
+    LINK_ARGS = ['-pthread']
     if IS_MAC:
         COMPILE_ARGS.extend(['-mmacosx-version-min=10.9',
                              '-Wno-tautological-constant-out-of-range-compare'])
@@ -126,6 +138,7 @@ elif IS_WINDOWS:
         # Disable warnings
         '/wd4800'
     ]
+    LINK_ARGS = []
 
 
 class Command(setuptools.Command):
@@ -201,7 +214,8 @@ class Benchmark(Command):
                 parts.append(o[2:])
             name = '_'.join(parts)
         run_benchmarks(FLAGS.benchmark.split(), '-'.join(parts),
-                       FLAGS.benchmark_size, FLAGS.benchmark_number)
+                       FLAGS.benchmark_size, FLAGS.benchmark_number,
+                       FLAGS.benchmark_repeat)
 
 
 class build_ext(_build_ext):
@@ -222,8 +236,14 @@ class build_ext(_build_ext):
             if FLAGS.compileropt:
                 opt_flags += FLAGS.compileropt.split()
             compile_args += opt_flags
+            flag_names = opt_flags[:]
+            if FLAGS.buildtype == 'pgo':
+                flag_names.append('-fprofile-use')
             compile_args.append(
-                '-DOPTIMIZATION_FLAGS="%s"' % ' '.join(sorted(opt_flags)))
+                '-DOPTIMIZATION_FLAGS="%s"' % ' '.join(sorted(flag_names)))
+
+        if FLAGS.instrument:
+            compile_args.append('-DTIMEDATA_INSTRUMENT')
 
         extension = setuptools.extension.Extension(
             name='timedata',
@@ -231,7 +251,7 @@ class build_ext(_build_ext):
             libraries=LIBRARIES,
             include_dirs=['src/cpp'],
             extra_compile_args=compile_args,
-            extra_link_args=opt_flags,
+            extra_link_args=opt_flags + LINK_ARGS,
             language='c++',
         )
 
@@ -248,6 +268,59 @@ class build_ext(_build_ext):
         self.distribution.ext_modules = module
         super(build_ext, self).finalize_options()
 
+    def run(self):
+        if FLAGS.buildtype != 'pgo':
+            return super(build_ext, self).run()
+
+        if IS_WINDOWS:
+            raise ValueError('The pgo buildtype needs gcc or clang')
+
+        profile = os.path.abspath(PGO_DIR)
+        shutil.rmtree(profile, ignore_errors=True)
+        os.makedirs(profile)
+        is_clang = IS_MAC or 'clang' in (
+            sysconfig.get_config_var('CC') or '')
+
+        # Every file must be rebuilt in each pass, and each pass needs the
+        # compiler name rather than the compiler object the last one made.
+        self.force = True
+        self.compiler_name = self.compiler
+        print('PGO: building an instrumented extension')
+        if is_clang:
+            self.build_with_flags(
+                '-fprofile-instr-generate=%s/%%p.profraw' % profile)
+        else:
+            self.build_with_flags('-fprofile-generate=' + profile)
+
+        print('PGO: running the training workload')
+        directory = os.path.dirname(self.get_ext_fullpath('timedata'))
+        env = dict(os.environ, TIMEDATA_SILENT_STARTUP='1',
+                   PYTHONPATH=os.path.join(ROOT_DIR, 'src', 'py'))
+        subprocess.check_call([sys.executable, '-m', 'benchmark.training'],
+                              cwd=os.path.abspath(directory), env=env)
+
+        print('PGO: rebuilding with the profile')
+        if is_clang:
+            profdata = os.path.join(profile, 'timedata.profdata')
+            subprocess.check_call(
+                ['llvm-profdata', 'merge', '-output=' + profdata] +
+                glob.glob(os.path.join(profile, '*.profraw')))
+            self.build_with_flags('-fprofile-instr-use=' + profdata)
+        else:
+            self.build_with_flags('-fprofile-use=' + profile,
+                                  '-fprofile-correction')
+
+    def build_with_flags(self, *flags):
+        for extension in self.extensions:
+            if not hasattr(extension, 'base_args'):
+                extension.base_args = (extension.extra_compile_args,
+                                       extension.extra_link_args)
+            compile_args, link_args = extension.base_args
+            extension.extra_compile_args = compile_args + list(flags)
+            extension.extra_link_args = link_args + list(flags)
+        self.compiler = self.compiler_name
+        super(build_ext, self).run()
+
 COMMANDS = {
     'benchmark': Benchmark,
     'build_ext': build_ext,
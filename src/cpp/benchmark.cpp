@@ -0,0 +1,31 @@
+#include <timedata/signal/sample.h>
+
+#include <cstdio>
+
+#include <timedata/color/cython_list_benchmark.cpp>
+
+// Benchmarks the list operations, conversions and rendering, and writes the
+// results as JSON.  For example:
+//
+//   $ build/benchmark --filter=RGB/add --sizes=16,65536 --root=/tmp
+
+int main(int argc, char** argv) {
+    timedata::BenchmarkSettings settings;
+    if (not settings.parse(argc, argv)) {
+        std::fprintf(stderr,
+            "Usage: %s [--sizes=16,256,...] [--filter=NAME] "
+            "[--repetitions=N] [--min-time=SECONDS] [--threads=N] "
+            "[--root=DIRECTORY] [--name=NAME] [--suffix=SUFFIX]\n", argv[0]);
+        return 2;
+    }
+
+    auto cases = timedata::color_list::benchmark::listCases();
+    auto results = timedata::runBenchmarks(cases, settings);
+    auto filename = timedata::writeBenchmarkResults(results, settings);
+    if (filename.empty()) {
+        std::fprintf(stderr, "Couldn't write the results\n");
+        return 1;
+    }
+    std::printf("Wrote %s\n", filename.c_str());
+    return 0;
+}
@@ -1,10 +1,31 @@
 #include <timedata/signal/sample.h>
 
+#define CATCH_CONFIG_COUNTER
 #define CATCH_CONFIG_MAIN
 
 #include <catch/catch.hpp>
+#include <timedata/base/benchmark_test.cpp>
+#include <timedata/base/dirtyRanges_test.cpp>
+#include <timedata/base/frameScheduler_test.cpp>
 #include <timedata/base/gammaTable_test.cpp>
+#include <timedata/base/instrument_test.cpp>
 #include <timedata/base/join_test.cpp>
 #include <timedata/base/math_test.cpp>
+#include <timedata/base/parallel_test.cpp>
+#include <timedata/base/trig_test.cpp>
+#include <timedata/base/tripleBuffer_test.cpp>
+#include <timedata/color/expression_test.cpp>
+#include <timedata/color/frameExchange_test.cpp>
+#include <timedata/color/mathKernels_test.cpp>
 #include <timedata/color/names_test.cpp>
+#include <timedata/color/planar_test.cpp>
+#include <timedata/color/renderer_test.cpp>
+#include <timedata/color/segmentRenderer_test.cpp>
+#include <timedata/signal/composite_test.cpp>
+#include <timedata/signal/convert_test.cpp>
+#include <timedata/signal/convertLut_test.cpp>
+#include <timedata/signal/fade_test.cpp>
+#include <timedata/signal/generator_test.cpp>
 #include <timedata/signal/signal_test.cpp>
+#include <timedata/signal/stripe_test.cpp>
+#include <timedata/signal/timeline_test.cpp>
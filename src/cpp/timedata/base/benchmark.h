@@ -0,0 +1,351 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+#ifndef WINDOWS
+#include <sys/utsname.h>
+#endif
+
+#include <timedata/base/parallel.h>
+#include <timedata/base/timestamp.h>
+
+namespace timedata {
+
+/** One run of a benchmarked operation, set up for one size of data.
+    `bytes` is the number of bytes the operation reads and writes. */
+struct BenchmarkRun {
+    std::function<void()> run;
+    size_t bytes = 0;
+};
+
+/** An operation to benchmark on data of many sizes.  setup(size) allocates
+    and fills the data for `size` elements, and returns a run that shares
+    it. */
+struct BenchmarkCase {
+    std::string name;
+    std::function<BenchmarkRun(size_t size)> setup;
+};
+
+struct BenchmarkSettings {
+    std::vector<size_t> sizes;
+
+    /** Each case is timed this many times, so that the results can be
+        summarized with a median and its spread. */
+    size_t repetitions = 5;
+
+    /** Each repetition runs the operation enough times to take at least
+        this many seconds. */
+    double minTime = 0.005;
+
+    /** Only run cases whose names contain this. */
+    std::string filter;
+
+    /** Write results to results/<name>/<date>/<time>.json under this
+        directory. */
+    std::string root = ".";
+    std::string name = "native";
+    std::string suffix;
+
+    /** 0 means the default number of threads. */
+    size_t threads = 0;
+
+    BenchmarkSettings();
+
+    /** Read flags like --sizes=16,1024 from the command line.  Returns false
+        and prints a message on a bad flag or value, or a size of 0. */
+    bool parse(int argc, char const* const* argv);
+};
+
+struct BenchmarkResult {
+    std::string name;
+    size_t size = 0, bytes = 0, iterations = 0;
+
+    /** The seconds per run of the operation, one for each repetition. */
+    std::vector<double> seconds;
+
+    double median() const;
+    double nanosecondsPerElement() const { return 1e9 * median() / size; }
+    double gigabytesPerSecond() const { return bytes / median() / 1e9; }
+};
+
+/** Run the cases at each size, printing a line for each result. */
+std::vector<BenchmarkResult> runBenchmarks(
+    std::vector<BenchmarkCase> const&, BenchmarkSettings const&);
+
+/** Write results as JSON in the layout of benchmark.py's write_result(), and
+    return the file name, or an empty string on failure. */
+std::string writeBenchmarkResults(
+    std::vector<BenchmarkResult> const&, BenchmarkSettings const&);
+
+/** Stop the compiler from optimizing away a value that is never used. */
+template <typename T>
+void keepValue(T const& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+
+inline BenchmarkSettings::BenchmarkSettings() {
+    // 16 to 4M elements, in powers of 4.
+    for (size_t size = 16; size <= (size_t(1) << 22); size *= 4)
+        sizes.push_back(size);
+}
+
+inline bool BenchmarkSettings::parse(int argc, char const* const* argv) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto equals = arg.find('=');
+        auto flag = arg.substr(0, equals);
+        auto value = equals == std::string::npos ? "" : arg.substr(equals + 1);
+
+        // std::stoul and std::stod throw on a value that isn't a number.
+        try {
+            if (flag == "--sizes") {
+                sizes.clear();
+                for (size_t b = 0; b < value.size(); ) {
+                    auto e = std::min(value.find(',', b), value.size());
+                    sizes.push_back(std::stoul(value.substr(b, e - b)));
+                    b = e + 1;
+                }
+                auto zero = std::find(sizes.begin(), sizes.end(), 0);
+                if (sizes.empty() or zero != sizes.end()) {
+                    std::fprintf(stderr, "Sizes must be positive in %s\n",
+                                 arg.c_str());
+                    return false;
+                }
+            } else if (flag == "--repetitions") {
+                repetitions = std::max(std::stoul(value), 1ul);
+            } else if (flag == "--min-time") {
+                minTime = std::stod(value);
+            } else if (flag == "--filter") {
+                filter = value;
+            } else if (flag == "--root") {
+                root = value;
+            } else if (flag == "--name") {
+                name = value;
+            } else if (flag == "--suffix") {
+                suffix = value;
+            } else if (flag == "--threads") {
+                threads = std::stoul(value);
+            } else {
+                std::fprintf(stderr, "Bad flag %s\n", arg.c_str());
+                return false;
+            }
+        } catch (std::logic_error const&) {
+            std::fprintf(stderr, "Bad value in %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+inline double BenchmarkResult::median() const {
+    auto s = seconds;
+    std::sort(s.begin(), s.end());
+    auto n = s.size();
+    return n % 2 ? s[n / 2] : (s[n / 2 - 1] + s[n / 2]) / 2;
+}
+
+namespace detail {
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+inline double timeRuns(BenchmarkRun const& run, size_t iterations) {
+    auto begin = BenchmarkClock::now();
+    for (size_t i = 0; i < iterations; ++i)
+        run.run();
+    auto end = BenchmarkClock::now();
+    return std::chrono::duration<double>(end - begin).count();
+}
+
+} // detail
+
+inline std::vector<BenchmarkResult> runBenchmarks(
+        std::vector<BenchmarkCase> const& cases,
+        BenchmarkSettings const& settings) {
+    if (settings.threads)
+        setThreadCount(settings.threads);
+
+    std::vector<BenchmarkResult> results;
+    std::printf("%-36s %10s %12s %10s\n", "case", "size", "ns/element",
+                "GB/s");
+    for (auto& c: cases) {
+        if (c.name.find(settings.filter) == std::string::npos)
+            continue;
+
+        for (auto size: settings.sizes) {
+            auto run = c.setup(size);
+
+            // Find how many runs take minTime, starting with one run which
+            // also warms the caches.
+            size_t iterations = 1;
+            while (detail::timeRuns(run, iterations) < settings.minTime)
+                iterations *= 2;
+
+            BenchmarkResult result;
+            result.name = c.name;
+            result.size = size;
+            result.bytes = run.bytes;
+            result.iterations = iterations;
+            for (size_t r = 0; r < settings.repetitions; ++r) {
+                auto seconds = detail::timeRuns(run, iterations);
+                result.seconds.push_back(seconds / iterations);
+            }
+
+            std::printf("%-36s %10zu %12.3f %10.3f\n", c.name.c_str(), size,
+                        result.nanosecondsPerElement(),
+                        result.gigabytesPerSecond());
+            std::fflush(stdout);
+            results.push_back(std::move(result));
+        }
+    }
+    return results;
+}
+
+namespace detail {
+
+inline bool makeDirectories(std::string const& path) {
+    for (size_t i = 1; i <= path.size(); ++i) {
+        if (i == path.size() or path[i] == '/') {
+            auto dir = path.substr(0, i);
+            struct stat info;
+            if (stat(dir.c_str(), &info) and mkdir(dir.c_str(), 0755))
+                return false;
+        }
+    }
+    return true;
+}
+
+inline std::string jsonString(std::string const& s) {
+    std::string result = "\"";
+    for (auto ch: s) {
+        if (ch == '"' or ch == '\\')
+            result += '\\';
+        result += ch;
+    }
+    return result + "\"";
+}
+
+inline std::string jsonNumber(double x) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.6g", x);
+    return buffer;
+}
+
+inline std::string resultName(BenchmarkResult const& result) {
+    return result.name + "/" + std::to_string(result.size);
+}
+
+/** The keys of an object, one per result, in name order. */
+template <typename Function>
+std::string jsonResults(std::vector<BenchmarkResult> const& results,
+                        Function value) {
+    std::vector<std::pair<std::string, std::string>> items;
+    for (auto& r: results)
+        items.emplace_back(jsonString(resultName(r)), value(r));
+    std::sort(items.begin(), items.end());
+
+    std::string json = "{";
+    for (auto& item: items) {
+        json += json.size() > 1 ? ",\n        " : "\n        ";
+        json += item.first + ": " + item.second;
+    }
+    return json + (items.empty() ? "}" : "\n    }");
+}
+
+inline std::string seconds(BenchmarkResult const& r) {
+    return jsonNumber(r.median());
+}
+
+inline std::string repetitions(BenchmarkResult const& r) {
+    std::string json = "[";
+    for (auto s: r.seconds)
+        json += (json.size() > 1 ? ", " : "") + jsonNumber(s);
+    return json + "]";
+}
+
+inline std::string metrics(BenchmarkResult const& r) {
+    return "{\"bytes\": " + std::to_string(r.bytes) +
+        ", \"gigabytes_per_second\": " + jsonNumber(r.gigabytesPerSecond()) +
+        ", \"iterations\": " + std::to_string(r.iterations) +
+        ", \"nanoseconds_per_element\": " +
+        jsonNumber(r.nanosecondsPerElement()) +
+        ", \"size\": " + std::to_string(r.size) + "}";
+}
+
+inline std::string platform() {
+#ifdef WINDOWS
+    return "{\"system\": \"Windows\", \"version\": \"\"}";
+#else
+    utsname name;
+    if (uname(&name))
+        return "{\"system\": \"\", \"version\": \"\"}";
+    return "{\"system\": " + jsonString(name.sysname) +
+        ", \"version\": " + jsonString(name.release) + "}";
+#endif
+}
+
+} // detail
+
+inline std::string writeBenchmarkResults(
+        std::vector<BenchmarkResult> const& results,
+        BenchmarkSettings const& settings) {
+    auto now = std::time(nullptr);
+    auto local = *std::localtime(&now);
+    char date[16], time[16], timestamp[32];
+    std::strftime(date, sizeof(date), "%Y%m%d", &local);
+    std::strftime(time, sizeof(time), "%H%M%S", &local);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", &local);
+
+    auto dir = settings.root + "/results/" + settings.name + "/" + date;
+    if (not detail::makeDirectories(dir))
+        return "";
+    auto filename = dir + "/" + time;
+    if (not settings.suffix.empty())
+        filename += "-" + settings.suffix;
+    filename += ".json";
+
+    std::string sizes = "[";
+    for (auto s: settings.sizes)
+        sizes += (sizes.size() > 1 ? ", " : "") + std::to_string(s);
+    sizes += "]";
+
+    // The keys are sorted, as they are by write_result().
+    std::string json = "{\n";
+    json += "    \"git_tags\": " + detail::jsonString(gitTags()) + ",\n";
+    json += "    \"metrics\": " +
+        detail::jsonResults(results, detail::metrics) + ",\n";
+    json += "    \"min_time\": " + detail::jsonNumber(settings.minTime) + ",\n";
+    json += "    \"name\": " + detail::jsonString(settings.name) + ",\n";
+    json += "    \"optimization_flags\": " +
+        detail::jsonString(optimizationFlags()) + ",\n";
+    json += "    \"platform\": " + detail::platform() + ",\n";
+    json += "    \"repetitions\": " +
+        detail::jsonResults(results, detail::repetitions) + ",\n";
+    json += "    \"results\": " +
+        detail::jsonResults(results, detail::seconds) + ",\n";
+    json += "    \"sizes\": " + sizes + ",\n";
+    json += "    \"threads\": " + std::to_string(threadCount()) + ",\n";
+    json += "    \"timestamp\": " + detail::jsonString(timestamp) + "\n";
+    json += "}\n";
+
+    auto file = std::fopen(filename.c_str(), "w");
+    if (not file)
+        return "";
+    auto written = std::fwrite(json.data(), 1, json.size(), file);
+    auto closed = not std::fclose(file);
+    return written == json.size() and closed ? filename : "";
+}
+
+} // timedata
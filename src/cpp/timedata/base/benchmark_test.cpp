@@ -0,0 +1,35 @@
+#pragma once
+
+#include <timedata/base/benchmark.h>
+
+namespace timedata {
+
+namespace {
+
+bool parseFlags(BenchmarkSettings& settings,
+                std::vector<char const*> flags) {
+    flags.insert(flags.begin(), "benchmark");
+    return settings.parse(int(flags.size()), flags.data());
+}
+
+} // namespace
+
+TEST_CASE("benchmarkSettings", "[benchmark]") {
+    BenchmarkSettings settings;
+    REQUIRE(parseFlags(settings, {"--sizes=16,1024", "--repetitions=0",
+                                  "--min-time=0.5", "--threads=2"}));
+    REQUIRE(settings.sizes == std::vector<size_t>({16, 1024}));
+    REQUIRE(settings.repetitions == 1);
+    REQUIRE(settings.minTime == 0.5);
+    REQUIRE(settings.threads == 2);
+
+    REQUIRE(not parseFlags(settings, {"--wombat"}));
+    REQUIRE(not parseFlags(settings, {"--sizes=abc"}));
+    REQUIRE(not parseFlags(settings, {"--sizes=16,0"}));
+    REQUIRE(not parseFlags(settings, {"--sizes="}));
+    REQUIRE(not parseFlags(settings, {"--min-time=slow"}));
+    REQUIRE(not parseFlags(settings, {"--threads"}));
+    REQUIRE(not parseFlags(settings, {"--repetitions=99999999999999999999"}));
+}
+
+} // timedata
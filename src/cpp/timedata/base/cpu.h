@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+
+#include <timedata/base/enum.h>
+
+/** TIMEDATA_X86_DISPATCH is set if we can compile kernels for instruction sets
+    beyond the baseline with target attributes and select between them at
+    runtime.  Otherwise only the scalar kernels exist. */
+#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__))
+#define TIMEDATA_X86_DISPATCH 1
+#include <immintrin.h>
+#else
+#define TIMEDATA_X86_DISPATCH 0
+#endif
+
+namespace timedata {
+
+/** The instruction sets we have kernels for, in increasing order of
+    preference. */
+enum class Isa { scalar, sse2, avx2, avx512, last = avx512 };
+
+/** Return the best instruction set that this CPU supports. */
+Isa bestIsa();
+
+/** Return the best supported instruction set that is no better than
+    `requested`. */
+Isa supportedIsa(Isa requested);
+
+/** Return a human-readable name for an Isa. */
+std::string isaName(Isa);
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+inline Isa bestIsa() {
+#if TIMEDATA_X86_DISPATCH
+    static auto const BEST =
+            __builtin_cpu_supports("avx512f") ? Isa::avx512 :
+            __builtin_cpu_supports("avx2") ? Isa::avx2 :
+            __builtin_cpu_supports("sse2") ? Isa::sse2 :
+            Isa::scalar;
+    return BEST;
+#else
+    return Isa::scalar;
+#endif
+}
+
+inline Isa supportedIsa(Isa requested) {
+    auto best = bestIsa();
+    return static_cast<int>(requested) < static_cast<int>(best) ?
+            requested : best;
+}
+
+inline std::string isaName(Isa isa) {
+    static char const* const NAMES[] = {"scalar", "sse2", "avx2", "avx512"};
+    static_assert(sizeof(NAMES) / sizeof(NAMES[0]) == enumSize<Isa>(),
+                  "Wrong number of Isa names");
+    return NAMES[static_cast<int>(isa)];
+}
+
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace timedata {
+
+/** A set of ranges [begin, end) of indices that have changed since they were
+    last consumed, kept sorted, with no two ranges touching.
+
+    So that consumers never have to deal with many tiny ranges, the set holds
+    at most MAX_DIRTY_RANGES ranges: past that, the two ranges with the
+    smallest gap between them are merged, which marks a few clean indices as
+    dirty. */
+class DirtyRanges {
+  public:
+    using Range = std::pair<size_t, size_t>;
+
+    /** Add the range [begin, end).  Empty ranges are ignored. */
+    void add(size_t begin, size_t end);
+
+    /** Add every range from another set. */
+    void add(DirtyRanges const&);
+
+    /** Remove every index at or past `size`. */
+    void truncate(size_t size);
+
+    void clear() { ranges_.clear(); }
+    bool empty() const { return ranges_.empty(); }
+
+    /** The total number of dirty indices. */
+    size_t count() const;
+
+    std::vector<Range> const& ranges() const { return ranges_; }
+
+    /** The number of ranges. */
+    size_t size() const { return ranges_.size(); }
+    Range const& operator[](size_t i) const { return ranges_[i]; }
+
+  private:
+    std::vector<Range> ranges_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+
+static size_t const MAX_DIRTY_RANGES = 64;
+
+inline void DirtyRanges::add(size_t begin, size_t end) {
+    if (begin >= end)
+        return;
+
+    // Find the ranges that overlap or touch [begin, end) and replace them
+    // with one range that covers all of them.
+    auto first = std::lower_bound(
+        ranges_.begin(), ranges_.end(), begin,
+        [](Range const& r, size_t b) { return r.second < b; });
+    auto last = first;
+    for (; last != ranges_.end() and last->first <= end; ++last) {
+        begin = std::min(begin, last->first);
+        end = std::max(end, last->second);
+    }
+    auto i = ranges_.erase(first, last);
+    ranges_.insert(i, {begin, end});
+
+    if (ranges_.size() > MAX_DIRTY_RANGES) {
+        size_t closest = 0;
+        for (size_t j = 1; j + 1 < ranges_.size(); ++j) {
+            auto gap = ranges_[j + 1].first - ranges_[j].second;
+            if (gap < ranges_[closest + 1].first - ranges_[closest].second)
+                closest = j;
+        }
+        ranges_[closest].second = ranges_[closest + 1].second;
+        ranges_.erase(ranges_.begin() + closest + 1);
+    }
+}
+
+inline void DirtyRanges::add(DirtyRanges const& other) {
+    for (auto& r: other.ranges_)
+        add(r.first, r.second);
+}
+
+inline void DirtyRanges::truncate(size_t size) {
+    while (not ranges_.empty() and ranges_.back().first >= size)
+        ranges_.pop_back();
+    if (not ranges_.empty())
+        ranges_.back().second = std::min(ranges_.back().second, size);
+}
+
+inline size_t DirtyRanges::count() const {
+    size_t count = 0;
+    for (auto& r: ranges_)
+        count += r.second - r.first;
+    return count;
+}
+
+} // timedata
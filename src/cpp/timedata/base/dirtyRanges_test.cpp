@@ -0,0 +1,73 @@
+#pragma once
+
+#include <timedata/base/dirtyRanges.h>
+
+namespace timedata {
+
+namespace {
+
+using Ranges = std::vector<DirtyRanges::Range>;
+
+/** The gaps between ranges. */
+Ranges gaps(DirtyRanges const& d) {
+    Ranges result;
+    for (size_t i = 1; i < d.size(); ++i)
+        result.push_back({d[i - 1].second, d[i].first});
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("dirtyRanges", "[dirtyRanges]") {
+    DirtyRanges d;
+    REQUIRE(d.empty());
+    d.add(5, 5);
+    REQUIRE(d.empty());
+
+    d.add(10, 20);
+    d.add(30, 40);
+    d.add(0, 2);
+    REQUIRE(d.ranges() == (Ranges{{0, 2}, {10, 20}, {30, 40}}));
+    REQUIRE(gaps(d) == (Ranges{{2, 10}, {20, 30}}));
+    REQUIRE(d.count() == 22);
+
+    // Ranges that touch or overlap are merged.
+    d.add(20, 25);
+    d.add(2, 3);
+    REQUIRE(d.ranges() == (Ranges{{0, 3}, {10, 25}, {30, 40}}));
+    d.add(12, 35);
+    REQUIRE(d.ranges() == (Ranges{{0, 3}, {10, 40}}));
+    d.add(1, 50);
+    REQUIRE(d.ranges() == (Ranges{{0, 50}}));
+
+    DirtyRanges e;
+    e.add(60, 70);
+    e.add(d);
+    REQUIRE(e.ranges() == (Ranges{{0, 50}, {60, 70}}));
+
+    e.truncate(65);
+    REQUIRE(e.ranges() == (Ranges{{0, 50}, {60, 65}}));
+    e.truncate(55);
+    REQUIRE(e.ranges() == (Ranges{{0, 50}}));
+    e.truncate(0);
+    REQUIRE(e.empty());
+}
+
+TEST_CASE("dirtyRanges merges the closest ranges", "[dirtyRanges]") {
+    DirtyRanges d;
+    for (size_t i = 0; i < MAX_DIRTY_RANGES; ++i)
+        d.add(10 * i, 10 * i + 1);
+    REQUIRE(d.size() == MAX_DIRTY_RANGES);
+
+    // The first of the equally close pairs is merged.
+    d.add(1000, 1001);
+    REQUIRE(d.size() == MAX_DIRTY_RANGES);
+    REQUIRE(d[0] == DirtyRanges::Range(0, 11));
+
+    d.add(995, 996);
+    REQUIRE(d.size() == MAX_DIRTY_RANGES);
+    REQUIRE(d[MAX_DIRTY_RANGES - 1] == DirtyRanges::Range(995, 1001));
+    REQUIRE(d.count() == MAX_DIRTY_RANGES + 10 + 5);
+}
+
+} // timedata
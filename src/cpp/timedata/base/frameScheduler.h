@@ -0,0 +1,314 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <timedata/base/latencyHistogram.h>
+
+namespace timedata {
+
+/** The three stages of a frame, each called with the frame's scheduled time
+    in seconds since the scheduler started.  Any stage may be empty, and no
+    stage may throw. */
+struct FramePipeline {
+    using Stage = std::function<void(double time)>;
+    Stage compute, render, output;
+};
+
+/** Make a stage that calls callback(context, time), for callers like Cython
+    that can't make a std::function themselves. */
+using FrameCallback = void (*)(void* context, double time);
+FramePipeline::Stage callbackStage(FrameCallback, void* context);
+
+/** How well a FrameScheduler has been keeping time.  Durations are in
+    nanoseconds. */
+struct FrameStats {
+    /** How long each stage took, and how long each whole frame took. */
+    LatencyHistogram compute, render, output, frame;
+
+    /** How long after its deadline each frame started. */
+    LatencyHistogram lateness;
+
+    uint64_t frames = 0;
+
+    /** Frames that finished after the next frame's deadline. */
+    uint64_t overruns = 0;
+
+    /** Deadlines that were skipped because an earlier frame overran. */
+    uint64_t dropped = 0;
+};
+
+/** Runs a FramePipeline once per frame at a fixed frame rate.
+
+    Frame k is due at start + k * period on the monotonic clock.  Because each
+    deadline is computed from the start rather than from the previous frame,
+    errors in sleeping never accumulate and the frame rate doesn't drift.
+    When a frame overruns, the next frame starts at once, and any deadlines
+    that passed entirely while it ran are dropped rather than run late in a
+    burst, so the schedule stays on its original grid.
+
+    The scheduler either runs frames on its own thread between start() and
+    stop(), or on the calling thread in run().  Everything else may be called
+    from any thread. */
+class FrameScheduler {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit FrameScheduler(double fps = 60);
+    ~FrameScheduler();
+
+    FrameScheduler(FrameScheduler const&) = delete;
+    FrameScheduler& operator=(FrameScheduler const&) = delete;
+
+    /** Set the pipeline.  This has no effect while frames are running. */
+    void setPipeline(FramePipeline);
+
+    double fps() const;
+
+    /** Set the frame rate, which takes effect from the next frame. */
+    void setFps(double);
+
+    /** How long before each deadline to stop sleeping and spin on the clock
+        instead, in seconds.  Sleeping often wakes up tens of microseconds
+        late, so spinning holds deadlines more closely at the cost of some
+        CPU.  The default is 0, never spin. */
+    double spin() const;
+    void setSpin(double seconds);
+
+    /** Start running frames on a new thread.  Returns false if frames are
+        already running. */
+    bool start();
+
+    /** Ask the frames to stop, and wait for the thread started by start() to
+        finish. */
+    void stop();
+
+    /** Ask the frames to stop, without waiting.  This may be called from
+        inside a stage. */
+    void requestStop();
+
+    bool running() const { return running_; }
+
+    /** Run `frames` frames on the calling thread - or never stop, if `frames`
+        is 0 - until requestStop() is called.  Returns the number of frames
+        run, which is 0 if frames were already running. */
+    uint64_t run(uint64_t frames);
+
+    /** Return a copy of the statistics so far. */
+    FrameStats stats() const;
+    void resetStats();
+
+  private:
+    using Nanoseconds = std::chrono::nanoseconds;
+
+    bool begin();
+    uint64_t loop(uint64_t frames);
+    bool sleepUntil(Clock::time_point);
+    void runFrame(Clock::time_point deadline, double time);
+
+    FramePipeline pipeline_;
+    std::atomic<int64_t> period_;  // In nanoseconds.
+    std::atomic<int64_t> spin_{0};
+    std::atomic<bool> running_{false};
+
+    mutable std::mutex mutex_;  // Guards everything below.
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::thread thread_;
+    FrameStats stats_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+
+namespace detail {
+
+inline int64_t framePeriod(double fps) {
+    static double const NANOSECONDS = 1e9;
+    return fps > 0 ? std::max(int64_t(std::llround(NANOSECONDS / fps)),
+                              int64_t(1))
+                   : int64_t(NANOSECONDS);
+}
+
+inline uint64_t nanoseconds(FrameScheduler::Clock::duration d) {
+    auto n = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+    return n > 0 ? uint64_t(n) : 0;
+}
+
+} // detail
+
+inline FramePipeline::Stage callbackStage(FrameCallback callback,
+                                          void* context) {
+    return [=](double time) { callback(context, time); };
+}
+
+inline FrameScheduler::FrameScheduler(double fps)
+        : period_(detail::framePeriod(fps)) {
+}
+
+inline FrameScheduler::~FrameScheduler() {
+    stop();
+}
+
+inline void FrameScheduler::setPipeline(FramePipeline pipeline) {
+    if (not running_)
+        pipeline_ = std::move(pipeline);
+}
+
+inline double FrameScheduler::fps() const {
+    return 1e9 / period_;
+}
+
+inline void FrameScheduler::setFps(double fps) {
+    period_ = detail::framePeriod(fps);
+}
+
+inline double FrameScheduler::spin() const {
+    return spin_ / 1e9;
+}
+
+inline void FrameScheduler::setSpin(double seconds) {
+    spin_ = std::max(int64_t(std::llround(seconds * 1e9)), int64_t(0));
+}
+
+inline bool FrameScheduler::begin() {
+    if (running_.exchange(true))
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = false;
+    return true;
+}
+
+inline bool FrameScheduler::start() {
+    if (not begin())
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (thread_.joinable())
+        thread_.join();
+    thread_ = std::thread([this]() { loop(0); });
+    return true;
+}
+
+inline void FrameScheduler::requestStop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    wake_.notify_all();
+}
+
+inline void FrameScheduler::stop() {
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        wake_.notify_all();
+        std::swap(thread, thread_);
+    }
+    if (thread.joinable() and thread.get_id() != std::this_thread::get_id())
+        thread.join();
+    else if (thread.joinable())
+        thread.detach();
+}
+
+inline uint64_t FrameScheduler::run(uint64_t frames) {
+    return begin() ? loop(frames) : 0;
+}
+
+inline FrameStats FrameScheduler::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+inline void FrameScheduler::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_ = {};
+}
+
+/** Sleep until `deadline`, or until asked to stop.  Returns false if asked to
+    stop. */
+inline bool FrameScheduler::sleepUntil(Clock::time_point deadline) {
+    auto wake = deadline - Nanoseconds(spin_.load());
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (wake_.wait_until(lock, wake, [this]() { return stopping_; }))
+            return false;
+    }
+    while (Clock::now() < deadline)
+        ;
+    return true;
+}
+
+inline void FrameScheduler::runFrame(Clock::time_point deadline,
+                                     double time) {
+    auto t0 = Clock::now();
+    if (pipeline_.compute)
+        pipeline_.compute(time);
+    auto t1 = Clock::now();
+    if (pipeline_.render)
+        pipeline_.render(time);
+    auto t2 = Clock::now();
+    if (pipeline_.output)
+        pipeline_.output(time);
+    auto t3 = Clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.lateness.record(detail::nanoseconds(t0 - deadline));
+    stats_.compute.record(detail::nanoseconds(t1 - t0));
+    stats_.render.record(detail::nanoseconds(t2 - t1));
+    stats_.output.record(detail::nanoseconds(t3 - t2));
+    stats_.frame.record(detail::nanoseconds(t3 - t0));
+    ++stats_.frames;
+}
+
+inline uint64_t FrameScheduler::loop(uint64_t frames) {
+    auto const start = Clock::now();
+    auto anchor = start;
+    auto period = Nanoseconds(period_.load());
+    int64_t k = 0;
+    uint64_t count = 0;
+
+    while (not frames or count < frames) {
+        // A new frame rate starts a new grid at the next deadline.
+        auto p = Nanoseconds(period_.load());
+        if (p != period) {
+            anchor += k * period;
+            period = p;
+            k = 0;
+        }
+
+        auto deadline = anchor + k * period;
+        if (not sleepUntil(deadline))
+            break;
+
+        auto time = std::chrono::duration<double>(deadline - start).count();
+        runFrame(deadline, time);
+        ++count;
+
+        // The next frame is due at the latest deadline that has passed, or
+        // the next one if none has.
+        auto now = Clock::now();
+        auto next = k + 1;
+        auto due = int64_t((now - anchor) / period);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (now > anchor + next * period)
+            ++stats_.overruns;
+        if (due > next) {
+            stats_.dropped += uint64_t(due - next);
+            next = due;
+        }
+        k = next;
+    }
+
+    running_ = false;
+    return count;
+}
+
+} // timedata
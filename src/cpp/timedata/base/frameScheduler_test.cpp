@@ -0,0 +1,138 @@
+#pragma once
+
+#include <vector>
+
+#include <timedata/base/frameScheduler.h>
+
+namespace timedata {
+namespace frame_scheduler {
+
+TEST_CASE("latencyHistogram", "[frameScheduler]") {
+    LatencyHistogram h;
+    REQUIRE(h.count() == 0);
+    REQUIRE(h.percentile(50) == 0);
+
+    for (uint64_t i = 1; i <= 1000; ++i)
+        h.record(i * 1000);
+    REQUIRE(h.count() == 1000);
+    REQUIRE(h.min() == 1000);
+    REQUIRE(h.max() == 1000000);
+    REQUIRE(h.mean() == 500500);
+    REQUIRE(h.percentile(0) == 1000);
+    REQUIRE(h.percentile(100) == 1000000);
+
+    // Percentiles are within the width of a bucket.
+    for (double p: {10, 50, 90, 99}) {
+        auto expected = p * 10000;
+        REQUIRE(std::abs(h.percentile(p) - expected) <= expected / 16);
+    }
+
+    LatencyHistogram small;
+    for (uint64_t i = 0; i < 32; ++i)
+        small.record(i);
+    REQUIRE(small.percentile(50) == 15);
+
+    h.add(small);
+    REQUIRE(h.count() == 1032);
+    REQUIRE(h.min() == 0);
+
+    LatencyHistogram huge;
+    huge.record(uint64_t(1) << 60);
+    REQUIRE(huge.percentile(50) == uint64_t(1) << 60);
+
+    h.clear();
+    REQUIRE(h.count() == 0);
+    REQUIRE(h.max() == 0);
+}
+
+TEST_CASE("frameScheduler", "[frameScheduler]") {
+    FrameScheduler scheduler(1000);
+    REQUIRE(scheduler.fps() == 1000);
+
+    std::vector<double> times;
+    std::vector<int> stages;
+    FramePipeline pipeline;
+    pipeline.compute = [&](double time) {
+        times.push_back(time);
+        stages.push_back(0);
+    };
+    pipeline.render = [&](double) { stages.push_back(1); };
+    pipeline.output = [&](double) { stages.push_back(2); };
+    scheduler.setPipeline(pipeline);
+
+    REQUIRE(scheduler.run(20) == 20);
+    REQUIRE(not scheduler.running());
+    REQUIRE(stages.size() == 60);
+    REQUIRE(stages[3] == 0);
+    REQUIRE(stages[4] == 1);
+    REQUIRE(stages[5] == 2);
+
+    // Frame times are on the grid, even if a frame was dropped.
+    REQUIRE(times[0] == 0);
+    for (size_t i = 1; i < times.size(); ++i) {
+        auto frames = (times[i] - times[0]) * 1000;
+        REQUIRE(frames >= i);
+        REQUIRE(std::abs(frames - std::round(frames)) < 1e-6);
+    }
+
+    auto stats = scheduler.stats();
+    REQUIRE(stats.frames == 20);
+    REQUIRE(stats.compute.count() == 20);
+    REQUIRE(stats.render.count() == 20);
+    REQUIRE(stats.output.count() == 20);
+    REQUIRE(stats.frame.count() == 20);
+    REQUIRE(stats.lateness.count() == 20);
+
+    scheduler.resetStats();
+    REQUIRE(scheduler.stats().frames == 0);
+}
+
+TEST_CASE("frameScheduler overruns", "[frameScheduler]") {
+    // Each frame takes three periods.
+    FrameScheduler scheduler(200);
+    FramePipeline pipeline;
+    pipeline.render = [](double) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+    };
+    scheduler.setPipeline(pipeline);
+
+    REQUIRE(scheduler.run(4) == 4);
+    auto stats = scheduler.stats();
+    REQUIRE(stats.overruns == 4);
+    REQUIRE(stats.dropped >= 6);
+    REQUIRE(stats.render.min() >= 15000000);
+}
+
+TEST_CASE("frameScheduler thread", "[frameScheduler]") {
+    FrameScheduler scheduler(500);
+    std::atomic<int> frames(0);
+    FramePipeline pipeline;
+    pipeline.output = [&](double) {
+        if (++frames == 10)
+            scheduler.requestStop();
+    };
+    scheduler.setPipeline(pipeline);
+
+    REQUIRE(scheduler.start());
+    REQUIRE(not scheduler.start());
+    REQUIRE(scheduler.run(1) == 0);
+    while (scheduler.running())
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    REQUIRE(frames == 10);
+
+    // A slow frame rate doesn't hold up stop().
+    scheduler.setFps(0.1);
+    frames = 0;
+    REQUIRE(scheduler.start());
+    auto before = FrameScheduler::Clock::now();
+    while (frames == 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    scheduler.stop();
+    REQUIRE(not scheduler.running());
+    REQUIRE(frames == 1);
+    REQUIRE(FrameScheduler::Clock::now() - before < std::chrono::seconds(5));
+    REQUIRE(scheduler.stats().frames == 11);
+}
+
+} // frame_scheduler
+} // timedata
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cmath>
+
 #include <timedata/base/join_inl.h>
 
 namespace timedata {
@@ -9,6 +11,39 @@ using GammaTable = std::vector<uint8_t>;
 GammaTable makeGammaTable(float gamma, uint8_t min = 0, uint8_t max = 255);
 uint8_t getGamma(GammaTable const&, float x);
 
+/** A CompactGammaTable is a much smaller alternative to a GammaTable, which
+    interpolates between a few hundred fixed-point entries instead of looking
+    up one of thousands of bytes, so many tables fit in the L1 cache at once.
+
+    Entry i holds the exact gamma output at i / segments times 128, in 8.7
+    fixed point, so that entries fit in a signed 16-bit integer.  There is one
+    extra copy of the last entry at the end, so interpolating at exactly 1
+    never reads past the table. */
+using CompactGammaTable = std::vector<uint16_t>;
+
+static size_t const COMPACT_GAMMA_SEGMENTS = 256;
+
+CompactGammaTable makeCompactGammaTable(
+    float gamma, uint8_t min = 0, uint8_t max = 255,
+    size_t segments = COMPACT_GAMMA_SEGMENTS);
+
+/** Interpolate a CompactGammaTable in fixed point, like getGamma. */
+uint8_t getCompactGamma(CompactGammaTable const&, float x);
+
+/** A GammaCurve samples the gamma function at evenly spaced points, without
+    rounding, for outputs that need more precision than a GammaTable gives.
+    Values in between are linearly interpolated. */
+using GammaCurve = std::vector<float>;
+
+static size_t const GAMMA_CURVE_SEGMENTS = 1024;
+
+/** Make a curve from `min` at 0 to `max` at 1. */
+GammaCurve makeGammaCurve(float gamma, float min, float max,
+                          size_t segments = GAMMA_CURVE_SEGMENTS);
+
+/** Interpolate the curve at x, which is clamped to [0, 1]. */
+float getGammaCurve(GammaCurve const&, float x);
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // Implementation details follow.
@@ -43,4 +78,49 @@ inline uint8_t getGamma(GammaTable const& table, float x) {
     return table[std::min(size, table.size() - 1)];
 }
 
+inline CompactGammaTable makeCompactGammaTable(
+        float gamma, uint8_t min, uint8_t max, size_t segments) {
+    // Like makeGammaTable, the output is the floor of min + x^gamma * width,
+    // clipped to max, so a value just under max + 1 is clipped just as well.
+    float width = 1.0f + (max - min);
+    auto top = 128.0f * max + 127.0f;
+
+    CompactGammaTable table;
+    table.reserve(segments + 2);
+    for (size_t i = 0; i <= segments; ++i) {
+        auto ratio = std::pow(float(i) / float(segments), gamma);
+        auto g = 128.0f * (min + ratio * width);
+        table.push_back(static_cast<uint16_t>(std::min(top, g + 0.5f)));
+    }
+    table.push_back(table.back());
+    return table;
+}
+
+inline uint8_t getCompactGamma(CompactGammaTable const& table, float x) {
+    auto segments = table.size() - 2;
+    x = std::min(std::max(x, 0.0f), 1.0f);
+    auto u = static_cast<uint32_t>(x * (256 * segments));
+    auto i = u >> 8, f = u & 0xFF;
+    return static_cast<uint8_t>(
+        (table[i] * (256 - f) + table[i + 1] * f) >> 15);
+}
+
+inline GammaCurve makeGammaCurve(
+        float gamma, float min, float max, size_t segments) {
+    GammaCurve curve;
+    curve.reserve(segments + 1);
+    for (size_t i = 0; i <= segments; ++i) {
+        auto ratio = std::pow(float(i) / float(segments), gamma);
+        curve.push_back(min + ratio * (max - min));
+    }
+    return curve;
+}
+
+inline float getGammaCurve(GammaCurve const& curve, float x) {
+    auto last = curve.size() - 2;
+    x = std::min(std::max(x, 0.0f), 1.0f) * (curve.size() - 1);
+    auto i = std::min(static_cast<size_t>(x), last);
+    return curve[i] + (x - i) * (curve[i + 1] - curve[i]);
+}
+
 }  // namespace timedata
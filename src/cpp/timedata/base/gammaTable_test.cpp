@@ -51,4 +51,64 @@ TEST_CASE("gammaTable LPD") {
     testGamma(2.5f, 2556);
 }
 
+TEST_CASE("gammaCurve") {
+    auto curve = makeGammaCurve(2.5f, 1.0f, 255.0f);
+    REQUIRE(curve.size() == GAMMA_CURVE_SEGMENTS + 1);
+    REQUIRE(getGammaCurve(curve, -1.0f) == 1.0f);
+    REQUIRE(getGammaCurve(curve, 0.0f) == 1.0f);
+    REQUIRE(getGammaCurve(curve, 1.0f) == 255.0f);
+    REQUIRE(getGammaCurve(curve, 2.0f) == 255.0f);
+
+    for (size_t i = 0; i <= 1000; ++i) {
+        auto x = i / 1000.0f;
+        auto exact = 1.0f + 254.0f * std::pow(x, 2.5f);
+        REQUIRE(std::abs(getGammaCurve(curve, x) - exact) < 0.001f);
+    }
+}
+
+TEST_CASE("compactGammaTable") {
+    auto table = makeCompactGammaTable(1.0f);
+    REQUIRE(table.size() == COMPACT_GAMMA_SEGMENTS + 2);
+    REQUIRE(getCompactGamma(table, -1.0f) == 0);
+    REQUIRE(getCompactGamma(table, 2.0f) == 255);
+
+    for (size_t i = 0; i < 256; i++)
+        REQUIRE(i == getCompactGamma(table, i / 255.0f));
+
+    auto limited = makeCompactGammaTable(2.5f, 0x80, 0xFF);
+    REQUIRE(getCompactGamma(limited, 0) == 0x80);
+    REQUIRE(getCompactGamma(limited, 1) == 0xFF);
+    for (size_t i = 0x81; i < 0xFF; i++) {
+        auto scaled = 2.0f * (i - 0x80);
+        auto f = std::pow((scaled + 0.5f) / 256.0f, 1.0f / 2.5f);
+        REQUIRE(i == getCompactGamma(limited, f));
+    }
+}
+
+TEST_CASE("compactGammaTable accuracy") {
+    // Compare both tables against the exact result on a fine grid.
+    static size_t const STEPS = 1 << 16;
+    for (auto gamma: {1.8f, 2.5f, 3.0f}) {
+        for (auto min: {0, 0x80}) {
+            auto full = makeGammaTable(gamma, min);
+            auto compact = makeCompactGammaTable(gamma, min);
+            REQUIRE(2 * compact.size() < full.size());
+
+            size_t fullErrors = 0, compactErrors = 0;
+            for (size_t i = 0; i <= STEPS; ++i) {
+                auto x = float(i) / STEPS;
+                auto raw = min + std::pow(double(x), gamma) * (256 - min);
+                auto exact = static_cast<int>(std::min(255.0, raw));
+                auto c = getCompactGamma(compact, x);
+                REQUIRE(std::abs(c - exact) <= 1);
+                REQUIRE(std::abs(c - getGamma(full, x)) <= 1);
+                fullErrors += getGamma(full, x) != exact;
+                compactErrors += c != exact;
+            }
+            REQUIRE(compactErrors < STEPS / 200);
+            REQUIRE(compactErrors < fullErrors);
+        }
+    }
+}
+
 } // timedata
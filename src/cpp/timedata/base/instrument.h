@@ -0,0 +1,224 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <timedata/base/latencyHistogram.h>
+
+namespace timedata {
+namespace instrument {
+
+/** Counters for one instrumented operation. */
+struct OperationStats {
+    uint64_t calls = 0;
+    uint64_t elements = 0;
+    LatencyHistogram latency;
+
+    void add(OperationStats const&);
+};
+
+/** Return the ID of the operation named `name`, registering it the first
+    time.  Every call with the same name returns the same ID. */
+size_t operationId(char const* name);
+
+/** Record one call to an operation on `elements` elements that took
+    `nanoseconds`, in the calling thread's counters. */
+void record(size_t id, size_t elements, uint64_t nanoseconds);
+
+/** Return the counters for every operation that has been called, summed
+    over all threads, including threads that have exited. */
+std::vector<std::pair<std::string, OperationStats>> snapshot();
+
+/** Clear the counters in every thread. */
+void reset();
+
+/** Times a scope and records it when the scope ends. */
+class Timer {
+  public:
+    Timer(size_t id, size_t elements)
+            : id_(id), elements_(elements), begin_(Clock::now()) {}
+
+    ~Timer() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - begin_).count();
+        record(id_, elements_, uint64_t(ns));
+    }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    size_t const id_, elements_;
+    Clock::time_point const begin_;
+};
+
+/** True if this build of timedata was compiled with TIMEDATA_INSTRUMENT. */
+bool enabled();
+
+} // instrument
+} // timedata
+
+/** TIMEDATA_INSTRUMENT_SCOPE(name, elements) counts and times the rest of the
+    enclosing scope as one call to the operation `name` on `elements` elements.
+
+    It compiles to nothing unless TIMEDATA_INSTRUMENT is defined. */
+#ifdef TIMEDATA_INSTRUMENT
+
+#define TIMEDATA_INSTRUMENT_SCOPE(NAME, ELEMENTS)                            \
+    static size_t const timedataInstrumentId_ =                              \
+        ::timedata::instrument::operationId(NAME);                           \
+    ::timedata::instrument::Timer timedataInstrumentTimer_(                  \
+        timedataInstrumentId_, ELEMENTS)
+
+#else
+
+#define TIMEDATA_INSTRUMENT_SCOPE(NAME, ELEMENTS)
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+
+namespace timedata {
+namespace instrument {
+
+inline void OperationStats::add(OperationStats const& other) {
+    calls += other.calls;
+    elements += other.elements;
+    latency.add(other.latency);
+}
+
+inline bool enabled() {
+#ifdef TIMEDATA_INSTRUMENT
+    return true;
+#else
+    return false;
+#endif
+}
+
+namespace detail {
+
+/** The counters of one thread.  Only that thread writes them, but snapshot()
+    and reset() read and clear them from other threads, so the mutex is
+    almost never contended. */
+struct ThreadStats {
+    std::mutex mutex;
+    std::vector<OperationStats> operations;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::string> names;
+    std::vector<std::shared_ptr<ThreadStats>> threads;
+
+    // The counters of threads that have exited.
+    std::vector<OperationStats> exited;
+};
+
+inline Registry& registry() {
+    // Never destroyed, so that threads exiting during shutdown can still use
+    // it.
+    static auto r = new Registry;
+    return *r;
+}
+
+/** Registers the calling thread's counters, and merges them into the exited
+    counters when the thread exits. */
+class ThreadHandle {
+  public:
+    ThreadHandle() : stats_(std::make_shared<ThreadStats>()) {
+        auto& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.threads.push_back(stats_);
+    }
+
+    ~ThreadHandle() {
+        auto& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        auto& ops = stats_->operations;
+        if (r.exited.size() < ops.size())
+            r.exited.resize(ops.size());
+        for (size_t i = 0; i < ops.size(); ++i)
+            r.exited[i].add(ops[i]);
+
+        for (auto& t: r.threads) {
+            if (t == stats_) {
+                t = r.threads.back();
+                r.threads.pop_back();
+                break;
+            }
+        }
+    }
+
+    ThreadStats& stats() { return *stats_; }
+
+  private:
+    std::shared_ptr<ThreadStats> stats_;
+};
+
+inline ThreadStats& threadStats() {
+    static thread_local ThreadHandle handle;
+    return handle.stats();
+}
+
+} // detail
+
+inline size_t operationId(char const* name) {
+    auto& r = detail::registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (size_t i = 0; i < r.names.size(); ++i) {
+        if (r.names[i] == name)
+            return i;
+    }
+    r.names.push_back(name);
+    return r.names.size() - 1;
+}
+
+inline void record(size_t id, size_t elements, uint64_t nanoseconds) {
+    auto& stats = detail::threadStats();
+    std::lock_guard<std::mutex> lock(stats.mutex);
+    if (stats.operations.size() <= id)
+        stats.operations.resize(id + 1);
+    auto& op = stats.operations[id];
+    ++op.calls;
+    op.elements += elements;
+    op.latency.record(nanoseconds);
+}
+
+inline std::vector<std::pair<std::string, OperationStats>> snapshot() {
+    auto& r = detail::registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto total = r.exited;
+    total.resize(r.names.size());
+    for (auto& thread: r.threads) {
+        std::lock_guard<std::mutex> threadLock(thread->mutex);
+        for (size_t i = 0; i < thread->operations.size(); ++i)
+            total[i].add(thread->operations[i]);
+    }
+
+    std::vector<std::pair<std::string, OperationStats>> result;
+    for (size_t i = 0; i < total.size(); ++i) {
+        if (total[i].calls)
+            result.emplace_back(r.names[i], total[i]);
+    }
+    return result;
+}
+
+inline void reset() {
+    auto& r = detail::registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.exited.clear();
+    for (auto& thread: r.threads) {
+        std::lock_guard<std::mutex> threadLock(thread->mutex);
+        thread->operations.clear();
+    }
+}
+
+} // instrument
+} // timedata
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <thread>
+
+#include <timedata/base/instrument.h>
+#include <timedata/color/cython_list_inl.h>
+
+namespace timedata {
+namespace instrument {
+
+namespace {
+
+OperationStats const* findOperation(
+        std::vector<std::pair<std::string, OperationStats>> const& ops,
+        std::string const& name) {
+    for (auto& op: ops) {
+        if (op.first == name)
+            return &op.second;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TEST_CASE("instrument", "[instrument]") {
+    reset();
+    auto id = operationId("test.instrument");
+    REQUIRE(operationId("test.instrument") == id);
+    REQUIRE(operationId("test.instrument.other") != id);
+    REQUIRE(not findOperation(snapshot(), "test.instrument"));
+
+    record(id, 10, 100);
+    record(id, 20, 300);
+    { Timer timer(id, 5); }
+
+    // Counters from threads that have exited are kept.
+    std::thread([=]() { record(id, 1000, 50); }).join();
+
+    auto op = findOperation(snapshot(), "test.instrument");
+    REQUIRE(op);
+    REQUIRE(op->calls == 4);
+    REQUIRE(op->elements == 1035);
+    REQUIRE(op->latency.count() == 4);
+    REQUIRE(op->latency.min() <= 50);
+    REQUIRE(op->latency.max() >= 300);
+    REQUIRE(not findOperation(snapshot(), "test.instrument.other"));
+
+    reset();
+    REQUIRE(not findOperation(snapshot(), "test.instrument"));
+}
+
+TEST_CASE("instrument operations", "[instrument]") {
+    reset();
+    color_list::CColorListRGB in(100), out;
+    color_list::math_add(in, 1.0f, out);
+    color_list::math_add(in, in, out);
+    color_list::sort(out);
+
+    auto ops = snapshot();
+    auto add = findOperation(ops, "math_add");
+    REQUIRE(enabled() == bool(add));
+    if (add) {
+        REQUIRE(add->calls == 2);
+        REQUIRE(add->elements == 200);
+        REQUIRE(findOperation(ops, "sort")->calls == 1);
+    }
+    reset();
+}
+
+} // instrument
+} // timedata
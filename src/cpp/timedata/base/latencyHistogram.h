@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace timedata {
+
+/** A histogram of durations in nanoseconds, with a fixed number of buckets so
+    that recording never allocates.
+
+    Durations below 32ns get a bucket each.  Above that, each power of two is
+    split into 16 buckets, so any percentile is within about 6% of the true
+    value.  Durations of more than 2^40ns, about eighteen minutes, all go into
+    the last bucket. */
+class LatencyHistogram {
+  public:
+    void record(uint64_t nanoseconds);
+
+    /** Add every duration recorded in another histogram. */
+    void add(LatencyHistogram const&);
+
+    void clear() { *this = {}; }
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? double(sum_) / count_ : 0; }
+
+    /** Return the duration that `percent` percent of the recorded durations
+        are at or below, or 0 if nothing has been recorded.  The 0th and 100th
+        percentiles are exact, and the others are the middle of a bucket,
+        clamped to the range of the recorded durations. */
+    uint64_t percentile(double percent) const;
+
+  private:
+    static size_t const SUB_BUCKET_BITS = 4;
+    static size_t const SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static size_t const LINEAR = 2 * SUB_BUCKETS;
+    static size_t const MAX_BITS = 40;
+    static size_t const BUCKETS =
+            (MAX_BITS - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+    static size_t bucket(uint64_t nanoseconds);
+    static uint64_t bucketBegin(size_t bucket);
+    static uint64_t bucketWidth(size_t bucket);
+
+    std::array<uint64_t, BUCKETS> counts_ = {};
+    uint64_t count_ = 0, sum_ = 0, max_ = 0;
+    uint64_t min_ = std::numeric_limits<uint64_t>::max();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+
+inline size_t LatencyHistogram::bucket(uint64_t nanoseconds) {
+    if (nanoseconds < LINEAR)
+        return size_t(nanoseconds);
+
+    size_t top = 0;
+    for (auto n = nanoseconds; n >>= 1; )
+        ++top;
+
+    // The top SUB_BUCKET_BITS + 1 bits choose the bucket.
+    auto shift = top - SUB_BUCKET_BITS;
+    auto b = shift * SUB_BUCKETS + size_t(nanoseconds >> shift);
+    return std::min(b, BUCKETS - 1);
+}
+
+inline uint64_t LatencyHistogram::bucketBegin(size_t bucket) {
+    if (bucket < LINEAR)
+        return bucket;
+    auto shift = bucket / SUB_BUCKETS - 1;
+    return uint64_t(bucket % SUB_BUCKETS + SUB_BUCKETS) << shift;
+}
+
+inline uint64_t LatencyHistogram::bucketWidth(size_t bucket) {
+    return bucket < LINEAR ? 1 : uint64_t(1) << (bucket / SUB_BUCKETS - 1);
+}
+
+inline void LatencyHistogram::record(uint64_t nanoseconds) {
+    ++counts_[bucket(nanoseconds)];
+    ++count_;
+    sum_ += nanoseconds;
+    min_ = std::min(min_, nanoseconds);
+    max_ = std::max(max_, nanoseconds);
+}
+
+inline void LatencyHistogram::add(LatencyHistogram const& other) {
+    for (size_t i = 0; i < BUCKETS; ++i)
+        counts_[i] += other.counts_[i];
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+inline uint64_t LatencyHistogram::percentile(double percent) const {
+    if (not count_)
+        return 0;
+    if (percent <= 0)
+        return min_;
+    if (percent >= 100)
+        return max_;
+
+    // The rank of the duration we want, counting from 1.
+    auto rank = uint64_t(percent / 100 * count_ + 0.5);
+    rank = std::max(rank, uint64_t(1));
+
+    uint64_t seen = 0;
+    size_t b = 0;
+    for (; b < BUCKETS - 1; ++b) {
+        seen += counts_[b];
+        if (seen >= rank)
+            break;
+    }
+    auto middle = bucketBegin(b) + bucketWidth(b) / 2;
+    return std::max(min_, std::min(max_, middle));
+}
+
+} // timedata
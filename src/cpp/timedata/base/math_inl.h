@@ -2,10 +2,13 @@
 
 #include <ctype.h>
 #include <cmath>
+#include <cstring>
 #include <iomanip>
+#include <limits>
 #include <sstream>
 #include <type_traits>
 
+#include <timedata/base/join_inl.h>
 #include <timedata/base/math.h>
 
 namespace timedata {
@@ -198,7 +201,7 @@ inline float divideByZero(float x) {
         return std::numeric_limits<float>::infinity();
     if (x < 0)
         return -std::numeric_limits<float>::infinity();
-    return std::nanf(nullptr);
+    return std::nanf("");
 }
 
 inline float divPython(float x, float y) {
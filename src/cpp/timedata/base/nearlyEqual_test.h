@@ -0,0 +1,39 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+namespace timedata {
+
+/* Optimized code can round differently from the simple code that a test
+   checks it against.  Planar and packed lists, fused expressions, tiled
+   conversions and the kernels for each instruction set are all free to
+   reorder arithmetic, contract it into FMAs, or - under setup.py's
+   -ffast-math - use approximate reciprocals, so their results can differ in
+   the last few bits.  Tests compare such results with these functions. */
+
+/** True if x and y agree to a relative 1e-5, or to an absolute 1e-5 times
+    `scale` near zero.  Two NaNs are equal. */
+inline bool nearlyEqual(float x, float y, float scale = 1.0f) {
+    if (std::isnan(x) or std::isnan(y))
+        return std::isnan(x) and std::isnan(y);
+    auto size = std::max({scale, std::abs(x), std::abs(y)});
+    return x == y or std::abs(x - y) <= 1e-5f * size;
+}
+
+/** True if two lists of samples have the same size, and each of their numbers
+    is nearlyEqual(). */
+template <typename List>
+bool nearlyEqualLists(List const& x, List const& y) {
+    if (x.size() != y.size())
+        return false;
+    for (size_t i = 0; i < x.size(); ++i) {
+        for (size_t j = 0; j < x[i].size(); ++j) {
+            if (not nearlyEqual(x[i][j], y[i][j]))
+                return false;
+        }
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <memory>
+
+#include <timedata/base/threadPool.h>
+
+namespace timedata {
+
+/** The settings that decide whether loops over lists run in parallel.
+
+    A loop over fewer than parallelThreshold() elements always runs serially
+    on the calling thread.  Longer loops are split into chunks that run on a
+    shared ThreadPool of threadCount() threads. */
+
+/** The number of threads that loops use, including the calling thread.
+    The default is the number of hardware threads. */
+size_t threadCount();
+
+/** Set the number of threads.  0 means the number of hardware threads, and 1
+    means that every loop runs serially. */
+void setThreadCount(size_t);
+
+/** The smallest loop, in elements, that runs in parallel. */
+size_t parallelThreshold();
+void setParallelThreshold(size_t);
+
+/** Call f(begin, end) on consecutive chunks that together cover [0, size), in
+    parallel if `size` is at least parallelThreshold().  Each chunk starts at a
+    multiple of a cache line, if the data starts on one, so threads never write
+    to the same cache line.  `elementSize` is the size in bytes of each
+    element. */
+template <typename Function>
+void forChunks(size_t size, size_t elementSize, Function f);
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const CACHE_LINE_SIZE = 64;
+static size_t const DEFAULT_PARALLEL_THRESHOLD = 1 << 16;
+
+/** Each thread gets about this many chunks, so threads that finish early can
+    take work from slow ones. */
+static size_t const CHUNKS_PER_THREAD = 4;
+
+struct ParallelSettings {
+    std::mutex mutex;
+    std::shared_ptr<ThreadPool> pool;
+    size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::atomic<size_t> threshold{DEFAULT_PARALLEL_THRESHOLD};
+
+    /** The settings are never destroyed, so that a forked child process
+        that exits doesn't destroy a pool it inherited. */
+    static ParallelSettings& instance() {
+        static auto settings = new ParallelSettings;
+        return *settings;
+    }
+
+    /** The pool is created only when it's first needed, and a loop that is
+        running holds on to its pool even if the thread count changes.  A
+        forked child process gets a new pool of its own. */
+    std::shared_ptr<ThreadPool> getPool() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (pool and pool->forked())
+            resetPool();
+        if (not pool)
+            pool = std::make_shared<ThreadPool>(threads);
+        return pool;
+    }
+
+    /** Drop the pool.  A pool inherited across fork() is leaked instead,
+        since it can't be destroyed in the child. */
+    void resetPool() {
+        if (pool and pool->forked())
+            new std::shared_ptr<ThreadPool>(std::move(pool));
+        pool.reset();
+    }
+};
+
+inline size_t threadCount() {
+    auto& s = ParallelSettings::instance();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.threads;
+}
+
+inline void setThreadCount(size_t threads) {
+    if (not threads)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    auto& s = ParallelSettings::instance();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (threads != s.threads) {
+        s.threads = threads;
+        s.resetPool();
+    }
+}
+
+inline size_t parallelThreshold() {
+    return ParallelSettings::instance().threshold;
+}
+
+inline void setParallelThreshold(size_t threshold) {
+    ParallelSettings::instance().threshold = threshold;
+}
+
+inline size_t greatestCommonDivisor(size_t a, size_t b) {
+    return b ? greatestCommonDivisor(b, a % b) : a;
+}
+
+/** Return a chunk size for splitting `size` elements across `threads`
+    threads that is a whole number of cache lines. */
+inline size_t alignedChunk(size_t size, size_t threads, size_t elementSize) {
+    auto chunks = threads * CHUNKS_PER_THREAD;
+    auto chunk = (size + chunks - 1) / chunks;
+
+    // The smallest number of elements that fills a whole number of lines.
+    auto line = CACHE_LINE_SIZE / greatestCommonDivisor(
+        CACHE_LINE_SIZE, std::max(elementSize, size_t(1)));
+    return std::max(line, (chunk + line - 1) / line * line);
+}
+
+template <typename Function>
+void forChunks(size_t size, size_t elementSize, Function f) {
+    if (size < parallelThreshold())
+        return f(size_t(0), size);
+
+    auto pool = ParallelSettings::instance().getPool();
+    auto chunk = alignedChunk(size, pool->size(), elementSize);
+    pool->run(size, chunk, f);
+}
+
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#ifndef WINDOWS
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <timedata/base/parallel.h>
+#include <timedata/color/cython_list_inl.h>
+
+namespace timedata {
+
+namespace {
+
+/** Run with a thread count and threshold, then restore the old ones. */
+template <typename Function>
+void withParallelism(size_t threads, size_t threshold, Function f) {
+    auto oldThreads = threadCount();
+    auto oldThreshold = parallelThreshold();
+    setThreadCount(threads);
+    setParallelThreshold(threshold);
+    f();
+    setThreadCount(oldThreads);
+    setParallelThreshold(oldThreshold);
+}
+
+} // namespace
+
+TEST_CASE("threadPool covers every index once", "[parallel]") {
+    ThreadPool pool(4);
+    REQUIRE(pool.size() == 4);
+
+    for (size_t size: {0, 1, 15, 16, 17, 1000}) {
+        for (size_t chunk: {1, 7, 16, 2000}) {
+            // Catch's REQUIRE can't be called from worker threads.
+            std::vector<std::atomic<int>> counts(size);
+            std::atomic<bool> badChunk(false);
+            pool.run(size, chunk, [&](size_t begin, size_t end) {
+                if (begin >= end or end - begin > chunk)
+                    badChunk = true;
+                for (auto i = begin; i < end; ++i)
+                    ++counts[i];
+            });
+            REQUIRE(not badChunk);
+            for (auto& c: counts)
+                REQUIRE(c == 1);
+        }
+    }
+}
+
+TEST_CASE("threadPool runs nested jobs serially", "[parallel]") {
+    ThreadPool pool(3);
+    std::atomic<size_t> total(0), calls(0);
+    pool.run(100, 10, [&](size_t begin, size_t end) {
+        pool.run(end - begin, 1, [&](size_t b, size_t e) {
+            ++calls;
+            total += e - b;
+        });
+    });
+    REQUIRE(total == 100);
+    REQUIRE(calls == 10);
+}
+
+#ifndef WINDOWS
+
+TEST_CASE("threadPool after fork", "[parallel]") {
+    ThreadPool pool(4);
+    auto cover = [&](size_t size) {
+        std::vector<std::atomic<int>> counts(size);
+        pool.run(size, 10, [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i)
+                ++counts[i];
+        });
+        for (auto& c: counts) {
+            if (c != 1)
+                return false;
+        }
+        return true;
+    };
+    REQUIRE(cover(1000));
+    REQUIRE(not pool.forked());
+
+    auto pid = fork();
+    REQUIRE(pid >= 0);
+    if (not pid) {
+        // The child has none of the workers, so it must not wait for them.
+        alarm(10);
+        auto ok = pool.forked() and cover(1000);
+        withParallelism(4, 0, [&]() {
+            std::atomic<size_t> total(0);
+            forChunks(100000, 4, [&](size_t begin, size_t end) {
+                total += end - begin;
+            });
+            ok = ok and total == 100000;
+        });
+        _exit(ok ? 0 : 1);
+    }
+
+    int status = 0;
+    REQUIRE(waitpid(pid, &status, 0) == pid);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+    REQUIRE(cover(1000));
+}
+
+#endif
+
+TEST_CASE("alignedChunk", "[parallel]") {
+    // Twelve-byte samples fill whole cache lines in groups of sixteen.
+    REQUIRE(alignedChunk(1000, 4, 12) == 64);
+    REQUIRE(alignedChunk(1, 4, 12) == 16);
+    REQUIRE(alignedChunk(1000, 4, 4) == 64);
+    REQUIRE(alignedChunk(1000, 1, 64) == 250);
+    REQUIRE(alignedChunk(100, 1, 100) == 32);
+}
+
+TEST_CASE("parallel list math matches serial", "[parallel]") {
+    using namespace color_list;
+
+    CColorListRGB in(10001), in2(10001);
+    for (size_t i = 0; i < in.size(); ++i) {
+        in[i] = {i / 100.0f, (i % 17) / 16.0f + 0.5f, 3.0f - i / 1000.0f};
+        in2[i] = {0.5f, i / 3000.0f + 0.25f, (i % 5) + 0.5f};
+    }
+
+    auto compute = [&]() {
+        CColorListRGB out;
+        math_mul(in, in2, out);
+        math_pow(out, 1.5f, out);
+        math_abs(out, out);
+        math_invert(out, out);
+
+        Expression<CColorListRGB> e;
+        e.push(Op::add, in2);
+        e.push(Op::div, 2.0f);
+        CColorListRGB out2;
+        REQUIRE(evaluate(e, out, out2));
+        return out2;
+    };
+
+    CColorListRGB serial, parallel;
+    withParallelism(1, 0, [&]() { serial = compute(); });
+    withParallelism(4, 0, [&]() {
+        REQUIRE(threadCount() == 4);
+        REQUIRE(parallelThreshold() == 0);
+        parallel = compute();
+    });
+    REQUIRE(serial == parallel);
+}
+
+} // timedata
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef WINDOWS
+#include <unistd.h>
+#endif
+
+namespace timedata {
+
+/** A small pool of persistent worker threads, used to split one loop over a
+    large range of indices into chunks that run in parallel.
+
+    The thread that calls run() works on chunks too, so a pool of size N has
+    N - 1 worker threads, and a pool of size 1 has none and runs everything
+    serially.
+
+    Only one run() executes on a pool at a time.  A call to run() made while
+    the pool is busy - from another thread, or from inside a job - doesn't
+    wait for the pool, but runs its job serially on the calling thread.
+
+    A process forked from this one gets none of the worker threads, so in the
+    child run() always runs serially, and the pool must never be destroyed
+    there - joining the missing workers would wait forever. */
+class ThreadPool {
+  public:
+    using Job = std::function<void(size_t begin, size_t end)>;
+
+    explicit ThreadPool(size_t size);
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    size_t size() const { return workers_.size() + 1; }
+
+    /** True in a child process forked after the pool was created. */
+    bool forked() const;
+
+    /** Call job(begin, end) on consecutive chunks of `chunk` indices that
+        together cover [0, size), spread across the threads of the pool, and
+        return when every chunk is done. */
+    void run(size_t size, size_t chunk, Job const& job);
+
+  private:
+    void work();
+    void runChunks();
+
+    std::vector<std::thread> workers_;
+#ifndef WINDOWS
+    pid_t const pid_ = getpid();  // The process that owns the workers.
+#endif
+
+    // Set for the whole of each parallel run().  A flag, not a mutex, because
+    // a nested run() on the thread that set it must see it set, not lock it.
+    std::atomic<bool> busy_;
+
+    std::mutex mutex_;  // Guards everything below.
+    std::condition_variable wake_, done_;
+    Job const* job_ = nullptr;
+    size_t size_ = 0, chunk_ = 0;
+    std::atomic<size_t> next_;  // The start of the next unclaimed chunk.
+    size_t running_ = 0;        // Workers still working on this job.
+    size_t generation_ = 0;     // Incremented for each new job.
+    bool stopping_ = false;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+inline ThreadPool::ThreadPool(size_t size) : busy_(false), next_(0) {
+    for (size_t i = 1; i < size; ++i)
+        workers_.emplace_back([this]() { work(); });
+}
+
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& w: workers_)
+        w.join();
+}
+
+inline bool ThreadPool::forked() const {
+#ifdef WINDOWS
+    return false;
+#else
+    return getpid() != pid_;
+#endif
+}
+
+inline void ThreadPool::run(size_t size, size_t chunk, Job const& job) {
+    chunk = std::max(chunk, size_t(1));
+    auto idle = false;
+    if (workers_.empty() or size <= chunk or forked() or
+        not busy_.compare_exchange_strong(idle, true)) {
+        if (size)
+            job(0, size);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &job;
+        size_ = size;
+        chunk_ = chunk;
+        next_ = 0;
+        running_ = workers_.size();
+        ++generation_;
+    }
+    wake_.notify_all();
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return not running_; });
+    job_ = nullptr;
+    busy_ = false;
+}
+
+inline void ThreadPool::runChunks() {
+    size_t begin;
+    while ((begin = next_.fetch_add(chunk_)) < size_)
+        (*job_)(begin, std::min(begin + chunk_, size_));
+}
+
+inline void ThreadPool::work() {
+    size_t generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&]() {
+                return stopping_ or generation != generation_;
+            });
+            if (stopping_)
+                return;
+            generation = generation_;
+        }
+
+        runChunks();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (not --running_)
+            done_.notify_one();
+    }
+}
+
+}
@@ -1,13 +1,15 @@
 #pragma once
 
-#include <cmath>
 #include <utility>
-#include <timedata/base/number.h>
 
 namespace timedata {
 
-// These fast, approximate functions are only good for values between 0 and pi/2.
-// TODO: either junk or test these.
+/** Fast, approximate sine and cosine for any angle in radians.
+
+    The angle is first reduced to [-pi, pi], and then the sine is approximated
+    by a parabola with one correction term, accurate to within 0.0012.  There
+    are no branches or table lookups, so loops over arrays of angles
+    vectorize.  Angles must be less than 2^31 turns in size. */
 
 template <typename Float>
 Float fastSin(Float);
@@ -16,8 +18,10 @@ template <typename Float>
 Float fastCos(Float);
 
 template <typename Float>
-Pair<Float> fastSinCos(Float);
+std::pair<Float, Float> fastSinCos(Float);
 
+/** Return the angle in [-pi, pi] that is a whole number of turns from the
+    given angle. */
 template <typename Float>
 Float restrictAngle(Float);
 
@@ -1,28 +1,59 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
 #include <timedata/base/trig.h>
 
 namespace timedata {
 
-// From http://stackoverflow.com/questions/6091837/
+namespace detail {
+
+template <typename Float>
+Float pi() {
+    return Float(3.14159265358979323846);
+}
+
+/** Return the position of `turns` within its turn, in [-0.5, 0.5]. */
+template <typename Float>
+Float restrictTurns(Float turns) {
+    // Conversions to integers truncate towards zero.  Unlike floor() and
+    // comparisons, they vectorize without SSE 4.1 or -ffast-math.
+    auto x = turns - Float(int32_t(turns));
+    return x - Float(int32_t(x + x));
+}
+
+/** The sine of an angle of x turns, for x in [-0.5, 0.5]. */
+template <typename Float>
+Float fastSinTurns(Float x) {
+    // From http://stackoverflow.com/questions/6091837/
+    auto y = 8 * x - 16 * x * std::abs(x);
+    return Float(0.225) * (y * std::abs(y) - y) + y;
+}
+
+} // detail
+
+template <typename Float>
+Float restrictAngle(Float theta) {
+    auto turn = 2 * detail::pi<Float>();
+    return turn * detail::restrictTurns(theta / turn);
+}
 
 template <typename Float>
 Float fastSin(Float theta) {
-    auto b = 4 / pi<Float>(),
-         c = 4 / (pi<Float>() * pi<Float>()),
-         p = Float(0.225),
-         y = (b  + c * theta) * theta;
-    return p * (y * abs(y) - y) + y;
+    auto turns = theta / (2 * detail::pi<Float>());
+    return detail::fastSinTurns(detail::restrictTurns(turns));
 }
 
 template <typename Float>
 Float fastCos(Float theta) {
-    auto s = fastSin(theta);
-    return sqrt(1 - s * s);
+    auto turns = theta / (2 * detail::pi<Float>()) + Float(0.25);
+    return detail::fastSinTurns(detail::restrictTurns(turns));
 }
 
 template <typename Float>
 std::pair<Float, Float> fastSinCos(Float theta) {
-    auto s = fastSin(theta);
-    return {s, sqrt(1 - s * s)};
+    return {fastSin(theta), fastCos(theta)};
 }
 
 }  // namespace timedata
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cmath>
+
+#include <timedata/base/trig_inl.h>
+
+namespace timedata {
+namespace trig {
+
+TEST_CASE("fastSin", "[trig]") {
+    double worstSin = 0, worstCos = 0;
+    for (auto t = -100.0; t < 100.0; t += 0.001) {
+        auto sc = fastSinCos(float(t));
+        worstSin = std::max(worstSin, std::abs(sc.first - std::sin(t)));
+        worstCos = std::max(worstCos, std::abs(sc.second - std::cos(t)));
+    }
+    REQUIRE(worstSin < 0.0012);
+    REQUIRE(worstCos < 0.0012);
+
+    REQUIRE(fastSin(0.0f) == 0);
+    REQUIRE(std::abs(fastSin(1e6) - std::sin(1e6)) < 0.0012);
+    REQUIRE(std::abs(fastCos(-1e6) - std::cos(-1e6)) < 0.0012);
+}
+
+TEST_CASE("restrictAngle", "[trig]") {
+    auto pi = 3.14159265358979323846;
+    for (auto t: {-20.0, -7.0, -1.0, 0.0, 0.5, 3.0, 4.0, 50.0}) {
+        auto r = restrictAngle(t);
+        REQUIRE(r >= -pi);
+        REQUIRE(r <= pi);
+        auto turns = (t - r) / (2 * pi);
+        REQUIRE(std::abs(turns - std::round(turns)) < 1e-9);
+    }
+}
+
+} // trig
+} // timedata
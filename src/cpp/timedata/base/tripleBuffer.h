@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace timedata {
+
+/** Hands frames from one writer thread to one reader thread without locks,
+    waiting or copying.
+
+    Of the three frames, the writer owns the back frame and the reader owns the
+    front frame, and the third is left in the middle.  publish() swaps the
+    back frame with the middle one, and acquire() swaps the middle frame with
+    the front one if it has been published since the last acquire(), so the
+    reader always gets the latest complete frame and frames the reader was too
+    slow to see are dropped.  Each of these is a single atomic exchange, so
+    neither thread ever waits for the other.
+
+    Only one thread may call back() and publish(), and only one other thread
+    may call acquire() and front(). */
+template <typename Frame>
+class TripleBuffer {
+  public:
+    TripleBuffer() = default;
+    explicit TripleBuffer(Frame const& frame)
+            : frames_{{frame, frame, frame}} {}
+
+    TripleBuffer(TripleBuffer const&) = delete;
+    TripleBuffer& operator=(TripleBuffer const&) = delete;
+
+    /** The frame that the writer is filling. */
+    Frame& back() { return frames_[back_]; }
+
+    /** Make the back frame the latest frame, and get a new back frame. */
+    void publish();
+
+    /** If a frame has been published since the last call, make it the front
+        frame and return true.  Otherwise, return false and keep the same
+        front frame. */
+    bool acquire();
+
+    /** The latest frame that the reader has acquired. */
+    Frame& front() { return frames_[front_]; }
+    Frame const& front() const { return frames_[front_]; }
+
+    /** Call f(frame) on each of the three frames.  This is only safe when
+        neither the writer nor the reader is running. */
+    template <typename Function>
+    void forEach(Function f) {
+        for (auto& frame: frames_)
+            f(frame);
+    }
+
+  private:
+    static uint8_t const INDEX = 3, FRESH = 4;
+    static size_t const CACHE_LINE = 64;
+
+    std::array<Frame, 3> frames_;
+
+    // The writer and the reader each touch only their own index, and the
+    // middle index is shared, so they are padded onto separate cache lines.
+    // alignas() would do this too, but Python doesn't align its objects.
+    uint8_t back_ = 0;
+    char padBack_[CACHE_LINE];
+    uint8_t front_ = 1;
+    char padFront_[CACHE_LINE];
+    std::atomic<uint8_t> middle_{2};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+
+template <typename Frame>
+void TripleBuffer<Frame>::publish() {
+    // Releases the writes to the back frame to the reader's acquire().
+    auto back = uint8_t(back_ | FRESH);
+    back_ = middle_.exchange(back, std::memory_order_acq_rel) & INDEX;
+}
+
+template <typename Frame>
+bool TripleBuffer<Frame>::acquire() {
+    if (not (middle_.load(std::memory_order_relaxed) & FRESH))
+        return false;
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX;
+    return true;
+}
+
+} // timedata
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <thread>
+
+#include <timedata/base/tripleBuffer.h>
+
+namespace timedata {
+
+TEST_CASE("tripleBuffer", "[tripleBuffer]") {
+    TripleBuffer<int> buffer(0);
+    REQUIRE(not buffer.acquire());
+
+    buffer.back() = 1;
+    buffer.publish();
+    buffer.back() = 2;
+    REQUIRE(buffer.acquire());
+    REQUIRE(buffer.front() == 1);
+    REQUIRE(not buffer.acquire());
+    REQUIRE(buffer.front() == 1);
+
+    // Only the latest frame is seen.
+    buffer.publish();
+    buffer.back() = 3;
+    buffer.publish();
+    REQUIRE(buffer.acquire());
+    REQUIRE(buffer.front() == 3);
+    REQUIRE(not buffer.acquire());
+}
+
+TEST_CASE("tripleBuffer threads", "[tripleBuffer]") {
+    // Every number in a frame is the frame's sequence number, so a frame that
+    // was torn by the writer would show up as a mismatch.
+    static size_t const FRAMES = 20000, SIZE = 64;
+    TripleBuffer<std::vector<size_t>> buffer{std::vector<size_t>(SIZE)};
+
+    std::thread writer([&]() {
+        for (size_t i = 1; i <= FRAMES; ++i) {
+            auto& frame = buffer.back();
+            std::fill(frame.begin(), frame.end(), i);
+            buffer.publish();
+        }
+    });
+
+    size_t last = 0, seen = 0;
+    bool ok = true;
+    while (last < FRAMES) {
+        if (not buffer.acquire())
+            continue;
+        auto& frame = buffer.front();
+        ok = ok and frame[0] > last;
+        ok = ok and std::count(frame.begin(), frame.end(), frame[0]) == SIZE;
+        last = frame[0];
+        ++seen;
+    }
+    writer.join();
+    REQUIRE(ok);
+    REQUIRE(seen > 0);
+    REQUIRE(seen <= FRAMES);
+}
+
+} // timedata
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <memory>
+#include <random>
+
+#include <timedata/base/benchmark.h>
+#include <timedata/color/renderer.h>
+#include <timedata/signal/convert_inl.h>
+
+namespace timedata {
+namespace color_list {
+namespace benchmark {
+
+/** The data that a benchmark case works on: two inputs, an output, and a
+    single sample and number for the operations that take one. */
+template <typename List>
+struct Lists {
+    using Sample = typename List::value_type;
+
+    List in, in2, out;
+    Sample sample;
+    NumberType<List> number = 0.5f;
+
+    explicit Lists(size_t size);
+
+    /** The bytes read and written by an operation that reads `reads` lists
+        and writes one. */
+    size_t bytes(size_t reads) const {
+        return (reads + 1) * in.size() * sizeof(Sample);
+    }
+};
+
+template <typename List>
+Lists<List>::Lists(size_t size) {
+    // Fill RGB lists in the visible range and convert them, so every model
+    // gets values that are in its own range.
+    std::mt19937 generator(size);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+
+    CColorListRGB rgb(size), rgb2(size);
+    for (auto i = 0; i < 2; ++i) {
+        for (auto& c: i ? rgb2 : rgb) {
+            for (auto& x: c)
+                x = dist(generator);
+        }
+    }
+
+    converter::convertList(rgb, in);
+    converter::convertList(rgb2, in2);
+    out = in;
+    sample = in2.empty() ? Sample() : in2[0];
+}
+
+/** Register a case named <prefix>/<name> whose run calls f(lists). */
+template <typename List, typename Function>
+void addCase(std::vector<BenchmarkCase>& cases, std::string const& prefix,
+             std::string const& name, size_t reads, Function f) {
+    cases.push_back({prefix + "/" + name, [=](size_t size) {
+        auto lists = std::make_shared<Lists<List>>(size);
+        BenchmarkRun run;
+        run.run = [=]() { f(*lists); };
+        run.bytes = lists->bytes(reads);
+        return run;
+    }});
+}
+
+/** The math_ functions that take an operand, with a list, a sample and a
+    number as the operand. */
+#define TIMEDATA_BENCHMARK_MATH2(NAME)                                       \
+    addCase<List>(cases, prefix, #NAME "/list", 2, [](Lists<List>& l) {      \
+        math_##NAME(l.in, l.in2, l.out);                                     \
+    });                                                                      \
+    addCase<List>(cases, prefix, #NAME "/sample", 1, [](Lists<List>& l) {    \
+        math_##NAME(l.in, l.sample, l.out);                                  \
+    });                                                                      \
+    addCase<List>(cases, prefix, #NAME "/number", 1, [](Lists<List>& l) {    \
+        math_##NAME(l.in, l.number, l.out);                                  \
+    })
+
+#define TIMEDATA_BENCHMARK_MATH1(NAME)                                       \
+    addCase<List>(cases, prefix, #NAME, 1, [](Lists<List>& l) {              \
+        math_##NAME(l.in, l.out);                                            \
+    })
+
+template <typename List>
+void addListCases(std::vector<BenchmarkCase>& cases,
+                  std::string const& prefix) {
+    TIMEDATA_BENCHMARK_MATH1(abs);
+    TIMEDATA_BENCHMARK_MATH1(ceil);
+    TIMEDATA_BENCHMARK_MATH1(floor);
+    TIMEDATA_BENCHMARK_MATH1(invert);
+    TIMEDATA_BENCHMARK_MATH1(neg);
+    TIMEDATA_BENCHMARK_MATH1(reverse);
+    TIMEDATA_BENCHMARK_MATH1(trunc);
+
+    TIMEDATA_BENCHMARK_MATH2(add);
+    TIMEDATA_BENCHMARK_MATH2(div);
+    TIMEDATA_BENCHMARK_MATH2(max_limit);
+    TIMEDATA_BENCHMARK_MATH2(min_limit);
+    TIMEDATA_BENCHMARK_MATH2(mul);
+    TIMEDATA_BENCHMARK_MATH2(pow);
+    TIMEDATA_BENCHMARK_MATH2(rdiv);
+    TIMEDATA_BENCHMARK_MATH2(rpow);
+    TIMEDATA_BENCHMARK_MATH2(rsub);
+    TIMEDATA_BENCHMARK_MATH2(sub);
+
+    // math_zero writes without reading.
+    addCase<List>(cases, prefix, "zero", 0, [](Lists<List>& l) {
+        math_zero(l.out);
+    });
+
+    // Equal lists, so that compare reads all of both.
+    addCase<List>(cases, prefix, "compare", 1, [](Lists<List>& l) {
+        keepValue(compare(l.in, l.out));
+    });
+    addCase<List>(cases, prefix, "distance", 1, [](Lists<List>& l) {
+        keepValue(distance(l.in, l.in2));
+    });
+    addCase<List>(cases, prefix, "rotate", 1, [](Lists<List>& l) {
+        rotate(l.in, l.out, int(l.in.size() / 3));
+    });
+    addCase<List>(cases, prefix, "sort", 1, [](Lists<List>& l) {
+        sort(l.in, l.out, false);
+    });
+    addCase<List>(cases, prefix, "sliceInto", 1, [](Lists<List>& l) {
+        sliceInto(l.in, l.out, 0, int(l.in.size()), 1);
+    });
+    addCase<List>(cases, prefix, "sliceOut", 1, [](Lists<List>& l) {
+        keepValue(sliceOut(l.in, 0, int(l.in.size()), 1));
+    });
+    addCase<List>(cases, prefix, "spreadAppend", 0, [](Lists<List>& l) {
+        auto size = l.in.size();
+        l.out.resize(1);
+        spreadAppend(l.sample, size - 1, l.out);
+    });
+}
+
+#undef TIMEDATA_BENCHMARK_MATH1
+#undef TIMEDATA_BENCHMARK_MATH2
+
+template <typename ListIn, typename ListOut>
+void addConvertCase(std::vector<BenchmarkCase>& cases,
+                    std::string const& name) {
+    addCase<ListIn>(cases, "convert", name, 1, [](Lists<ListIn>& l) {
+        static ListOut out;
+        converter::convertList(l.in, out);
+    });
+}
+
+inline void addRenderCase(std::vector<BenchmarkCase>& cases) {
+    cases.push_back({"render/RGB", [](size_t size) {
+        auto lists = std::make_shared<Lists<CColorListRGB>>(size);
+        auto renderer = std::make_shared<CRenderer>(Render3());
+        auto out = std::make_shared<std::vector<char>>(
+            renderer->bytesPerColor() * size);
+
+        BenchmarkRun run;
+        run.run = [=]() { renderer->render(1, lists->in, out->data()); };
+        run.bytes = size * (sizeof(color::CColorRGB) +
+                            renderer->bytesPerColor());
+        return run;
+    }});
+}
+
+/** Every case for the native benchmark, named <list>/<operation>. */
+inline std::vector<BenchmarkCase> listCases() {
+    std::vector<BenchmarkCase> cases;
+    addListCases<CColorListRGB>(cases, "RGB");
+    addListCases<CColorListHSV>(cases, "HSV");
+    addListCases<CColorListRGB255>(cases, "RGB255");
+
+    addConvertCase<CColorListRGB, CColorListHSV>(cases, "RGB-HSV");
+    addConvertCase<CColorListHSV, CColorListRGB>(cases, "HSV-RGB");
+    addConvertCase<CColorListRGB, CColorListRGB255>(cases, "RGB-RGB255");
+    addConvertCase<CColorListRGB255, CColorListRGB>(cases, "RGB255-RGB");
+
+    addRenderCase(cases);
+    return cases;
+}
+
+} // benchmark
+} // color_list
+} // timedata
@@ -4,10 +4,13 @@
 #include <type_traits>
 
 #include <timedata/base/enum.h>
+#include <timedata/base/instrument.h>
 #include <timedata/base/make.h>
 #include <timedata/base/math_inl.h>
 #include <timedata/color/cython_inl.h>
+#include <timedata/color/expression.h>
 #include <timedata/color/for.h>
+#include <timedata/color/planar_inl.h>
 #include <timedata/color/spread.h>
 #include <timedata/signal/slice.h>
 
@@ -24,6 +27,24 @@ using CColorListYUV = color::CColorYUV::List;
 using CColorListRGB255 = color::CColorRGB255::List;
 using CColorListRGB256 = color::CColorRGB256::List;
 
+using CPlanarRGB = Planar<color::CColorRGB>;
+
+using CColorListRGBExpression = Expression<CColorListRGB>;
+using CColorListHSVExpression = Expression<CColorListHSV>;
+using CColorListHSLExpression = Expression<CColorListHSL>;
+using CColorListXYZExpression = Expression<CColorListXYZ>;
+using CColorListYIQExpression = Expression<CColorListYIQ>;
+using CColorListYUVExpression = Expression<CColorListYUV>;
+
+using CColorListRGB255Expression = Expression<CColorListRGB255>;
+using CColorListRGB256Expression = Expression<CColorListRGB256>;
+
+// Python's buffer protocol exports lists as packed arrays of numbers.
+static_assert(sizeof(color::CColorRGB) == 3 * sizeof(float),
+              "Samples must be packed for the Python buffer protocol");
+static_assert(sizeof(color::CColorRGB256) == 3 * sizeof(float),
+              "Samples must be packed for the Python buffer protocol");
+
 template <typename ColorList>
 std::string toString(ColorList const& colors) {
     std::string result = "(";
@@ -98,22 +119,26 @@ void erase(int key, ColorVector& v) {
 
 template <typename ColorVector>
 void sliceDelete(ColorVector& colors, int begin, int end, int step) {
-    auto b = static_cast<size_t>(begin);
-    if (step < 0) {
-        std::swap(begin, end);
-        step = -step;
-    }
+    // Delete the same indices as Python's range(begin, end, step), lowest
+    // first.
+    if (not step)
+        return;
+    auto span = step > 0 ? end - begin : begin - end;
+    auto stride = std::abs(step);
+    size_t count = span > 0 ? (span + stride - 1) / stride : 0;
+    if (not count)
+        return;
+
+    auto first = step > 0 ? begin : begin + int(count - 1) * step;
+    auto b = static_cast<size_t>(first);
     size_t offset = 0;
-    for (size_t i = 0; i < colors.size(); ++i) {
-        if (i == b) {
-            b += step;
+    for (size_t i = b; i < colors.size(); ++i) {
+        if (offset < count and i == b + offset * size_t(stride))
             offset += 1;
-        } else if (offset) {
+        else
             colors[i - offset] = colors[i];
-        }
     }
-    if (offset)
-        colors.resize(colors.size() - offset);
+    colors.resize(colors.size() - offset);
 }
 
 template <typename ColorList>
@@ -123,9 +148,9 @@ ValueType<ColorList> min_cpp(ColorList const& cl) {
 
     Color result;
     result.fill(std::numeric_limits<value_type>::infinity());
-    for (auto& c: cl) {
-        for (size_t i = 0; i < c.size(); ++i)
-            result[i] = std::min(result[i], c[i]);
+    if (not cl.empty()) {
+        channelExtremes<Color::SIZE>(mathIsa(), &*cl[0][0], cl.size(),
+                                     &*result[0], false);
     }
     return result;
 }
@@ -137,9 +162,9 @@ ValueType<ColorList> max_cpp(ColorList const& cl) {
 
     Color result;
     result.fill(-std::numeric_limits<value_type>::infinity());
-    for (auto& c: cl) {
-        for (size_t i = 0; i < c.size(); ++i)
-            result[i] = std::max(result[i], c[i]);
+    if (not cl.empty()) {
+        channelExtremes<Color::SIZE>(mathIsa(), &*cl[0][0], cl.size(),
+                                     &*result[0], true);
     }
     return result;
 }
@@ -226,8 +251,10 @@ void rotate(ColorList& out, int pos) {
 
 template <typename ColorList>
 void rotate(ColorList const& in, ColorList& out, int pos) {
+    if (in.empty())
+        return;
     resizeIf(in, out);
-    pos = pos % in.size();
+    pos = pos % static_cast<int>(in.size());
     if (pos < 0)
         pos += in.size();
     std::rotate_copy(in.begin(), in.begin() + pos, in.end(), out.begin());
@@ -247,11 +274,13 @@ void round_cpp(ColorList& in, ColorList& out, size_t digits) {
 
 template <typename ColorList>
 void sort(ColorList& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("sort", out.size());
     std::sort(out.begin(), out.end());
 }
 
 template <typename ColorList>
 void sort(ColorList const& i, ColorList& o, bool reversed) {
+    TIMEDATA_INSTRUMENT_SCOPE("sort", i.size());
     resizeIf(i, o);
     if (not reversed)
         std::partial_sort_copy(i.begin(), i.end(), o.begin(), o.end());
@@ -266,50 +295,53 @@ void spreadAppend(ValueType<ColorList> const& end, size_t size,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-template <typename T>
-using Transform = typename std::add_pointer<T(T)>::type;
 
 template <typename ColorList, typename Function>
 void applyEach(ColorList& out, Function f) {
-    for (auto& i: out)
-        for (auto& j: i)
-            j = f(j);
-}
-
-template <typename ColorList>
-void forParts1F(ColorList const& in, ColorList& out,
-                Transform<NumberType<ColorList>> f) {
-    forParts1(in, out, f);
+    forChunks(out.size(), sizeof(out[0]), [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i)
+            for (auto& j: out[i])
+                j = f(j);
+    });
 }
 
 template <typename ColorList>
 void math_abs(ColorList const& in, ColorList& out) {
-    forParts1F(in, out, std::abs);
+    TIMEDATA_INSTRUMENT_SCOPE("math_abs", in.size());
+    using Number = NumberType<ColorList>;
+    forParts1(in, out, [](Number x) { return std::abs(x); });
 }
 
 template <typename ColorList>
 void math_floor(ColorList const& in, ColorList& out) {
-    forParts1F(in, out, std::floor);
+    TIMEDATA_INSTRUMENT_SCOPE("math_floor", in.size());
+    using Number = NumberType<ColorList>;
+    forParts1(in, out, [](Number x) { return std::floor(x); });
 }
 
 template <typename ColorList>
 void math_ceil(ColorList const& in, ColorList& out) {
-    forParts1F(in, out, std::ceil);
+    TIMEDATA_INSTRUMENT_SCOPE("math_ceil", in.size());
+    using Number = NumberType<ColorList>;
+    forParts1(in, out, [](Number x) { return std::ceil(x); });
 }
 
 template <typename ColorList>
 void math_invert(ColorList const& in, ColorList& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("math_invert", in.size());
     using Ranged = typename ColorList::ranged_type;
     forParts1(in, out, [](Ranged c) { return c.invert(); });
 }
 
 template <typename ColorList>
 void math_neg(ColorList const& in, ColorList& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("math_neg", in.size());
     forParts1(in, out, [](NumberType<ColorList> c) { return -c; });
 }
 
 template <typename ColorList>
 void math_reverse(ColorList const& in, ColorList& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("math_reverse", in.size());
     resizeIf(in, out);
     if (&out == &in)
         std::reverse(out.begin(), out.end());
@@ -319,18 +351,22 @@ void math_reverse(ColorList const& in, ColorList& out) {
 
 template <typename ColorList>
 void math_trunc(ColorList const& in, ColorList& out) {
-    forParts1F(in, out, std::trunc);
+    TIMEDATA_INSTRUMENT_SCOPE("math_trunc", in.size());
+    using Number = NumberType<ColorList>;
+    forParts1(in, out, [](Number x) { return std::trunc(x); });
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 template <typename ColorList>
 void math_clear(ColorList& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("math_clear", out.size());
     out.clear();
 }
 
 template <typename ColorList>
 void math_zero(ColorList& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("math_zero", out.size());
     std::fill(out.begin(), out.end(), ValueType<ColorList>{});
 }
 
@@ -338,86 +374,89 @@ void math_zero(ColorList& out) {
 
 template <typename Input, typename ColorList>
 void math_add(ColorList const& in, Input const& in2, ColorList& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("math_add", in.size());
     using Number = RangedType<ColorList>;
      forParts2(in, in2, out, [](Number x, Number y) { return x + y; });
 }
 
 template <typename Input, typename ColorList>
 void math_div(ColorList const& in, Input const& in2, ColorList& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("math_div", in.size());
     using Number = NumberType<ColorList>;
     forParts2(in, in2, out, [](Number x, Number y) { return divPython(y, x); });
 }
 
 template <typename Input, typename ColorList>
 void math_rdiv(ColorList const& in, Input const& in2, ColorList& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("math_rdiv", in.size());
     using Number = NumberType<ColorList>;
     forParts2(in, in2, out, [](Number x, Number y) { return divPython(x, y); });
 }
 
 template <typename Input, typename ColorList>
 void math_mul(ColorList const& in, Input const& in2, ColorList& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("math_mul", in.size());
     using Number = NumberType<ColorList>;
     forParts2(in, in2, out, [](Number x, Number y) { return x * y; });
 }
 
 template <typename Input, typename ColorList>
 void math_pow(ColorList const& in, Input const& in2, ColorList& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("math_pow", in.size());
     using Number = NumberType<ColorList>;
     forParts2(in, in2, out, [](Number x, Number y) { return powPython(y, x); });
 }
 
 template <typename Input, typename ColorList>
 void math_rpow(ColorList const& in, Input const& in2, ColorList& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("math_rpow", in.size());
     using Number = NumberType<ColorList>;
     forParts2(in, in2, out, [](Number x, Number y) { return powPython(x, y); });
 }
 
 template <typename Input, typename ColorList>
 void math_sub(ColorList const& in, Input const& in2, ColorList& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("math_sub", in.size());
     using Number = NumberType<ColorList>;
     forParts2(in, in2, out, [](Number x, Number y) { return x - y; });
 }
 
 template <typename Input, typename ColorList>
 void math_rsub(ColorList const& in, Input const& in2, ColorList& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("math_rsub", in.size());
     using Number = NumberType<ColorList>;
     forParts2(in, in2, out, [](Number x, Number y) { return y - x; });
 }
 
 template <typename Input, typename ColorList>
 void math_min_limit(ColorList const& in, Input const& in2, ColorList& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("math_min_limit", in.size());
     using Number = NumberType<ColorList>;
     forParts2(in, in2, out, [](Number x, Number y) { return std::max(x, y); });
 }
 
 template <typename Input, typename ColorList>
 void math_max_limit(ColorList const& in, Input const& in2, ColorList& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("math_max_limit", in.size());
     using Number = NumberType<ColorList>;
     forParts2(in, in2, out, [](Number x, Number y) { return std::min(x, y); });
 }
 
 template <typename ColorList>
 NumberType<ColorList> distance2(ColorList const& x, ColorList const& y) {
-    NumberType<ColorList> result = 0.0f;
     auto xShorter = x.size() < y.size();
     auto& shorter = xShorter ? x : y;
     auto& longer = xShorter ? y : x;
-
-    size_t i = 0;
-    for (; i < shorter.size(); ++i) {
-        for (size_t j = 0; j < longer[i].size(); ++j) {
-            auto d = longer[i][j] - shorter[i][j];
-            result += d * d;
-        }
-    }
-
-    for (; i < longer.size(); ++i) {
-        for (size_t j = 0; j < longer[i].size(); ++j) {
-            result += longer[i][j] * longer[i][j];
-        }
-    }
-
-    return result;
+    if (longer.empty())
+        return 0.0f;
+
+    auto isa = mathIsa();
+    auto size = ValueType<ColorList>::SIZE;
+    auto l = &*longer[0][0];
+    auto s = shorter.empty() ? l : &*shorter[0][0];
+    auto common = shorter.size() * size;
+    return sumSquares(isa, l, s, common) +
+           sumSquares(isa, l + common, nullptr, longer.size() * size - common);
 }
 
 template <typename ColorList>
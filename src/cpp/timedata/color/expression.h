@@ -0,0 +1,205 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <timedata/base/math_inl.h>
+#include <timedata/color/for.h>
+
+namespace timedata {
+namespace color_list {
+
+/** The operations that an Expression can record.  Each one computes exactly
+    what the math_ function of the same name in cython_list_inl.h does. */
+enum class Op {
+    add, div, mul, pow, sub, rdiv, rpow, rsub, max_limit, min_limit,
+    abs, ceil, floor, invert, neg, trunc
+};
+
+/** An Expression records a chain of elementwise operations on a list of
+    samples, to be evaluated later in a single pass.
+
+    Running a chain like `cl.mul(a).add(b).pow(g)` one operation at a time
+    sweeps the whole list through the cache once per operation.  evaluate()
+    instead runs the whole chain over one small tile of samples at a time, so
+    each sample is read from memory and written back exactly once. */
+template <typename ColorList>
+struct Expression {
+    using Number = NumberType<ColorList>;
+    using Sample = ValueType<ColorList>;
+
+    /** One recorded operation.  A list operand is held by pointer, so it must
+        outlive the Expression.  A number operand is stored as a Sample with
+        every component set to that number. */
+    struct Step {
+        Op op;
+        Sample sample;
+        ColorList const* list;
+    };
+
+    std::vector<Step> steps;
+
+    void push(Op op) { steps.push_back({op, {}, nullptr}); }
+    void push(Op op, Number x) {
+        Sample s;
+        s.fill(x);
+        push(op, s);
+    }
+    void push(Op op, Sample const& s) { steps.push_back({op, s, nullptr}); }
+    void push(Op op, ColorList const& cl) { steps.push_back({op, {}, &cl}); }
+
+    size_t size() const { return steps.size(); }
+    void clear() { steps.clear(); }
+};
+
+/** Evaluate an Expression on `in` and write the result into `out`, which may be
+    `in` itself or any list operand of the expression.
+
+    Like the math_ functions, this grows `out` if it's shorter than `in`.
+    Returns false and does nothing if a list operand is shorter than `in`. */
+template <typename ColorList>
+bool evaluate(Expression<ColorList> const&, ColorList const& in,
+              ColorList& out);
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+/** The number of samples in each tile: small enough that a tile and the
+    matching tiles of its list operands stay in the L1 cache. */
+static size_t const EXPRESSION_TILE = 256;
+
+template <typename Sample, typename Getter, typename Function>
+void applyTile(Sample* tile, size_t count, Getter get, Function f) {
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < Sample::SIZE; ++j)
+            tile[i][j] = f(get(i, j), tile[i][j]);
+    }
+}
+
+/* The lambdas here take their arguments in the same order as the ones passed
+   to forParts2 in cython_list_inl.h: the operand first, then the sample. */
+template <typename Sample, typename Getter>
+void applyBinary(Op op, Sample* tile, size_t count, Getter get) {
+    using T = NumberType<Sample>;
+
+    switch (op) {
+      case Op::add:
+        return applyTile(tile, count, get, [](T x, T y) { return x + y; });
+      case Op::div:
+        return applyTile(tile, count, get,
+                         [](T x, T y) { return divPython(y, x); });
+      case Op::mul:
+        return applyTile(tile, count, get, [](T x, T y) { return x * y; });
+      case Op::pow:
+        return applyTile(tile, count, get,
+                         [](T x, T y) { return powPython(y, x); });
+      case Op::sub:
+        return applyTile(tile, count, get, [](T x, T y) { return x - y; });
+      case Op::rdiv:
+        return applyTile(tile, count, get,
+                         [](T x, T y) { return divPython(x, y); });
+      case Op::rpow:
+        return applyTile(tile, count, get,
+                         [](T x, T y) { return powPython(x, y); });
+      case Op::rsub:
+        return applyTile(tile, count, get, [](T x, T y) { return y - x; });
+      case Op::max_limit:
+        return applyTile(tile, count, get,
+                         [](T x, T y) { return std::min(x, y); });
+      case Op::min_limit:
+        return applyTile(tile, count, get,
+                         [](T x, T y) { return std::max(x, y); });
+      default:
+        return;
+    }
+}
+
+template <typename Sample>
+void applyUnary(Op op, Sample* tile, size_t count) {
+    using T = NumberType<Sample>;
+    using Ranged = typename Sample::value_type;
+
+    auto get = [](size_t, size_t) { return T(); };
+    switch (op) {
+      case Op::abs:
+        return applyTile(tile, count, get, [](T, T y) { return std::abs(y); });
+      case Op::ceil:
+        return applyTile(tile, count, get, [](T, T y) { return std::ceil(y); });
+      case Op::floor:
+        return applyTile(tile, count, get,
+                         [](T, T y) { return std::floor(y); });
+      case Op::invert:
+        return applyTile(tile, count, get,
+                         [](T, T y) { return *Ranged(y).invert(); });
+      case Op::neg:
+        return applyTile(tile, count, get, [](T, T y) { return -y; });
+      case Op::trunc:
+        return applyTile(tile, count, get,
+                         [](T, T y) { return std::trunc(y); });
+      default:
+        return;
+    }
+}
+
+template <typename ColorList>
+bool evaluate(Expression<ColorList> const& e, ColorList const& in,
+              ColorList& out) {
+    using Sample = ValueType<ColorList>;
+    using Tile = std::array<Sample, EXPRESSION_TILE>;
+
+    for (auto& step: e.steps) {
+        if (step.list and step.list->size() < in.size())
+            return false;
+    }
+    if (out.size() < in.size())
+        out.resize(in.size());
+
+    // Number and sample operands are repeated to fill a whole tile, so that
+    // every binary step runs the same simple loop, which vectorizes.
+    std::vector<Tile> patterns;
+    for (auto& step: e.steps) {
+        if (not step.list and step.op < Op::abs) {
+            patterns.emplace_back();
+            patterns.back().fill(step.sample);
+        }
+    }
+
+    // Each tile is written to `out` only after every step has read its
+    // operands, so `out` can safely alias `in` or any operand.
+    auto evaluateTile = [&](Tile& tile, size_t begin, size_t end) {
+        auto count = end - begin;
+        std::copy(in.begin() + begin, in.begin() + end, tile.begin());
+
+        auto pattern = patterns.begin();
+        for (auto& step: e.steps) {
+            if (step.list) {
+                auto operand = step.list->data() + begin;
+                applyBinary(step.op, tile.data(), count,
+                            [=](size_t i, size_t j) { return operand[i][j]; });
+            } else if (step.op < Op::abs) {
+                auto operand = (pattern++)->data();
+                applyBinary(step.op, tile.data(), count,
+                            [=](size_t i, size_t j) { return operand[i][j]; });
+            } else {
+                applyUnary(step.op, tile.data(), count);
+            }
+        }
+
+        std::copy(tile.begin(), tile.begin() + count, out.begin() + begin);
+    };
+
+    forChunks(in.size(), sizeof(Sample), [&](size_t begin, size_t end) {
+        Tile tile;
+        forTiles(begin, end, EXPRESSION_TILE, [&](size_t b, size_t e) {
+            evaluateTile(tile, b, e);
+        });
+    });
+    return true;
+}
+
+} // color_list
+} // timedata
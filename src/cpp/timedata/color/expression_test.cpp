@@ -0,0 +1,159 @@
+#pragma once
+
+#include <timedata/base/nearlyEqual_test.h>
+#include <timedata/color/cython_list_inl.h>
+
+namespace timedata {
+namespace color_list {
+
+namespace {
+
+/* With a fractional offset, these lists have no zero components, so division
+   never produces infinities, which Sample::operator== can't compare. */
+
+// Bigger than one tile, and not a multiple of the tile size.
+size_t const EXPRESSION_TEST_SIZE = 2 * EXPRESSION_TILE + 37;
+
+CColorListRGB expressionList(float offset) {
+    CColorListRGB result(EXPRESSION_TEST_SIZE);
+    for (size_t i = 0; i < result.size(); ++i) {
+        auto x = offset + i;
+        result[i] = {x / 100.0f - 1.0f, std::fmod(x, 5.0f) / 4.0f,
+                     (i % 3) - 1.5f};
+    }
+    return result;
+}
+
+using MathFunction = void (*)(CColorListRGB const&, CColorListRGB const&,
+                              CColorListRGB&);
+
+CColorListRGB filled(size_t size, color::CColorRGB const& sample) {
+    return CColorListRGB(size, sample);
+}
+
+/** Check one operation against the math_ function that computes it, with
+    each kind of operand. */
+void testBinary(Op op, MathFunction math) {
+    auto in = expressionList(0.25f), operand = expressionList(3.5f);
+    color::CColorRGB sample{0.5f, -2.0f, 3.0f}, number{2.0f, 2.0f, 2.0f};
+
+    CColorListRGB expected, actual;
+    Expression<CColorListRGB> e;
+
+    e.push(op, operand);
+    math(in, operand, expected);
+    REQUIRE(evaluate(e, in, actual));
+    REQUIRE(nearlyEqualLists(actual, expected));
+
+    e.clear();
+    e.push(op, sample);
+    math(in, filled(in.size(), sample), expected);
+    REQUIRE(evaluate(e, in, actual));
+    REQUIRE(nearlyEqualLists(actual, expected));
+
+    e.clear();
+    e.push(op, 2.0f);
+    math(in, filled(in.size(), number), expected);
+    REQUIRE(evaluate(e, in, actual));
+    REQUIRE(nearlyEqualLists(actual, expected));
+}
+
+} // namespace
+
+TEST_CASE("expression binary", "[expression]") {
+    using L = CColorListRGB;
+    testBinary(Op::add, math_add<L, L>);
+    testBinary(Op::div, math_div<L, L>);
+    testBinary(Op::mul, math_mul<L, L>);
+    testBinary(Op::pow, math_pow<L, L>);
+    testBinary(Op::sub, math_sub<L, L>);
+    testBinary(Op::rdiv, math_rdiv<L, L>);
+    testBinary(Op::rpow, math_rpow<L, L>);
+    testBinary(Op::rsub, math_rsub<L, L>);
+    testBinary(Op::max_limit, math_max_limit<L, L>);
+    testBinary(Op::min_limit, math_min_limit<L, L>);
+}
+
+TEST_CASE("expression unary", "[expression]") {
+    using L = CColorListRGB;
+    auto in = expressionList(0.25f);
+    L expected, actual;
+    Expression<L> e;
+
+    auto test = [&](Op op, void (*math)(L const&, L&)) {
+        e.clear();
+        e.push(op);
+        math(in, expected);
+        REQUIRE(evaluate(e, in, actual));
+        REQUIRE(actual == expected);
+    };
+
+    test(Op::abs, math_abs<L>);
+    test(Op::ceil, math_ceil<L>);
+    test(Op::floor, math_floor<L>);
+    test(Op::invert, math_invert<L>);
+    test(Op::neg, math_neg<L>);
+    test(Op::trunc, math_trunc<L>);
+}
+
+TEST_CASE("expression chain", "[expression]") {
+    auto in = expressionList(0.25f), a = expressionList(1.5f),
+        b = expressionList(2.5f);
+
+    auto expected = in;
+    math_mul(expected, a, expected);
+    math_add(expected, b, expected);
+    math_abs(expected, expected);
+    math_pow(expected, 2.5f, expected);
+    math_min_limit(expected, 0.0f, expected);
+    math_max_limit(expected, 1.0f, expected);
+
+    Expression<CColorListRGB> e;
+    e.push(Op::mul, a);
+    e.push(Op::add, b);
+    e.push(Op::abs);
+    e.push(Op::pow, 2.5f);
+    e.push(Op::min_limit, 0.0f);
+    e.push(Op::max_limit, 1.0f);
+    REQUIRE(e.size() == 6);
+
+    CColorListRGB out;
+    REQUIRE(evaluate(e, in, out));
+    REQUIRE(out == expected);
+
+    // The output can be the input, or one of the operands.
+    auto inPlace = in;
+    REQUIRE(evaluate(e, inPlace, inPlace));
+    REQUIRE(inPlace == expected);
+
+    auto a2 = a;
+    Expression<CColorListRGB> e2;
+    e2.push(Op::mul, a2);
+    e2.push(Op::add, b);
+    e2.push(Op::abs);
+    e2.push(Op::pow, 2.5f);
+    e2.push(Op::min_limit, 0.0f);
+    e2.push(Op::max_limit, 1.0f);
+    REQUIRE(evaluate(e2, in, a2));
+    REQUIRE(a2 == expected);
+}
+
+TEST_CASE("expression sizes", "[expression]") {
+    Expression<CColorListRGB> e;
+    CColorListRGB empty, out;
+    REQUIRE(evaluate(e, empty, out));
+    REQUIRE(out.empty());
+
+    auto in = expressionList(0.25f);
+    REQUIRE(evaluate(e, in, out));
+    REQUIRE(out == in);
+
+    CColorListRGB shorter(in.size() - 1);
+    e.push(Op::add, shorter);
+    out.clear();
+    REQUIRE(not evaluate(e, in, out));
+    REQUIRE(out.empty());
+}
+
+} // color_list
+} // timedata
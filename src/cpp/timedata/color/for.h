@@ -1,16 +1,34 @@
  #pragma once
 
+#include <algorithm>
+
+#include <timedata/base/parallel.h>
+#include <timedata/color/mathKernels.h>
+#include <timedata/signal/planar.h>
+
 namespace timedata {
 namespace color_list {
 
+/* These loops run in parallel on large lists - see forChunks() in
+   base/parallel.h - so the functions passed to them must be safe to call
+   from several threads at once.
+
+   Each chunk goes to a kernel in mathKernels.h, compiled for the widest
+   instruction set that the CPU has.  The samples in a list are packed, so a
+   chunk is one contiguous run of numbers. */
+
 template <typename ColorList, typename Function>
 void forParts1(ColorList const& in, ColorList& out, Function f) {
     if (out.size() < in.size())
         out.resize(in.size());
-    for (size_t i = 0; i < in.size(); ++i) {
-        for (size_t j = 0; j < in[i].size(); ++j)
-            out[i][j] = f(in[i][j]);
-    }
+    auto isa = mathIsa();
+    auto size = ValueType<ColorList>::SIZE;
+    forChunks(in.size(), sizeof(in[0]), [&](size_t begin, size_t end) {
+        if (begin < end) {
+            mapNumbers(isa, &in[begin][0], &out[begin][0],
+                       (end - begin) * size, f);
+        }
+    });
 }
 
 template <typename ColorList, typename Function>
@@ -18,32 +36,46 @@ void forParts1(ColorList& out, Function f) {
     forParts1(out, out, f);
 }
 
-template <typename ColorList, typename Function, typename Getter>
-void forParts2Imp(ColorList const& in, ColorList& out, Function f, Getter get) {
-    for (size_t i = 0; i < in.size(); ++i) {
-        for (size_t j = 0; j < in[i].size(); ++j)
-            out[i][j] = f(get(i, j), in[i][j]);
-    }
-}
-
+/** If `in2` is shorter than `in`, f is only applied to the samples that have
+    an operand, and the rest of `in` is copied to `out` unchanged. */
 template <typename ColorList, typename Function>
 void forParts2(ColorList const& in, ColorList const& in2,
                ColorList& out, Function f) {
+    auto common = std::min(in.size(), in2.size());
     if (out.size() < in.size())
         out.resize(in.size());
-    forParts2Imp(in, out, f, [&](size_t i, size_t j) { return in2[i][j]; });
+    if (&in != &out)
+        std::copy(in.begin() + common, in.end(), out.begin() + common);
+
+    auto isa = mathIsa();
+    auto size = ValueType<ColorList>::SIZE;
+    forChunks(common, sizeof(in[0]), [&](size_t begin, size_t end) {
+        if (begin < end) {
+            mapNumbers(isa, &in[begin][0], &in2[begin][0], &out[begin][0],
+                       (end - begin) * size, f);
+        }
+    });
 }
 
 template <typename ColorList, typename Function>
 void forParts2(ColorList const& in, ValueType<ColorList> const& in2,
                ColorList& out, Function f) {
-    forParts2Imp(in, out, f, [&](size_t, size_t j) { return in2[j]; });
+    if (out.size() < in.size())
+        out.resize(in.size());
+    auto isa = mathIsa();
+    forChunks(in.size(), sizeof(in[0]), [&](size_t begin, size_t end) {
+        if (begin < end) {
+            mapSamples<ValueType<ColorList>::SIZE>(
+                isa, &in[begin][0], &in2[0], &out[begin][0], end - begin, f);
+        }
+    });
 }
 
 template <typename ColorList, typename Function>
 void forParts2(ColorList const& in, NumberType<ColorList> const& in2,
                ColorList& out, Function f) {
-    forParts2Imp(in, out, f, [&](size_t, size_t) { return in2; });
+    using Ranged = RangedType<ColorList>;
+    forParts1(in, out, [=](Ranged x) { return f(in2, x); });
 }
 
 template <typename Input, typename ColorList, typename Function>
@@ -51,12 +83,101 @@ void forParts2(Input in2, ColorList& out, Function f) {
     forParts2(out, in2, out, f);
 }
 
+/* Overloads for Planar lists, where each loop is over one contiguous plane of
+   numbers. */
+
+/** Call f(j, begin, end) for each plane j of a Planar list of `size` samples,
+    and each chunk [begin, end) that forChunks() splits the planes into. */
+template <typename Sample, typename Function>
+void forPlaneChunks(size_t size, Function f) {
+    forChunks(size, sizeof(NumberType<Sample>), [&](size_t begin, size_t end) {
+        for (size_t j = 0; j < Sample::SIZE; ++j)
+            f(j, begin, end);
+    });
+}
+
+template <typename Sample, typename Function>
+void forParts1(Planar<Sample> const& in, Planar<Sample>& out, Function f) {
+    if (out.size() < in.size())
+        out.resize(in.size());
+    forPlaneChunks<Sample>(in.size(), [&](size_t j, size_t b, size_t e) {
+        auto i = in.planes[j].data();
+        auto o = out.planes[j].data();
+        for (size_t k = b; k < e; ++k)
+            o[k] = f(i[k]);
+    });
+}
+
+/** Like forParts2 for packed lists, f is only applied to the samples that have
+    an operand in `in2`. */
+template <typename Sample, typename Function>
+void forParts2(Planar<Sample> const& in, Planar<Sample> const& in2,
+               Planar<Sample>& out, Function f) {
+    auto common = std::min(in.size(), in2.size());
+    if (out.size() < in.size())
+        out.resize(in.size());
+    if (&in != &out) {
+        for (size_t j = 0; j < Sample::SIZE; ++j) {
+            auto& plane = in.planes[j];
+            std::copy(plane.begin() + common, plane.end(),
+                      out.planes[j].begin() + common);
+        }
+    }
+
+    forPlaneChunks<Sample>(common, [&](size_t j, size_t b, size_t e) {
+        auto i = in.planes[j].data();
+        auto i2 = in2.planes[j].data();
+        auto o = out.planes[j].data();
+        for (size_t k = b; k < e; ++k)
+            o[k] = f(i2[k], i[k]);
+    });
+}
+
+template <typename Sample, typename Function>
+void forParts2(Planar<Sample> const& in,
+               ValueType<Planar<Sample>> const& in2,
+               Planar<Sample>& out, Function f) {
+    if (out.size() < in.size())
+        out.resize(in.size());
+    forPlaneChunks<Sample>(in.size(), [&](size_t j, size_t b, size_t e) {
+        auto i = in.planes[j].data();
+        auto o = out.planes[j].data();
+        auto x = in2[j];
+        for (size_t k = b; k < e; ++k)
+            o[k] = f(x, i[k]);
+    });
+}
+
+template <typename Sample, typename Function>
+void forParts2(Planar<Sample> const& in,
+               NumberType<Planar<Sample>> const& in2,
+               Planar<Sample>& out, Function f) {
+    if (out.size() < in.size())
+        out.resize(in.size());
+    forPlaneChunks<Sample>(in.size(), [&](size_t j, size_t b, size_t e) {
+        auto i = in.planes[j].data();
+        auto o = out.planes[j].data();
+        for (size_t k = b; k < e; ++k)
+            o[k] = f(in2, i[k]);
+    });
+}
+
+/** Call f(b, e) for consecutive tiles of at most `tile` indices which
+    together cover [begin, end). */
+template <typename Function>
+void forTiles(size_t begin, size_t end, size_t tile, Function f) {
+    for (; begin < end; begin += tile)
+        f(begin, std::min(begin + tile, end));
+}
+
 // Hopefully obsolete.
 template <typename ColorList, typename Func>
 void forEach(ColorList const& in, ColorList& out, Func f) {
-    for (size_t i = 0; i < out.size(); ++i)
-        for (size_t j = 0; j < out[i].size(); ++j)
-            f(in[i][j], out[i][j]);
+    forChunks(out.size(), sizeof(out[0]), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            for (size_t j = 0; j < out[i].size(); ++j)
+                f(in[i][j], out[i][j]);
+    });
 }
 
 template <typename ColorList, typename Func>
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <timedata/base/tripleBuffer.h>
+#include <timedata/color/renderer.h>
+
+namespace timedata {
+namespace color_list {
+
+/** One frame in a CFrameExchange: the rendered bytes, and the colors they
+    were rendered from. */
+struct RenderedFrame {
+    std::vector<char> bytes;
+    size_t size = 0;  // The number of bytes that were written.
+    CColorListRGB colors;
+
+    // Frames are numbered from 1 as they are published, so the reader can see
+    // how many frames it missed.  0 means "never published".
+    uint64_t sequence = 0;
+};
+
+/** Hands rendered frames from a compute thread to an output thread, using a
+    TripleBuffer of preallocated frames.
+
+    The compute thread renders straight into the back frame with render(),
+    which publishes it, and the output thread calls acquire() and then reads
+    front(), so neither thread ever waits or copies a frame. */
+class CFrameExchange {
+  public:
+    CFrameExchange() = default;
+
+    /** Allocate every frame for up to `frameSize` bytes and `colorCount`
+        colors.  This is the only call that allocates, and it must not be made
+        while the writer or the reader is running. */
+    void resize(size_t frameSize, size_t colorCount);
+
+    size_t frameSize() const { return frameSize_; }
+    size_t colorCount() const { return colorCount_; }
+
+    /** Writer: render `colors` into the back frame, keep a copy of the colors,
+        and publish it.  Returns false and publishes nothing if the frame is
+        too small for the colors. */
+    bool render(CRenderer&, float level, CColorListRGB const& colors);
+
+    /** Writer: copy `size` bytes into the back frame and publish it.  Returns
+        false and publishes nothing if `size` is more than frameSize(). */
+    bool publish(char const* data, size_t size);
+
+    /** Writer: the frame being filled, for a writer that fills it directly.
+        Its bytes and colors must not be resized. */
+    RenderedFrame& back() { return frames_.back(); }
+
+    /** Writer: publish the back frame. */
+    void publish();
+
+    /** Reader: make the latest frame the front frame, and return true if it
+        is newer than the previous front frame. */
+    bool acquire() { return frames_.acquire(); }
+
+    /** Reader: the latest acquired frame. */
+    RenderedFrame const& front() const { return frames_.front(); }
+
+  private:
+    TripleBuffer<RenderedFrame> frames_;
+    size_t frameSize_ = 0, colorCount_ = 0;
+    uint64_t sequence_ = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+
+inline void CFrameExchange::resize(size_t frameSize, size_t colorCount) {
+    frameSize_ = frameSize;
+    colorCount_ = colorCount;
+    frames_.forEach([&](RenderedFrame& frame) {
+        frame.bytes.assign(frameSize, 0);
+        frame.size = 0;
+        frame.colors.clear();
+        frame.colors.reserve(colorCount);
+    });
+}
+
+inline void CFrameExchange::publish() {
+    back().sequence = ++sequence_;
+    frames_.publish();
+}
+
+inline bool CFrameExchange::render(CRenderer& renderer, float level,
+                                   CColorListRGB const& colors) {
+    if (colors.size() > colorCount_ or
+        colors.size() * renderer.bytesPerColor() > frameSize_) {
+        return false;
+    }
+
+    // The colors fit in the capacity reserved by resize(), so nothing is
+    // allocated.
+    auto& frame = back();
+    frame.colors.assign(colors.begin(), colors.end());
+    frame.size = colors.size() * renderer.bytesPerColor();
+    renderer.render(level, colors, frame.bytes.data());
+    publish();
+    return true;
+}
+
+inline bool CFrameExchange::publish(char const* data, size_t size) {
+    auto& frame = back();
+    if (size > frame.bytes.size())
+        return false;
+    if (size)
+        std::memcpy(frame.bytes.data(), data, size);
+    frame.size = size;
+    frame.colors.clear();
+    publish();
+    return true;
+}
+
+}
+}
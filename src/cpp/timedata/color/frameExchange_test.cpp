@@ -0,0 +1,55 @@
+#pragma once
+
+#include <timedata/color/frameExchange.h>
+
+namespace timedata {
+namespace color_list {
+
+namespace {
+
+CColorListRGB grays(size_t size) {
+    CColorListRGB colors(size);
+    for (size_t i = 0; i < size; ++i)
+        colors[i] = {i / 10.0f, i / 10.0f, i / 10.0f};
+    return colors;
+}
+
+} // namespace
+
+TEST_CASE("frameExchange", "[frameExchange]") {
+    CFrameExchange exchange;
+    exchange.resize(30, 10);
+    REQUIRE(exchange.frameSize() == 30);
+    REQUIRE(not exchange.acquire());
+    REQUIRE(exchange.front().sequence == 0);
+
+    CRenderer renderer{Render3()};
+    auto colors = grays(10);
+    REQUIRE(exchange.render(renderer, 1.0f, colors));
+    REQUIRE(exchange.acquire());
+
+    auto& frame = exchange.front();
+    REQUIRE(frame.sequence == 1);
+    REQUIRE(frame.colors == colors);
+    REQUIRE(frame.size == 30);
+    std::vector<char> expected(30);
+    renderer.render(1.0f, colors, expected.data());
+    REQUIRE(frame.bytes == expected);
+
+    // Too many colors.
+    REQUIRE(not exchange.render(renderer, 1.0f, grays(11)));
+    REQUIRE(not exchange.acquire());
+
+    char const data[] = "hello";
+    REQUIRE(exchange.publish(data, 5));
+    std::vector<char> tooBig(31);
+    REQUIRE(not exchange.publish(tooBig.data(), tooBig.size()));
+    REQUIRE(exchange.acquire());
+    REQUIRE(exchange.front().sequence == 2);
+    REQUIRE(exchange.front().size == 5);
+    REQUIRE(std::string(exchange.front().bytes.data(), 5) == "hello");
+    REQUIRE(exchange.front().colors.empty());
+}
+
+} // color_list
+} // timedata
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+
+#include <timedata/base/cpu.h>
+
+namespace timedata {
+namespace color_list {
+
+/** The instruction set used by the list arithmetic, which starts as the best
+    one that this CPU supports. */
+Isa mathIsa();
+
+/** Select the instruction set for the list arithmetic.  If the CPU doesn't
+    support `isa`, the best one that it does support is used instead. */
+void setMathIsa(Isa isa);
+
+/** out[i] = f(in[i]) for n numbers. */
+template <typename T, typename Function>
+void mapNumbers(Isa, T const* in, T* out, size_t n, Function f);
+
+/** out[i] = f(in2[i], in[i]) for n numbers. */
+template <typename T, typename Function>
+void mapNumbers(Isa, T const* in, T const* in2, T* out, size_t n, Function f);
+
+/** out[k * SIZE + j] = f(sample[j], in[k * SIZE + j]) for n samples of SIZE
+    numbers each. */
+template <size_t SIZE, typename T, typename Function>
+void mapSamples(Isa, T const* in, T const* sample, T* out, size_t n,
+                Function f);
+
+/** Return the sum of (x[i] - y[i])^2 for n numbers, or of x[i]^2 if y is
+    null. */
+float sumSquares(Isa, float const* x, float const* y, size_t n);
+
+/** Fill `result` with the least (or if `isMax` is true, the greatest) value
+    of each of the SIZE channels of n samples.  `result` must start as
+    infinity (or minus infinity). */
+template <size_t SIZE>
+void channelExtremes(Isa, float const* in, size_t n, float* result,
+                     bool isMax);
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+
+/* Each kernel is compiled once for the baseline - which is SSE2 on x86-64 - and
+   then again for AVX2 and AVX-512 with target attributes, so one build runs
+   the widest vectors the CPU has.  The functions passed in are inlined into
+   each version.
+
+   The reductions keep MATH_LANES separate partial results, combined in the
+   same order at the end, so every version adds up the same terms in the same
+   order.  Results can still differ in their last bits between versions: the
+   compiler may fuse a multiply and an add into one FMA instruction for
+   targets that have it, and -ffast-math lets it reassociate sums and divide
+   with approximate reciprocals. */
+
+static size_t const MATH_LANES = 16;
+
+inline std::atomic<Isa>& mathIsaSetting() {
+    static std::atomic<Isa> isa{bestIsa()};
+    return isa;
+}
+
+inline Isa mathIsa() {
+    return mathIsaSetting().load(std::memory_order_relaxed);
+}
+
+inline void setMathIsa(Isa isa) {
+    mathIsaSetting() = supportedIsa(isa);
+}
+
+#define TIMEDATA_MATH_KERNELS(SUFFIX, TARGET)                                 \
+                                                                              \
+template <typename T, typename Function>                                      \
+TARGET void mapNumbers##SUFFIX(T const* in, T* out, size_t n, Function f) {   \
+    for (size_t i = 0; i < n; ++i)                                            \
+        out[i] = f(in[i]);                                                    \
+}                                                                             \
+                                                                              \
+template <typename T, typename Function>                                      \
+TARGET void mapNumbers##SUFFIX(T const* in, T const* in2, T* out, size_t n,   \
+                               Function f) {                                  \
+    for (size_t i = 0; i < n; ++i)                                            \
+        out[i] = f(in2[i], in[i]);                                            \
+}                                                                             \
+                                                                              \
+template <size_t SIZE, typename T, typename Function>                         \
+TARGET void mapSamples##SUFFIX(T const* in, T const* sample, T* out,          \
+                               size_t n, Function f) {                        \
+    for (size_t k = 0; k < n; ++k, in += SIZE, out += SIZE) {                 \
+        for (size_t j = 0; j < SIZE; ++j)                                     \
+            out[j] = f(sample[j], in[j]);                                     \
+    }                                                                         \
+}                                                                             \
+                                                                              \
+TARGET inline float sumSquares##SUFFIX(float const* x, float const* y,        \
+                                       size_t n) {                            \
+    float lanes[MATH_LANES] = {};                                             \
+    size_t i = 0;                                                             \
+    if (y) {                                                                  \
+        for (; i + MATH_LANES <= n; i += MATH_LANES) {                        \
+            for (size_t k = 0; k < MATH_LANES; ++k) {                         \
+                auto d = x[i + k] - y[i + k];                                 \
+                lanes[k] += d * d;                                            \
+            }                                                                 \
+        }                                                                     \
+    } else {                                                                  \
+        for (; i + MATH_LANES <= n; i += MATH_LANES) {                        \
+            for (size_t k = 0; k < MATH_LANES; ++k)                           \
+                lanes[k] += x[i + k] * x[i + k];                              \
+        }                                                                     \
+    }                                                                         \
+                                                                              \
+    float result = 0;                                                         \
+    for (auto s: lanes)                                                       \
+        result += s;                                                          \
+    for (; i < n; ++i) {                                                      \
+        auto d = x[i] - (y ? y[i] : 0.0f);                                    \
+        result += d * d;                                                      \
+    }                                                                         \
+    return result;                                                            \
+}                                                                             \
+                                                                              \
+template <size_t SIZE>                                                        \
+TARGET void channelExtremes##SUFFIX(float const* in, size_t n,                \
+                                    float* result, bool isMax) {              \
+    /* Blocks of MATH_LANES samples, so each lane keeps to one channel. */    \
+    static size_t const BLOCK = SIZE * MATH_LANES;                            \
+    float lanes[BLOCK];                                                       \
+    for (size_t k = 0; k < BLOCK; ++k)                                        \
+        lanes[k] = result[k % SIZE];                                          \
+                                                                              \
+    size_t i = 0, end = n * SIZE;                                             \
+    if (isMax) {                                                              \
+        for (; i + BLOCK <= end; i += BLOCK) {                                \
+            for (size_t k = 0; k < BLOCK; ++k)                                \
+                lanes[k] = lanes[k] < in[i + k] ? in[i + k] : lanes[k];       \
+        }                                                                     \
+    } else {                                                                  \
+        for (; i + BLOCK <= end; i += BLOCK) {                                \
+            for (size_t k = 0; k < BLOCK; ++k)                                \
+                lanes[k] = in[i + k] < lanes[k] ? in[i + k] : lanes[k];       \
+        }                                                                     \
+    }                                                                         \
+                                                                              \
+    for (size_t k = 0; k < BLOCK; ++k) {                                      \
+        auto& r = result[k % SIZE];                                           \
+        r = isMax ? (r < lanes[k] ? lanes[k] : r)                             \
+                  : (lanes[k] < r ? lanes[k] : r);                            \
+    }                                                                         \
+    for (; i < end; ++i) {                                                    \
+        auto& r = result[i % SIZE];                                           \
+        r = isMax ? (r < in[i] ? in[i] : r) : (in[i] < r ? in[i] : r);        \
+    }                                                                         \
+}
+
+TIMEDATA_MATH_KERNELS(Baseline, )
+
+#if TIMEDATA_X86_DISPATCH
+TIMEDATA_MATH_KERNELS(Avx2, __attribute__((target("avx2"))))
+TIMEDATA_MATH_KERNELS(Avx512, __attribute__((target("avx512f"))))
+#endif
+
+#undef TIMEDATA_MATH_KERNELS
+
+/** Call the version of a kernel for an Isa, with ARGS being any template
+    arguments.  SSE2 is the x86-64 baseline, so scalar and sse2 both get the
+    baseline version. */
+#if TIMEDATA_X86_DISPATCH
+#define TIMEDATA_MATH_DISPATCH(ISA, KERNEL, ARGS, ...)                        \
+    switch (ISA) {                                                            \
+        case Isa::avx512:                                                     \
+            return KERNEL##Avx512 ARGS(__VA_ARGS__);                          \
+        case Isa::avx2:                                                       \
+            return KERNEL##Avx2 ARGS(__VA_ARGS__);                            \
+        default:                                                              \
+            return KERNEL##Baseline ARGS(__VA_ARGS__);                        \
+    }
+#else
+#define TIMEDATA_MATH_DISPATCH(ISA, KERNEL, ARGS, ...)                        \
+    (void) ISA;                                                               \
+    return KERNEL##Baseline ARGS(__VA_ARGS__);
+#endif
+
+template <typename T, typename Function>
+void mapNumbers(Isa isa, T const* in, T* out, size_t n, Function f) {
+    TIMEDATA_MATH_DISPATCH(isa, mapNumbers, , in, out, n, f)
+}
+
+template <typename T, typename Function>
+void mapNumbers(Isa isa, T const* in, T const* in2, T* out, size_t n,
+                Function f) {
+    TIMEDATA_MATH_DISPATCH(isa, mapNumbers, , in, in2, out, n, f)
+}
+
+template <size_t SIZE, typename T, typename Function>
+void mapSamples(Isa isa, T const* in, T const* sample, T* out, size_t n,
+                Function f) {
+    TIMEDATA_MATH_DISPATCH(isa, mapSamples, <SIZE>, in, sample, out, n, f)
+}
+
+inline float sumSquares(Isa isa, float const* x, float const* y, size_t n) {
+    TIMEDATA_MATH_DISPATCH(isa, sumSquares, , x, y, n)
+}
+
+template <size_t SIZE>
+void channelExtremes(Isa isa, float const* in, size_t n, float* result,
+                     bool isMax) {
+    TIMEDATA_MATH_DISPATCH(isa, channelExtremes, <SIZE>, in, n, result, isMax)
+}
+
+#undef TIMEDATA_MATH_DISPATCH
+
+}
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <timedata/base/nearlyEqual_test.h>
+#include <timedata/color/cython_list_inl.h>
+#include <timedata/color/mathKernels.h>
+#include <timedata/color/renderer_test.cpp>
+
+namespace timedata {
+namespace color_list {
+namespace math_kernels_test {
+
+struct Results {
+    std::vector<CColorListRGB> lists;
+    std::vector<float> numbers;
+
+    bool operator==(Results const& r) const {
+        if (lists.size() != r.lists.size() or
+            numbers.size() != r.numbers.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < lists.size(); ++i) {
+            if (not nearlyEqualLists(lists[i], r.lists[i]))
+                return false;
+        }
+        for (size_t i = 0; i < numbers.size(); ++i) {
+            if (not nearlyEqual(numbers[i], r.numbers[i]))
+                return false;
+        }
+        return true;
+    }
+};
+
+Results compute(Isa isa, size_t size) {
+    setMathIsa(isa);
+    auto x = randomColors(size), y = randomColors(size + 3);
+    y.resize(size);
+    auto s = randomColors(1)[0];
+
+    Results r;
+    auto add = [&](CColorListRGB const& cl) { r.lists.push_back(cl); };
+    CColorListRGB out;
+
+    math_add(x, y, out);
+    add(out);
+    math_sub(x, s, out);
+    add(out);
+    math_mul(x, 0.75f, out);
+    add(out);
+    math_div(x, y, out);
+    add(out);
+    math_max_limit(x, s, out);
+    add(out);
+    math_abs(x, out);
+    add(out);
+    math_floor(x, out);
+    add(out);
+    math_neg(x, out);
+    add(out);
+
+    out = x;
+    math_rsub(out, 0.5f, out);
+    add(out);
+
+    add({min_cpp(x)});
+    add({max_cpp(x)});
+    r.numbers = {distance2(x, y), distance2(x, randomColors(size / 2)),
+                 distance2(randomColors(size * 2 + 1), x)};
+    return r;
+}
+
+float naiveDistance2(CColorListRGB const& x, CColorListRGB const& y) {
+    float result = 0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        for (size_t j = 0; j < x[i].size(); ++j) {
+            auto d = x[i][j] - y[i][j];
+            result += d * d;
+        }
+    }
+    return result;
+}
+
+TEST_CASE("mathKernels isa", "[mathKernels]") {
+    setMathIsa(Isa::scalar);
+    REQUIRE(mathIsa() == Isa::scalar);
+    setMathIsa(Isa::last);
+    REQUIRE(mathIsa() == bestIsa());
+}
+
+TEST_CASE("mathKernels match scalar", "[mathKernels]") {
+    for (size_t size: {0, 1, 2, 5, 15, 16, 17, 33, 100, 1000, 20000}) {
+        auto expected = compute(Isa::scalar, size);
+        timedata::forEach<Isa>([&](Isa isa) {
+            REQUIRE(compute(isa, size) == expected);
+        });
+    }
+    setMathIsa(bestIsa());
+}
+
+TEST_CASE("mathKernels values", "[mathKernels]") {
+    auto x = randomColors(1001), y = randomColors(1002);
+    y.resize(x.size());
+    auto d = distance2(x, y);
+    REQUIRE(nearlyEqual(d, naiveDistance2(x, y)));
+
+    CColorListRGB out;
+    math_add(x, y, out);
+    for (size_t i = 0; i < x.size(); ++i) {
+        for (size_t j = 0; j < 3; ++j)
+            REQUIRE(out[i][j] == x[i][j] + y[i][j]);
+    }
+
+    auto least = min_cpp(x), most = max_cpp(x);
+    for (size_t j = 0; j < 3; ++j) {
+        auto l = x[0][j], m = x[0][j];
+        for (auto& c: x) {
+            l = std::min(l, c[j]);
+            m = std::max(m, c[j]);
+        }
+        REQUIRE(least[j] == l);
+        REQUIRE(most[j] == m);
+    }
+}
+
+TEST_CASE("mathKernels with a shorter operand", "[mathKernels]") {
+    // Only the samples with an operand change.
+    auto x = randomColors(100), y = randomColors(40);
+    CColorListRGB out;
+    math_add(x, y, out);
+    REQUIRE(out.size() == x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            auto expected = i < y.size() ? x[i][j] + y[i][j] : x[i][j];
+            REQUIRE(out[i][j] == expected);
+        }
+    }
+
+    math_add(x, y, x);
+    REQUIRE(x == out);
+}
+
+} // math_kernels_test
+} // color_list
+} // timedata
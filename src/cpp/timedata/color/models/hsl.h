@@ -25,7 +25,8 @@ inline void convertSample(ColorHSV const& in, ColorHSL& out) {
 
     out[HSL::hue] = hue;
     out[HSL::lightness] = lightness;
-    out[HSL::saturation] = value * saturation / divisor;
+    // Black and white have no saturation, rather than NaN.
+    out[HSL::saturation] = value * saturation / (divisor + (divisor == 0));
 }
 
 template <>
@@ -37,10 +38,34 @@ inline void convertSample(ColorHSL const& in, ColorHSV& out) {
     auto value = (2 * lightness +
                   saturation * (1 - std::abs(2 * lightness - 1))) / 2;
     out[HSV::hue] = hue;
-    out[HSV::saturation] = 2 * (value - lightness) / value;
+    // Black has no saturation, rather than NaN.
+    out[HSV::saturation] = 2 * (value - lightness) / (value + (value == 0));
     out[HSV::value] = value;
 }
 
+template <>
+inline void convertPlanes<HSV, HSL>(ConvertTile& tile, size_t n) {
+    auto saturation = tile.planes[1], value = tile.planes[2];
+    for (size_t i = 0; i < n; ++i) {
+        auto s = saturation[i], v = value[i];
+        auto lightness = v * (2 - s) / 2;
+        auto divisor = 1 - std::abs(2 * lightness - 1);
+        saturation[i] = v * s / (divisor + (divisor == 0));
+        value[i] = lightness;
+    }
+}
+
+template <>
+inline void convertPlanes<HSL, HSV>(ConvertTile& tile, size_t n) {
+    auto saturation = tile.planes[1], lightness = tile.planes[2];
+    for (size_t i = 0; i < n; ++i) {
+        auto s = saturation[i], l = lightness[i];
+        auto value = (2 * l + s * (1 - std::abs(2 * l - 1))) / 2;
+        saturation[i] = 2 * (value - l) / (value + (value == 0));
+        lightness[i] = value;
+    }
+}
+
 template <>
 inline void convertSample(ColorRGB const& in, ColorHSL& out) {
     ColorHSV hsv;
@@ -55,5 +80,17 @@ inline void convertSample(ColorHSL const& in, ColorRGB& out) {
     convertSample(hsv, out);
 }
 
+template <>
+inline void convertPlanes<RGB, HSL>(ConvertTile& tile, size_t n) {
+    convertPlanes<RGB, HSV>(tile, n);
+    convertPlanes<HSV, HSL>(tile, n);
+}
+
+template <>
+inline void convertPlanes<HSL, RGB>(ConvertTile& tile, size_t n) {
+    convertPlanes<HSL, HSV>(tile, n);
+    convertPlanes<HSV, RGB>(tile, n);
+}
+
 } // converter
 } // timedata
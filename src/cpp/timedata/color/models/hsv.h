@@ -1,5 +1,6 @@
 #pragma once
 
+#include <timedata/base/cpu.h>
 #include <timedata/color/models/rgb.h>
 #include <timedata/signal/convert.h>
 
@@ -76,5 +77,143 @@ inline void convertSample(ColorHSV const& in, ColorRGB& out) {
     out = d();
 }
 
+/* The planar HSV conversions use SSE2 where they can, and convertSample for
+   the remaining samples.  The SSE2 kernels compute every branch of the
+   conversions above, four samples at a time, and select between the results,
+   which are the same as convertSample's. */
+
+#if TIMEDATA_X86_DISPATCH
+
+__attribute__((target("sse2")))
+inline __m128 selectSse2(__m128 mask, __m128 x, __m128 y) {
+    return _mm_or_ps(_mm_and_ps(mask, x), _mm_andnot_ps(mask, y));
+}
+
+/** Convert the samples of a tile four at a time, returning how many were
+    converted. */
+__attribute__((target("sse2")))
+inline size_t rgbToHsvSse2(ConvertTile& tile, size_t n) {
+    auto zero = _mm_setzero_ps();
+    auto one = _mm_set1_ps(1.0f);
+    auto two = _mm_set1_ps(2.0f);
+    auto four = _mm_set1_ps(4.0f);
+    auto six = _mm_set1_ps(6.0f);
+    auto x = tile.planes[0], y = tile.planes[1], z = tile.planes[2];
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        auto red = _mm_loadu_ps(x + i);
+        auto green = _mm_loadu_ps(y + i);
+        auto blue = _mm_loadu_ps(z + i);
+
+        // _mm_max_ps(b, a) is std::max(a, b), even for NaNs.
+        auto value = _mm_max_ps(blue, _mm_max_ps(green, red));
+        auto delta = _mm_sub_ps(
+            value, _mm_min_ps(blue, _mm_min_ps(green, red)));
+
+        auto yellowToMagenta = _mm_div_ps(_mm_sub_ps(green, blue), delta);
+        auto cyanToYellow = _mm_add_ps(
+            two, _mm_div_ps(_mm_sub_ps(blue, red), delta));
+        auto magentaToCyan = _mm_add_ps(
+            four, _mm_div_ps(_mm_sub_ps(red, green), delta));
+        auto hue = selectSse2(
+            _mm_cmpeq_ps(value, red), yellowToMagenta,
+            selectSse2(_mm_cmpeq_ps(value, green), cyanToYellow,
+                       magentaToCyan));
+        hue = _mm_div_ps(hue, six);
+        hue = selectSse2(_mm_cmplt_ps(hue, zero), _mm_add_ps(hue, one), hue);
+
+        auto black = _mm_cmpeq_ps(value, zero);
+        _mm_storeu_ps(x + i, _mm_andnot_ps(black, hue));
+        _mm_storeu_ps(y + i, _mm_andnot_ps(black, _mm_div_ps(delta, value)));
+        _mm_storeu_ps(z + i, _mm_andnot_ps(black, value));
+    }
+    return i;
+}
+
+__attribute__((target("sse2")))
+inline size_t hsvToRgbSse2(ConvertTile& tile, size_t n) {
+    auto zero = _mm_setzero_ps();
+    auto one = _mm_set1_ps(1.0f);
+    auto six = _mm_set1_ps(6.0f);
+    auto x = tile.planes[0], y = tile.planes[1], z = tile.planes[2];
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        auto hue = _mm_loadu_ps(x + i);
+        auto saturation = _mm_loadu_ps(y + i);
+        auto value = _mm_loadu_ps(z + i);
+
+        auto h = _mm_mul_ps(hue, six);
+        auto sector = _mm_cvttps_epi32(h);
+        auto f = _mm_sub_ps(h, _mm_cvtepi32_ps(sector));
+
+        auto a = _mm_mul_ps(value, _mm_sub_ps(one, saturation));
+        auto b = _mm_mul_ps(value, _mm_sub_ps(one, _mm_mul_ps(saturation, f)));
+        auto c = _mm_mul_ps(value, _mm_sub_ps(
+            one, _mm_mul_ps(saturation, _mm_sub_ps(one, f))));
+
+        __m128 is[5];
+        for (int k = 0; k < 5; ++k) {
+            is[k] = _mm_castsi128_ps(
+                _mm_cmpeq_epi32(sector, _mm_set1_epi32(k)));
+        }
+
+        auto red = selectSse2(is[1], b,
+            selectSse2(_mm_or_ps(is[2], is[3]), a,
+                selectSse2(is[4], c, value)));
+        auto green = selectSse2(is[0], c,
+            selectSse2(_mm_or_ps(is[1], is[2]), value,
+                selectSse2(is[3], b, a)));
+        auto blue = selectSse2(_mm_or_ps(is[0], is[1]), a,
+            selectSse2(is[2], c,
+                selectSse2(_mm_or_ps(is[3], is[4]), value, b)));
+
+        auto gray = _mm_cmpeq_ps(saturation, zero);
+        _mm_storeu_ps(x + i, selectSse2(gray, value, red));
+        _mm_storeu_ps(y + i, selectSse2(gray, value, green));
+        _mm_storeu_ps(z + i, selectSse2(gray, value, blue));
+    }
+    return i;
+}
+
+#endif
+
+template <>
+inline void convertPlanes<RGB, HSV>(ConvertTile& tile, size_t n) {
+    size_t i = 0;
+#if TIMEDATA_X86_DISPATCH
+    if (bestIsa() != Isa::scalar)
+        i = rgbToHsvSse2(tile, n);
+#endif
+    for (; i < n; ++i) {
+        ColorRGB in;
+        ColorHSV out;
+        for (size_t j = 0; j < 3; ++j)
+            in[j] = tile.planes[j][i];
+        convertSample(in, out);
+        for (size_t j = 0; j < 3; ++j)
+            tile.planes[j][i] = out[j];
+    }
+}
+
+template <>
+inline void convertPlanes<HSV, RGB>(ConvertTile& tile, size_t n) {
+    size_t i = 0;
+#if TIMEDATA_X86_DISPATCH
+    if (bestIsa() != Isa::scalar)
+        i = hsvToRgbSse2(tile, n);
+#endif
+    for (; i < n; ++i) {
+        ColorHSV in;
+        ColorRGB out;
+        for (size_t j = 0; j < 3; ++j)
+            in[j] = tile.planes[j][i];
+        convertSample(in, out);
+        for (size_t j = 0; j < 3; ++j)
+            tile.planes[j][i] = out[j];
+    }
+}
+
 } // converter
 } // timedata
@@ -15,25 +15,36 @@ namespace converter {
 
 // See: https://en.wikipedia.org/wiki/XYZ
 
+static const auto XYZ_D = 0.17697f;
+
+static const float RGB_TO_XYZ[3][3] = {
+    {0.49f  / XYZ_D, 0.31f   / XYZ_D, 0.2f     / XYZ_D},
+    {XYZ_D  / XYZ_D, 0.8124f / XYZ_D, 0.01063f / XYZ_D},
+    {0.0f   / XYZ_D, 0.01f   / XYZ_D, 0.99f    / XYZ_D}};
+
+static const float XYZ_TO_RGB[3][3] = {
+    { 0.41847f,    0.15866f,  -0.082835f},
+    {-0.091169f,   0.25243f,   0.015708f},
+    { 0.0009209f, -0.0025498f, 0.1786f}};
+
 template <>
 inline void convertSample(ColorRGB const& in, ColorXYZ& out) {
-    static const auto d = 0.17697f;
-    static const float matrix[3][3] = {
-        {0.49f / d, 0.31f   / d, 0.2f     / d},
-        {d     / d, 0.8124f / d, 0.01063f / d},
-        {0.0f  / d, 0.01f   / d, 0.99f    / d}};
-
-    matrixMultiply(matrix, in, out);
+    matrixMultiply(RGB_TO_XYZ, in, out);
 }
 
 template <>
 inline void convertSample(ColorXYZ const& in, ColorRGB& out) {
-    static const float matrix[3][3] = {
-        { 0.41847f,    0.15866f,  -0.082835f},
-        {-0.091169f,   0.25243f,   0.015708f},
-        { 0.0009209f, -0.0025498f, 0.1786f}};
+    matrixMultiply(XYZ_TO_RGB, in, out);
+}
 
-    matrixMultiply(matrix, in, out);
+template <>
+inline void convertPlanes<RGB, XYZ>(ConvertTile& tile, size_t n) {
+    multiplyPlanes(RGB_TO_XYZ, tile, n);
+}
+
+template <>
+inline void convertPlanes<XYZ, RGB>(ConvertTile& tile, size_t n) {
+    multiplyPlanes(XYZ_TO_RGB, tile, n);
 }
 
 } // converter
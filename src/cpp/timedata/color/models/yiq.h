@@ -15,24 +15,34 @@ namespace converter {
 
 // See: https://en.wikipedia.org/wiki/YIQ
 
+static const float RGB_TO_YIQ[3][3] = {
+    {0.299f,  0.587f,  0.114f},
+    {0.596f, -0.274f, -0.322f},
+    {0.211f, -0.523f,  0.312f}};
+
+static const float YIQ_TO_RGB[3][3] = {
+    {1.0f,  0.956f,  0.621f},
+    {1.0f, -0.272f, -0.647f},
+    {1.0f, -1.106f,  1.703f}};
+
 template <>
 inline void convertSample(ColorRGB const& in, ColorYIQ& out) {
-    static const float matrix[3][3] = {
-        {0.299f,  0.587f,  0.114f},
-        {0.596f, -0.274f, -0.322f},
-        {0.211f, -0.523f,  0.312f}};
-
-    matrixMultiply(matrix, in, out);
+    matrixMultiply(RGB_TO_YIQ, in, out);
 }
 
 template <>
 inline void convertSample(ColorYIQ const& in, ColorRGB& out) {
-    static const float matrix[3][3] = {
-        {1.0f,  0.956f,  0.621f},
-        {1.0f, -0.272f, -0.647f},
-        {1.0f, -1.106f,  1.703f}};
+    matrixMultiply(YIQ_TO_RGB, in, out);
+}
 
-    matrixMultiply(matrix, in, out);
+template <>
+inline void convertPlanes<RGB, YIQ>(ConvertTile& tile, size_t n) {
+    multiplyPlanes(RGB_TO_YIQ, tile, n);
+}
+
+template <>
+inline void convertPlanes<YIQ, RGB>(ConvertTile& tile, size_t n) {
+    multiplyPlanes(YIQ_TO_RGB, tile, n);
 }
 
 } // converter
@@ -15,24 +15,34 @@ namespace converter {
 
 // See: https://en.wikipedia.org/wiki/YUV
 
+static const float RGB_TO_YUV[3][3] = {
+    {0.299f,    0.587f,    0.114f},
+    {0.14713f, -0.28886f,  0.436f},
+    {0.615f,   -0.51499f, -0.10001f}};
+
+static const float YUV_TO_RGB[3][3] = {
+    {1.0f,  0.0f,      1.13983f},
+    {1.0f, -0.39465f, -0.58060f},
+    {1.0f,  2.03211f,  0.0f}};
+
 template <>
 inline void convertSample(ColorRGB const& in, ColorYUV& out) {
-    static const float matrix[3][3] = {
-        {0.299f,    0.587f,    0.114f},
-        {0.14713f, -0.28886f,  0.436f},
-        {0.615f,   -0.51499f, -0.10001f}};
-
-    matrixMultiply(matrix, in, out);
+    matrixMultiply(RGB_TO_YUV, in, out);
 }
 
 template <>
 inline void convertSample(ColorYUV const& in, ColorRGB& out) {
-    static const float matrix[3][3] = {
-        {1.0f,  0.0f,      1.13983f},
-        {1.0f, -0.39465f, -0.58060f},
-        {1.0f,  2.03211f,  0.0f}};
+    matrixMultiply(YUV_TO_RGB, in, out);
+}
 
-    matrixMultiply(matrix, in, out);
+template <>
+inline void convertPlanes<RGB, YUV>(ConvertTile& tile, size_t n) {
+    multiplyPlanes(RGB_TO_YUV, tile, n);
+}
+
+template <>
+inline void convertPlanes<YUV, RGB>(ConvertTile& tile, size_t n) {
+    multiplyPlanes(YUV_TO_RGB, tile, n);
 }
 
 } // converter
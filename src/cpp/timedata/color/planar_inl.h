@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include <timedata/base/instrument.h>
+#include <timedata/base/math.h>
+#include <timedata/base/rotate.h>
+#include <timedata/color/for.h>
+#include <timedata/signal/planar.h>
+
+namespace timedata {
+namespace color_list {
+
+/* Overloads of the list functions in cython_list_inl.h for Planar lists.
+
+   The elementwise math_* functions there need no overloads here, because they
+   all go through forParts1 and forParts2, which have Planar overloads in
+   for.h. */
+
+template <typename Sample>
+NumberType<Sample> compare(Planar<Sample> const& x, Planar<Sample> const& y) {
+    auto size = std::min(x.size(), y.size());
+    for (size_t i = 0; i < size; ++i) {
+        for (size_t j = 0; j < Sample::SIZE; ++j) {
+            if (auto d = x.planes[j][i] - y.planes[j][i])
+                return d;
+        }
+    }
+
+    return static_cast<NumberType<Sample>>(signum(x.size(), y.size()));
+}
+
+template <typename Sample>
+NumberType<Sample> compare(ValueType<Planar<Sample>> const& x,
+                           Planar<Sample> const& y) {
+    for (size_t i = 0; i < y.size(); ++i) {
+        for (size_t j = 0; j < Sample::SIZE; ++j) {
+            if (auto d = *x[j] - y.planes[j][i])
+                return d;
+        }
+    }
+
+    return 0;
+}
+
+template <typename Sample>
+NumberType<Sample> compare(NumberType<Planar<Sample>> x,
+                           Planar<Sample> const& y) {
+    for (size_t i = 0; i < y.size(); ++i) {
+        for (size_t j = 0; j < Sample::SIZE; ++j) {
+            if (auto d = x - y.planes[j][i])
+                return d;
+        }
+    }
+
+    return 0;
+}
+
+template <typename Sample>
+Sample min_cpp(Planar<Sample> const& cl) {
+    using Number = NumberType<Sample>;
+
+    Sample result;
+    for (size_t j = 0; j < Sample::SIZE; ++j) {
+        auto m = std::numeric_limits<Number>::infinity();
+        for (auto x: cl.planes[j])
+            m = std::min(m, x);
+        result[j] = m;
+    }
+    return result;
+}
+
+template <typename Sample>
+Sample max_cpp(Planar<Sample> const& cl) {
+    using Number = NumberType<Sample>;
+
+    Sample result;
+    for (size_t j = 0; j < Sample::SIZE; ++j) {
+        auto m = -std::numeric_limits<Number>::infinity();
+        for (auto x: cl.planes[j])
+            m = std::max(m, x);
+        result[j] = m;
+    }
+    return result;
+}
+
+template <typename Sample>
+NumberType<Sample> distance2(Planar<Sample> const& x,
+                             Planar<Sample> const& y) {
+    NumberType<Sample> result = 0.0f;
+    auto xShorter = x.size() < y.size();
+    auto& shorter = xShorter ? x : y;
+    auto& longer = xShorter ? y : x;
+
+    for (size_t j = 0; j < Sample::SIZE; ++j) {
+        auto s = shorter.planes[j].data();
+        auto l = longer.planes[j].data();
+
+        size_t i = 0;
+        for (; i < shorter.size(); ++i) {
+            auto d = l[i] - s[i];
+            result += d * d;
+        }
+        for (; i < longer.size(); ++i)
+            result += l[i] * l[i];
+    }
+
+    return result;
+}
+
+template <typename Sample>
+NumberType<Sample> distance2(ValueType<Planar<Sample>> const& x,
+                             Planar<Sample> const& y) {
+    NumberType<Sample> result = 0.0f;
+    for (size_t j = 0; j < Sample::SIZE; ++j) {
+        NumberType<Sample> xj = x[j];
+        for (auto yj: y.planes[j]) {
+            auto d = xj - yj;
+            result += d * d;
+        }
+    }
+    return result;
+}
+
+template <typename Sample>
+NumberType<Sample> distance2(NumberType<Planar<Sample>> x,
+                             Planar<Sample> const& y) {
+    NumberType<Sample> result = 0.0f;
+    for (auto& plane: y.planes) {
+        for (auto yj: plane) {
+            auto d = x - yj;
+            result += d * d;
+        }
+    }
+    return result;
+}
+
+template <typename Sample>
+void rotate(Planar<Sample>& out, int pos) {
+    for (auto& plane: out.planes)
+        timedata::rotate(plane, pos);
+}
+
+template <typename Sample>
+void rotate(Planar<Sample> const& in, Planar<Sample>& out, int pos) {
+    if (in.empty())
+        return;
+    if (out.size() < in.size())
+        out.resize(in.size());
+    pos = pos % static_cast<int>(in.size());
+    if (pos < 0)
+        pos += in.size();
+    for (size_t j = 0; j < Sample::SIZE; ++j) {
+        auto& i = in.planes[j];
+        std::rotate_copy(i.begin(), i.begin() + pos, i.end(),
+                         out.planes[j].begin());
+    }
+}
+
+template <typename Sample>
+void math_reverse(Planar<Sample> const& in, Planar<Sample>& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("math_reverse", in.size());
+    if (out.size() < in.size())
+        out.resize(in.size());
+    for (size_t j = 0; j < Sample::SIZE; ++j) {
+        auto& i = in.planes[j];
+        auto& o = out.planes[j];
+        if (&i == &o)
+            std::reverse(o.begin(), o.end());
+        else
+            std::reverse_copy(i.begin(), i.end(), o.begin());
+    }
+}
+
+template <typename Sample>
+void math_zero(Planar<Sample>& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("math_zero", out.size());
+    for (auto& plane: out.planes)
+        std::fill(plane.begin(), plane.end(), NumberType<Sample>{});
+}
+
+/** Returns the indices of the samples of a Planar list, in sorted order. */
+template <typename Sample>
+std::vector<size_t> sortedIndex(Planar<Sample> const& in) {
+    std::vector<size_t> index(in.size());
+    std::iota(index.begin(), index.end(), 0);
+    std::sort(index.begin(), index.end(), [&](size_t x, size_t y) {
+        for (size_t j = 0; j < Sample::SIZE; ++j) {
+            if (auto d = in.planes[j][x] - in.planes[j][y])
+                return d < 0;
+        }
+        return false;
+    });
+    return index;
+}
+
+template <typename Sample>
+void sort(Planar<Sample> const& in, Planar<Sample>& out, bool reversed) {
+    TIMEDATA_INSTRUMENT_SCOPE("sort", in.size());
+    if (in.empty())
+        return;
+    if (out.size() < in.size())
+        out.resize(in.size());
+    auto index = sortedIndex(in);
+
+    // Like partial_sort_copy, we write exactly in.size() samples.
+    auto begin = reversed ? out.size() - 1 : 0;
+    auto step = reversed ? -1 : 1;
+    for (size_t j = 0; j < Sample::SIZE; ++j) {
+        auto plane = in.planes[j];  // A copy, because out might be in.
+        auto o = out.planes[j].begin() + begin;
+        for (size_t k = 0; k < index.size(); ++k, o += step)
+            *o = plane[index[k]];
+    }
+}
+
+template <typename Sample>
+void sort(Planar<Sample>& out) {
+    sort(out, out, false);
+}
+
+} // color_list
+} // timedata
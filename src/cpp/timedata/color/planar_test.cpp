@@ -0,0 +1,135 @@
+#pragma once
+
+#include <timedata/base/nearlyEqual_test.h>
+#include <timedata/color/cython_list_inl.h>
+
+namespace timedata {
+namespace color_list {
+
+namespace {
+
+CColorListRGB testList(size_t size, float offset = 0.0f) {
+    CColorListRGB result(size);
+    for (size_t i = 0; i < size; ++i) {
+        auto x = offset + i;
+        result[i] = {x / 7.0f - 1.0f, (i % 3) / 2.0f, x * x / 100.0f};
+    }
+    return result;
+}
+
+CPlanarRGB toPlanarRGB(CColorListRGB const& in) {
+    CPlanarRGB out;
+    toPlanar(in, out);
+    return out;
+}
+
+CColorListRGB fromPlanarRGB(CPlanarRGB const& in) {
+    CColorListRGB out;
+    fromPlanar(in, out);
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("planar conversion", "[planar]") {
+    auto list = testList(17);
+    auto planar = toPlanarRGB(list);
+    REQUIRE(planar.size() == 17);
+    REQUIRE(planar.get(3) == list[3]);
+    REQUIRE(planar.planes[1][4] == list[4][1]);
+    REQUIRE(fromPlanarRGB(planar) == list);
+}
+
+TEST_CASE("planar arithmetic", "[planar]") {
+    auto x = testList(23), y = testList(23, 5.0f);
+    auto px = toPlanarRGB(x), py = toPlanarRGB(y);
+    color::CColorRGB c{0.5f, -2.0f, 3.0f};
+
+    math_add(x, y, x);
+    math_add(px, py, px);
+    REQUIRE(nearlyEqualLists(fromPlanarRGB(px), x));
+
+    math_mul(x, c, x);
+    math_mul(px, c, px);
+    REQUIRE(nearlyEqualLists(fromPlanarRGB(px), x));
+
+    math_sub(x, 0.25f, x);
+    math_sub(px, 0.25f, px);
+    REQUIRE(nearlyEqualLists(fromPlanarRGB(px), x));
+
+    math_rdiv(x, y, x);
+    math_rdiv(px, py, px);
+    REQUIRE(nearlyEqualLists(fromPlanarRGB(px), x));
+
+    math_pow(x, 1.5f, x);
+    math_pow(px, 1.5f, px);
+    REQUIRE(nearlyEqualLists(fromPlanarRGB(px), x));
+
+    math_invert(x, y);
+    math_invert(px, py);
+    REQUIRE(nearlyEqualLists(fromPlanarRGB(py), y));
+
+    math_min_limit(x, 0.0f, x);
+    math_min_limit(px, 0.0f, px);
+    REQUIRE(nearlyEqualLists(fromPlanarRGB(px), x));
+
+    math_reverse(x, x);
+    math_reverse(px, px);
+    REQUIRE(nearlyEqualLists(fromPlanarRGB(px), x));
+}
+
+TEST_CASE("planar math with a shorter operand", "[planar]") {
+    auto x = testList(31), y = testList(19, 2.0f);
+    auto px = toPlanarRGB(x), py = toPlanarRGB(y);
+
+    CColorListRGB out;
+    CPlanarRGB pout;
+    math_add(x, y, out);
+    math_add(px, py, pout);
+    REQUIRE(out.size() == 31);
+    REQUIRE(fromPlanarRGB(pout) == out);
+
+    math_add(px, py, px);
+    REQUIRE(fromPlanarRGB(px) == out);
+}
+
+TEST_CASE("planar reductions", "[planar]") {
+    auto x = testList(31), y = testList(19, 2.0f);
+    auto px = toPlanarRGB(x), py = toPlanarRGB(y);
+    color::CColorRGB c{0.5f, -2.0f, 3.0f};
+
+    REQUIRE(min_cpp(px) == min_cpp(x));
+    REQUIRE(max_cpp(px) == max_cpp(x));
+    REQUIRE(near(distance2(px, py), distance2(x, y), 0.01f));
+    REQUIRE(near(distance2(c, px), distance2(c, x), 0.01f));
+    REQUIRE(near(distance2(2.0f, px), distance2(2.0f, x), 0.01f));
+    REQUIRE(compare(px, py) == compare(x, y));
+    REQUIRE(compare(px, px) == 0);
+    REQUIRE(compare(c, px) == compare(c, x));
+}
+
+TEST_CASE("planar reordering", "[planar]") {
+    auto x = testList(13);
+    auto px = toPlanarRGB(x);
+
+    CColorListRGB y;
+    CPlanarRGB py;
+    rotate(x, y, -4);
+    rotate(px, py, -4);
+    REQUIRE(fromPlanarRGB(py) == y);
+
+    color_list::rotate(x, 5);
+    rotate(px, 5);
+    REQUIRE(fromPlanarRGB(px) == x);
+
+    sort(x, y, true);
+    sort(px, py, true);
+    REQUIRE(fromPlanarRGB(py) == y);
+
+    sort(x);
+    sort(px);
+    REQUIRE(fromPlanarRGB(px) == x);
+}
+
+} // color_list
+} // timedata
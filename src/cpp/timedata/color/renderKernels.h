@@ -0,0 +1,434 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include <timedata/base/cpu.h>
+#include <timedata/base/gammaTable.h>
+#include <timedata/signal/render3.h>
+
+namespace timedata {
+namespace color_list {
+
+/** Everything a rendering kernel needs, precomputed once per renderer so that
+    the kernels never have to look anything up per color. */
+struct RenderKernelData {
+    using Perm = std::array<uint8_t, 3>;
+
+    /** The gamma table has this many extra bytes at the end, so a four-byte
+        gather from its last entry never reads past the end of the table. */
+    static size_t const PADDING = 3;
+
+    RenderKernelData(GammaTable const&, Perm const&);
+    RenderKernelData() = default;
+
+    GammaTable table;  // Padded with PADDING zeroes.
+    size_t size = 0;   // The size of the table without the padding.
+    Perm perm = {{0, 1, 2}};
+
+    /* If this isn't empty, the bits8 output interpolates this table instead
+       of looking up `table`. */
+    CompactGammaTable compact;
+
+    /* The dither8 and bits16 outputs don't use the table, but interpolate
+       this curve, which goes from min to max in the units of the output. */
+    Render3::Output output = Render3::Output::bits8;
+    GammaCurve curve;
+
+    size_t bytesPerColor() const;
+
+    /* The AVX2 kernel renders eight colors at a time, which is 24 floats or
+       three vectors of eight floats.  For each output float, `block` says
+       which of the three input vectors holds the component it needs
+       after permutation, and `lane` says where it is in that vector. */
+    using Shuffle = std::array<std::array<int32_t, 8>, 3>;
+    Shuffle block, lane;
+};
+
+/** The number of bytes that each color takes in an output. */
+size_t bytesPerColor(Render3::Output);
+
+/** Render `count` colors starting at `in` into bytes at `out`, using
+    the kernel for a specific instruction set.  The caller must check that the
+    CPU supports that instruction set.
+
+    The dither8 output needs `residual` to point to 3 * `count` floats, which
+    carry each component's rounding error over to the next frame. */
+void renderKernel(Isa, RenderKernelData const&,
+                  float level, float const* in, size_t count, char* out,
+                  float* residual = nullptr);
+
+void renderScalar(RenderKernelData const&,
+                  float level, float const* in, size_t count, char* out);
+
+/** The kernel for the bits8 output with a CompactGammaTable.  Its results are
+    identical to getCompactGamma's. */
+void renderCompact(RenderKernelData const&,
+                   float level, float const* in, size_t count, char* out);
+
+/** The kernel for the dither8 and bits16 outputs.  bits16 writes each
+    component as two bytes, most significant first, which is the order that
+    16-bit LED chipsets read from the wire. */
+void renderCurve(RenderKernelData const&,
+                 float level, float const* in, size_t count, char* out,
+                 float* residual);
+
+/** Resize the residuals for dithering `count` colors.  New residuals are
+    spread evenly over [-0.5, 0.5), so that neighbouring pixels don't all
+    step between two levels on the same frame. */
+void resizeResidual(std::vector<float>& residual, size_t count);
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+
+inline RenderKernelData::RenderKernelData(GammaTable const& t, Perm const& p)
+        : table(t), size(t.size()), perm(p) {
+    table.resize(size + PADDING);
+    for (size_t i = 0; i < 24; ++i) {
+        auto source = i - i % 3 + perm[i % 3];
+        block[i / 8][i % 8] = static_cast<int32_t>(source / 8);
+        lane[i / 8][i % 8] = static_cast<int32_t>(source % 8);
+    }
+}
+
+inline size_t bytesPerColor(Render3::Output output) {
+    return output == Render3::Output::bits16 ? 6 : 3;
+}
+
+inline size_t RenderKernelData::bytesPerColor() const {
+    return color_list::bytesPerColor(output);
+}
+
+inline void resizeResidual(std::vector<float>& residual, size_t count) {
+    static float const GOLDEN = 0.618034f;
+    auto old = residual.size();
+    residual.resize(3 * count);
+    for (auto i = old; i < residual.size(); ++i) {
+        auto x = i * GOLDEN;
+        residual[i] = x - std::floor(x) - 0.5f;
+    }
+}
+
+/* In renderCurve and renderCurveAvx2, value + residual is never less than
+   the curve's minimum minus one half, so rounding can truncate instead of
+   calling std::floor, which is much slower without SSE4.1. */
+inline void renderCurve(RenderKernelData const& d,
+                        float level, float const* in, size_t count, char* out,
+                        float* residual) {
+    auto curve = d.curve.data();
+    auto segments = static_cast<float>(d.curve.size() - 1);
+    auto last = static_cast<int32_t>(d.curve.size() - 2);
+    auto low = static_cast<int32_t>(d.curve.front()),
+         high = static_cast<int32_t>(d.curve.back());
+    auto bits16 = d.output == Render3::Output::bits16;
+
+    for (size_t i = 0; i < count; ++i, in += 3) {
+        for (size_t k = 0; k < 3; ++k) {
+            auto x = level * in[d.perm[k]];
+            x = std::min(std::max(x, 0.0f), 1.0f) * segments;
+            auto j = std::min(static_cast<int32_t>(x), last);
+            auto v = curve[j] + (x - j) * (curve[j + 1] - curve[j]);
+
+            if (bits16) {
+                auto q = static_cast<uint16_t>(v + 0.5f);
+                *out++ = static_cast<char>(q >> 8);
+                *out++ = static_cast<char>(q & 0xFF);
+            } else {
+                v += *residual;
+                auto q = std::min(std::max(
+                    static_cast<int32_t>(v + 0.5f), low), high);
+                *residual++ = v - q;
+                *out++ = static_cast<char>(q);
+            }
+        }
+    }
+}
+
+inline void renderScalar(RenderKernelData const& d,
+                         float level, float const* in, size_t count,
+                         char* out) {
+    for (size_t i = 0; i < count; ++i, in += 3) {
+        for (size_t j = 0; j < 3; ++j, ++out) {
+            auto component = level * in[d.perm[j]];
+            auto index = static_cast<size_t>(
+                d.size * std::max(component, 0.0f));
+            *out = static_cast<char>(d.table[std::min(index, d.size - 1)]);
+        }
+    }
+}
+
+inline void renderCompact(RenderKernelData const& d,
+                          float level, float const* in, size_t count,
+                          char* out) {
+    auto table = d.compact.data();
+    auto scale = 256.0f * static_cast<float>(d.compact.size() - 2);
+    for (size_t i = 0; i < count; ++i, in += 3) {
+        for (size_t k = 0; k < 3; ++k) {
+            auto x = level * in[d.perm[k]];
+            x = std::min(std::max(x, 0.0f), 1.0f) * scale;
+            auto u = static_cast<uint32_t>(x);
+            auto j = u >> 8, f = u & 0xFF;
+            *out++ = static_cast<char>(
+                (table[j] * (256 - f) + table[j + 1] * f) >> 15);
+        }
+    }
+}
+
+#if TIMEDATA_X86_DISPATCH
+
+/* The SSE2 kernel computes the gamma indices four floats at a time, but SSE2
+   has neither a gather nor a variable shuffle, so the table lookups and the
+   permutation are still done one byte at a time. */
+__attribute__((target("sse2")))
+inline void renderSse2(RenderKernelData const& d,
+                       float level, float const* in, size_t count, char* out) {
+    auto levels = _mm_set1_ps(level);
+    auto zero = _mm_setzero_ps();
+    auto size = _mm_set1_ps(static_cast<float>(d.size));
+    auto top = _mm_set1_ps(static_cast<float>(d.size - 1));
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4, in += 12, out += 12) {
+        alignas(16) int32_t index[12];
+        for (size_t k = 0; k < 3; ++k) {
+            auto x = _mm_max_ps(_mm_mul_ps(_mm_loadu_ps(in + 4 * k), levels),
+                                zero);
+            x = _mm_min_ps(_mm_mul_ps(x, size), top);
+            _mm_store_si128(reinterpret_cast<__m128i*>(index + 4 * k),
+                            _mm_cvttps_epi32(x));
+        }
+        for (size_t j = 0; j < 12; j += 3) {
+            for (size_t k = 0; k < 3; ++k)
+                out[j + k] = static_cast<char>(d.table[index[j + d.perm[k]]]);
+        }
+    }
+    renderScalar(d, level, in, count - i, out);
+}
+
+/** Permutes eight colors, loaded as three vectors of eight floats, into the
+    order of the output, with lane shuffles. */
+struct Avx2Permutation {
+    __m256i lane[3], fromSecond[3], fromThird[3];
+
+    __attribute__((target("avx2")))
+    explicit Avx2Permutation(RenderKernelData const& d) {
+        for (size_t v = 0; v < 3; ++v) {
+            auto block = _mm256_loadu_si256(
+                reinterpret_cast<__m256i const*>(d.block[v].data()));
+            lane[v] = _mm256_loadu_si256(
+                reinterpret_cast<__m256i const*>(d.lane[v].data()));
+            fromSecond[v] = _mm256_cmpeq_epi32(block, _mm256_set1_epi32(1));
+            fromThird[v] = _mm256_cmpeq_epi32(block, _mm256_set1_epi32(2));
+        }
+    }
+
+    /** Return output vector `v` of the three. */
+    __attribute__((target("avx2")))
+    __m256 operator()(size_t v, __m256 first, __m256 second,
+                      __m256 third) const {
+        auto x = _mm256_permutevar8x32_ps(first, lane[v]);
+        x = _mm256_blendv_ps(x, _mm256_permutevar8x32_ps(second, lane[v]),
+                             _mm256_castsi256_ps(fromSecond[v]));
+        return _mm256_blendv_ps(x, _mm256_permutevar8x32_ps(third, lane[v]),
+                                _mm256_castsi256_ps(fromThird[v]));
+    }
+};
+
+/* Shuffles that pack the low byte of each of eight int32s into the low eight
+   bytes of a vector. */
+__attribute__((target("avx2")))
+inline __m256i avx2PackBytes(__m256i x) {
+    auto bytes = _mm256_setr_epi8(
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    auto lanes = _mm256_setr_epi32(0, 4, 1, 1, 1, 1, 1, 1);
+    return _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(x, bytes), lanes);
+}
+
+/* The AVX2 kernel permutes eight colors at a time with lane shuffles, then
+   computes the gamma indices and gathers the table entries eight at a time,
+   and finally packs the low bytes of the entries together for output. */
+__attribute__((target("avx2")))
+inline void renderAvx2(RenderKernelData const& d,
+                       float level, float const* in, size_t count, char* out) {
+    auto levels = _mm256_set1_ps(level);
+    auto zero = _mm256_setzero_ps();
+    auto size = _mm256_set1_ps(static_cast<float>(d.size));
+    auto top = _mm256_set1_ps(static_cast<float>(d.size - 1));
+    auto lowByte = _mm256_set1_epi32(0xFF);
+    auto table = reinterpret_cast<int const*>(d.table.data());
+    Avx2Permutation permute(d);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8, in += 24, out += 24) {
+        auto first = _mm256_loadu_ps(in);
+        auto second = _mm256_loadu_ps(in + 8);
+        auto third = _mm256_loadu_ps(in + 16);
+
+        for (size_t v = 0; v < 3; ++v) {
+            auto x = permute(v, first, second, third);
+            x = _mm256_max_ps(_mm256_mul_ps(x, levels), zero);
+            x = _mm256_min_ps(_mm256_mul_ps(x, size), top);
+
+            auto gamma = _mm256_and_si256(
+                _mm256_i32gather_epi32(table, _mm256_cvttps_epi32(x), 1),
+                lowByte);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 8 * v),
+                             _mm256_castsi256_si128(avx2PackBytes(gamma)));
+        }
+    }
+    renderScalar(d, level, in, count - i, out);
+}
+
+/* The AVX2 compact kernel permutes like renderAvx2.  Since the entries of a
+   CompactGammaTable are two bytes each, one four-byte gather fetches both
+   ends of a segment as a pair of 16-bit integers, which a single multiply-add
+   interpolates in fixed point. */
+__attribute__((target("avx2")))
+inline void renderCompactAvx2(RenderKernelData const& d,
+                              float level, float const* in, size_t count,
+                              char* out) {
+    auto levels = _mm256_set1_ps(level);
+    auto zero = _mm256_setzero_ps();
+    auto one = _mm256_set1_ps(1.0f);
+    auto scale = _mm256_set1_ps(
+        256.0f * static_cast<float>(d.compact.size() - 2));
+    auto lowByte = _mm256_set1_epi32(0xFF);
+    auto whole = _mm256_set1_epi32(256);
+    auto table = reinterpret_cast<int const*>(d.compact.data());
+    Avx2Permutation permute(d);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8, in += 24, out += 24) {
+        auto first = _mm256_loadu_ps(in);
+        auto second = _mm256_loadu_ps(in + 8);
+        auto third = _mm256_loadu_ps(in + 16);
+
+        for (size_t v = 0; v < 3; ++v) {
+            auto x = _mm256_mul_ps(permute(v, first, second, third), levels);
+            x = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(x, zero), one),
+                              scale);
+            auto u = _mm256_cvttps_epi32(x);
+            auto f = _mm256_and_si256(u, lowByte);
+            auto ends = _mm256_i32gather_epi32(
+                table, _mm256_srli_epi32(u, 8), 2);
+            auto weights = _mm256_or_si256(_mm256_sub_epi32(whole, f),
+                                           _mm256_slli_epi32(f, 16));
+            auto gamma = _mm256_srli_epi32(
+                _mm256_madd_epi16(ends, weights), 15);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 8 * v),
+                             _mm256_castsi256_si128(avx2PackBytes(gamma)));
+        }
+    }
+    renderCompact(d, level, in, count - i, out);
+}
+
+/* The AVX2 curve kernel permutes like renderAvx2, then gathers both ends of
+   each curve segment and interpolates eight components at a time.  Its
+   results are identical to renderCurve's. */
+__attribute__((target("avx2")))
+inline void renderCurveAvx2(RenderKernelData const& d,
+                            float level, float const* in, size_t count,
+                            char* out, float* residual) {
+    auto levels = _mm256_set1_ps(level);
+    auto zero = _mm256_setzero_ps();
+    auto one = _mm256_set1_ps(1.0f);
+    auto half = _mm256_set1_ps(0.5f);
+    auto segments = _mm256_set1_ps(static_cast<float>(d.curve.size() - 1));
+    auto last = _mm256_set1_epi32(static_cast<int32_t>(d.curve.size() - 2));
+    auto low = _mm256_set1_epi32(static_cast<int32_t>(d.curve.front()));
+    auto high = _mm256_set1_epi32(static_cast<int32_t>(d.curve.back()));
+    auto curve = d.curve.data();
+    auto bits16 = d.output == Render3::Output::bits16;
+    Avx2Permutation permute(d);
+
+    // Pack the low two bytes of eight int32s, high byte first.
+    auto words = _mm256_setr_epi8(
+        1, 0, 5, 4, 9, 8, 13, 12, -1, -1, -1, -1, -1, -1, -1, -1,
+        1, 0, 5, 4, 9, 8, 13, 12, -1, -1, -1, -1, -1, -1, -1, -1);
+    auto wordLanes = _mm256_setr_epi32(0, 1, 4, 5, 1, 1, 1, 1);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8, in += 24) {
+        auto first = _mm256_loadu_ps(in);
+        auto second = _mm256_loadu_ps(in + 8);
+        auto third = _mm256_loadu_ps(in + 16);
+
+        for (size_t v = 0; v < 3; ++v) {
+            auto x = _mm256_mul_ps(permute(v, first, second, third), levels);
+            x = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(x, zero), one),
+                              segments);
+            auto j = _mm256_min_epi32(_mm256_cvttps_epi32(x), last);
+            auto a = _mm256_i32gather_ps(curve, j, 4);
+            auto b = _mm256_i32gather_ps(curve + 1, j, 4);
+            auto fraction = _mm256_sub_ps(x, _mm256_cvtepi32_ps(j));
+            auto value = _mm256_add_ps(
+                a, _mm256_mul_ps(fraction, _mm256_sub_ps(b, a)));
+
+            if (bits16) {
+                auto q = _mm256_cvttps_epi32(_mm256_add_ps(value, half));
+                q = _mm256_permutevar8x32_epi32(
+                    _mm256_shuffle_epi8(q, words), wordLanes);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * v),
+                                 _mm256_castsi256_si128(q));
+            } else {
+                value = _mm256_add_ps(value, _mm256_loadu_ps(residual + 8 * v));
+                auto q = _mm256_cvttps_epi32(_mm256_add_ps(value, half));
+                q = _mm256_min_epi32(_mm256_max_epi32(q, low), high);
+                _mm256_storeu_ps(residual + 8 * v,
+                                 _mm256_sub_ps(value, _mm256_cvtepi32_ps(q)));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 8 * v),
+                                 _mm256_castsi256_si128(avx2PackBytes(q)));
+            }
+        }
+        out += bits16 ? 48 : 24;
+        if (not bits16)
+            residual += 24;
+    }
+    renderCurve(d, level, in, count - i, out, residual);
+}
+
+#endif
+
+inline void renderKernel(Isa isa, RenderKernelData const& d,
+                         float level, float const* in, size_t count,
+                         char* out, float* residual) {
+    if (d.output != Render3::Output::bits8) {
+#if TIMEDATA_X86_DISPATCH
+        if (isa >= Isa::avx2)
+            return renderCurveAvx2(d, level, in, count, out, residual);
+#endif
+        return renderCurve(d, level, in, count, out, residual);
+    }
+
+    // SSE2 has no gather, so the compact table has no SSE2 kernel.
+    if (not d.compact.empty()) {
+#if TIMEDATA_X86_DISPATCH
+        if (isa >= Isa::avx2)
+            return renderCompactAvx2(d, level, in, count, out);
+#endif
+        return renderCompact(d, level, in, count, out);
+    }
+
+#if TIMEDATA_X86_DISPATCH
+    // The AVX2 kernels are also the ones used on AVX-512 CPUs.
+    switch (isa) {
+        case Isa::avx512:
+        case Isa::avx2:
+            return renderAvx2(d, level, in, count, out);
+        case Isa::sse2:
+            return renderSse2(d, level, in, count, out);
+        default:
+            break;
+    }
+#else
+    (void) isa;
+#endif
+    renderScalar(d, level, in, count, out);
+}
+
+}
+}
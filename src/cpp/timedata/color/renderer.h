@@ -1,29 +1,71 @@
 #pragma once
 
+#include <timedata/base/cpu.h>
+#include <timedata/base/dirtyRanges.h>
 #include <timedata/base/gammaTable.h>
+#include <timedata/base/instrument.h>
 #include <timedata/signal/render3.h>
 #include <timedata/color/cython_list_inl.h>
+#include <timedata/color/renderKernels.h>
 
 namespace timedata {
 namespace color_list {
 
 class CRenderer {
   public:
-    CRenderer(Render3);
+    CRenderer(Render3, Isa = bestIsa());
     CRenderer() = default;
     CRenderer& operator=(CRenderer const&) = default;
 
     /** Render a CColorListRGB to a byte buffer.  The number of bytes pointed to
-        by `out` must be at least 3 times the number of colors. */
+        by `out` must be at least bytesPerColor() times the number of colors.
+
+        The dither8 output remembers the rounding error of each component of
+        each color from one call to the next, so that over a few frames each
+        color averages out to its exact value. */
     void render(float level, CColorListRGB const& colors, char* out);
 
+    /** Render only the colors in `dirty` to `out`, which must already hold
+        the previous frame from this CRenderer.  Every color is rendered if
+        there was no previous frame, if the level or the number of colors has
+        changed since then, or if the output dithers, since then every color
+        can change.
+
+        Returns the ranges of colors that were rendered, so that a transport
+        can send just those. */
+    DirtyRanges const& renderDirty(float level, CColorListRGB const& colors,
+                                   DirtyRanges const& dirty, char* out);
+
+    /** The number of bytes that each color takes in the output. */
+    size_t bytesPerColor() const { return kernel_.bytesPerColor(); }
+
+    /** Forget the rounding errors remembered for dithering. */
+    void resetDither() { residual_.clear(); }
+
+    /** The instruction set used by render(). */
+    Isa isa() const { return isa_; }
+
+    /** Select the instruction set for render().  If the CPU doesn't support
+        `isa`, the best one that it does support is used instead. */
+    void setIsa(Isa isa) { isa_ = supportedIsa(isa); }
+
+    /** Precompute everything that the kernels need to render a Render3. */
+    static RenderKernelData makeKernel(Render3 const&);
+
   private:
-    using Perm = std::array<uint8_t, 3>;
+    using Perm = RenderKernelData::Perm;
 
     static Perm getPerm(Render3::Permutation);
 
-    GammaTable gammaTable_;
-    Perm perm_;
+    RenderKernelData kernel_;
+    std::vector<float> residual_;
+    Isa isa_ = bestIsa();
+
+    // The previous frame, for renderDirty().
+    static size_t const NO_FRAME = ~size_t(0);
+    float lastLevel_ = 0;
+    size_t lastSize_ = NO_FRAME;
+    DirtyRanges rendered_;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -31,22 +73,69 @@ class CRenderer {
 //
 // Implementation details follow.
 
-inline CRenderer::CRenderer(Render3 r)
-        : gammaTable_(makeGammaTable(r.gamma, r.min, r.max)),
-          perm_(getPerm(r.permutation)) {
+inline CRenderer::CRenderer(Render3 r, Isa isa)
+        : kernel_(makeKernel(r)), isa_(supportedIsa(isa)) {
+}
+
+inline RenderKernelData CRenderer::makeKernel(Render3 const& r) {
+    // Only the bits8 output uses a table, and then only one of the two.
+    auto bits8 = r.output == Render3::Output::bits8;
+    auto compact = bits8 and r.table == Render3::Table::compact;
+    RenderKernelData kernel(
+        bits8 and not compact ? makeGammaTable(r.gamma, r.min, r.max)
+                              : GammaTable(),
+        getPerm(r.permutation));
+    kernel.output = r.output;
+    if (compact)
+        kernel.compact = makeCompactGammaTable(r.gamma, r.min, r.max);
+    if (r.output != Render3::Output::bits8) {
+        // 16-bit outputs stretch the 8-bit limits so that 255 becomes 65535.
+        auto scale = r.output == Render3::Output::bits16 ? 257.0f : 1.0f;
+        kernel.curve = makeGammaCurve(r.gamma, scale * r.min, scale * r.max);
+    }
+    return kernel;
 }
 
 /** Render a CColorListRGB to a byte buffer.  The number of bytes pointed to
-    by `out` must be at least 3 times the number of colors. */
+    by `out` must be at least bytesPerColor() times the number of colors. */
 inline void CRenderer::render(float level, CColorListRGB const& colors,
                              char* out) {
-    for (size_t i = 0; i < colors.size(); ++i) {
-        for (size_t j = 0; j < colors[i].size(); ++j, ++out) {
-            auto component = level * colors[i][perm_[j]];
-            auto gamma = getGamma(gammaTable_, component);
-            *out = static_cast<char>(gamma);
-        }
+    static_assert(sizeof(color::CColorRGB) == 3 * sizeof(float),
+                  "The kernels need the colors to be packed floats");
+    TIMEDATA_INSTRUMENT_SCOPE("render", colors.size());
+    lastLevel_ = level;
+    lastSize_ = colors.size();
+    if (colors.empty())
+        return;
+
+    if (kernel_.output == Render3::Output::dither8 and
+        residual_.size() != 3 * colors.size()) {
+        resizeResidual(residual_, colors.size());
+    }
+    renderKernel(isa_, kernel_, level, &*colors[0][0], colors.size(), out,
+                 residual_.data());
+}
+
+inline DirtyRanges const& CRenderer::renderDirty(
+        float level, CColorListRGB const& colors, DirtyRanges const& dirty,
+        char* out) {
+    TIMEDATA_INSTRUMENT_SCOPE("renderDirty", colors.size());
+    auto size = colors.size();
+    rendered_.clear();
+    if (level != lastLevel_ or size != lastSize_ or
+        kernel_.output == Render3::Output::dither8) {
+        render(level, colors, out);
+        rendered_.add(0, size);
+        return rendered_;
+    }
+
+    rendered_ = dirty;
+    rendered_.truncate(size);
+    for (auto& r: rendered_.ranges()) {
+        renderKernel(isa_, kernel_, level, &*colors[r.first][0],
+                     r.second - r.first, out + bytesPerColor() * r.first);
     }
+    return rendered_;
 }
 
 inline CRenderer::Perm CRenderer::getPerm(Render3::Permutation perm) {
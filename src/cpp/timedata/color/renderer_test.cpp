@@ -0,0 +1,249 @@
+#pragma once
+
+#include <random>
+
+#include <timedata/color/renderer.h>
+
+namespace timedata {
+namespace color_list {
+
+namespace {
+
+CColorListRGB randomColors(size_t size) {
+    // Deliberately include out-of-band values.
+    std::mt19937 generator(size);
+    std::uniform_real_distribution<float> dist(-0.25f, 1.25f);
+
+    CColorListRGB colors(size);
+    for (auto& c: colors) {
+        for (auto& x: c)
+            x = dist(generator);
+    }
+    return colors;
+}
+
+std::vector<char> render(CRenderer& renderer, Isa isa, float level,
+                         CColorListRGB const& colors) {
+    std::vector<char> out(renderer.bytesPerColor() * colors.size());
+    renderer.setIsa(isa);
+    renderer.render(level, colors, out.data());
+    return out;
+}
+
+/** Check that every kernel renders the same as the scalar kernel. */
+void testKernels(Render3 const& r) {
+    auto kernel = CRenderer::makeKernel(r);
+    for (size_t size = 0; size < 40; ++size) {
+        auto colors = randomColors(size);
+
+        // Each kernel starts with the same dithering residuals.
+        std::vector<float> start;
+        resizeResidual(start, size);
+
+        for (auto level: {1.0f, 0.7f}) {
+            auto run = [&](Isa isa) {
+                auto residual = start;
+                std::vector<char> out(kernel.bytesPerColor() * size);
+                if (size) {
+                    renderKernel(isa, kernel, level, &*colors[0][0], size,
+                                 out.data(), residual.data());
+                }
+                return std::make_pair(out, residual);
+            };
+            auto expected = run(Isa::scalar);
+            timedata::forEach<Isa>([&](Isa isa) {
+                REQUIRE(run(isa) == expected);
+            });
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("renderer isa", "[renderer]") {
+    REQUIRE(supportedIsa(Isa::scalar) == Isa::scalar);
+    REQUIRE(supportedIsa(Isa::last) == bestIsa());
+    REQUIRE(isaName(Isa::sse2) == "sse2");
+
+    CRenderer renderer({}, Isa::scalar);
+    REQUIRE(renderer.isa() == Isa::scalar);
+}
+
+TEST_CASE("renderer kernels", "[renderer]") {
+    for (uint8_t o = 0; o < 3; ++o) {
+        for (auto gamma: {1.0f, 2.5f}) {
+            for (auto min: {0, 0x80}) {
+                for (uint8_t p = 0; p < 6; ++p) {
+                    Render3 r;
+                    r.gamma = gamma;
+                    r.min = static_cast<uint8_t>(min);
+                    r.permutation = static_cast<Render3::Permutation>(p);
+                    r.output = static_cast<Render3::Output>(o);
+                    testKernels(r);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("renderer compact", "[renderer]") {
+    for (auto gamma: {1.0f, 2.5f}) {
+        for (uint8_t p = 0; p < 6; ++p) {
+            Render3 r;
+            r.gamma = gamma;
+            r.min = 0x10;
+            r.permutation = static_cast<Render3::Permutation>(p);
+            r.table = Render3::Table::compact;
+            testKernels(r);
+        }
+    }
+
+    Render3 r;
+    r.gamma = 2.5f;
+    r.table = Render3::Table::compact;
+    CRenderer renderer(r);
+    auto table = makeCompactGammaTable(2.5f);
+    auto colors = randomColors(50);
+
+    timedata::forEach<Isa>([&](Isa isa) {
+        auto out = render(renderer, isa, 0.8f, colors);
+        for (size_t i = 0; i < out.size(); ++i) {
+            auto x = 0.8f * colors[i / 3][i % 3];
+            REQUIRE(uint8_t(out[i]) == getCompactGamma(table, x));
+        }
+    });
+}
+
+TEST_CASE("renderer permutation", "[renderer]") {
+    CColorListRGB colors(1);
+    colors[0] = {0.0f, 0.5f, 1.0f};
+
+    Render3 r;
+    r.permutation = Render3::Permutation::brg;
+    CRenderer renderer(r);
+
+    timedata::forEach<Isa>([&](Isa isa) {
+        auto out = render(renderer, isa, 1.0f, colors);
+        REQUIRE(uint8_t(out[0]) == 255);
+        REQUIRE(uint8_t(out[1]) == 0);
+        REQUIRE(uint8_t(out[2]) == 128);
+    });
+}
+
+TEST_CASE("renderer bits16", "[renderer]") {
+    Render3 r;
+    r.output = Render3::Output::bits16;
+    CRenderer renderer(r);
+    REQUIRE(renderer.bytesPerColor() == 6);
+
+    CColorListRGB colors(1);
+    colors[0] = {0.0f, 0.5f, 1.0f};
+    auto out = render(renderer, Isa::scalar, 1.0f, colors);
+    std::vector<char> expected = {0, 0, char(0x80), 0, char(0xFF), char(0xFF)};
+    REQUIRE(out == expected);
+
+    r.gamma = 2.5f;
+    r.permutation = Render3::Permutation::gbr;
+    renderer = CRenderer(r);
+    colors = randomColors(100);
+    out = render(renderer, Isa::scalar, 0.8f, colors);
+
+    auto curve = makeGammaCurve(2.5f, 0.0f, 65535.0f);
+    for (size_t i = 0; i < colors.size(); ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            auto x = 0.8f * colors[i][(j + 1) % 3];
+            auto high = uint8_t(out[6 * i + 2 * j]),
+                low = uint8_t(out[6 * i + 2 * j + 1]);
+            REQUIRE((high << 8) + low ==
+                    uint16_t(getGammaCurve(curve, x) + 0.5f));
+        }
+    }
+}
+
+TEST_CASE("renderer dither8", "[renderer]") {
+    Render3 r;
+    r.gamma = 2.5f;
+    CRenderer banded(r);
+    r.output = Render3::Output::dither8;
+    CRenderer renderer(r);
+    REQUIRE(renderer.bytesPerColor() == 3);
+
+    // Dark values that the plain 8-bit output rounds down to a few levels.
+    CColorListRGB colors(20);
+    for (size_t i = 0; i < colors.size(); ++i) {
+        auto x = 0.05f + 0.01f * i;
+        colors[i] = {x, x / 2, x / 3};
+    }
+    auto curve = makeGammaCurve(2.5f, 0.0f, 255.0f);
+
+    static size_t const FRAMES = 256;
+    std::vector<size_t> sum(3 * colors.size());
+    for (size_t frame = 0; frame < FRAMES; ++frame) {
+        auto out = render(renderer, Isa::scalar, 1.0f, colors);
+        auto plain = render(banded, Isa::scalar, 1.0f, colors);
+        for (size_t k = 0; k < out.size(); ++k) {
+            auto exact = getGammaCurve(curve, colors[k / 3][k % 3]);
+            auto value = uint8_t(out[k]);
+
+            // Each frame is one of the two levels either side of the exact
+            // value.
+            REQUIRE(value >= std::floor(exact) - 0.001f);
+            REQUIRE(value <= std::ceil(exact) + 0.001f);
+            REQUIRE(std::abs(value - uint8_t(plain[k])) <= 1);
+            sum[k] += value;
+        }
+    }
+
+    // Over many frames, each component averages out to its exact value.
+    for (size_t k = 0; k < sum.size(); ++k) {
+        auto exact = getGammaCurve(curve, colors[k / 3][k % 3]);
+        REQUIRE(std::abs(float(sum[k]) / FRAMES - exact) < 1.0f / FRAMES);
+    }
+
+    renderer.resetDither();
+    render(renderer, Isa::scalar, 1.0f, colors);
+}
+
+TEST_CASE("renderer renderDirty", "[renderer]") {
+    using Ranges = std::vector<DirtyRanges::Range>;
+    Render3 r;
+    r.gamma = 2.5f;
+    CRenderer renderer(r), full(r);
+    auto colors = randomColors(100);
+    std::vector<char> out(300, 0);
+    DirtyRanges dirty;
+
+    // The first frame renders everything.
+    REQUIRE(renderer.renderDirty(1.0f, colors, dirty, out.data()).ranges() ==
+            (Ranges{{0, 100}}));
+    REQUIRE(out == render(full, Isa::scalar, 1.0f, colors));
+
+    // Then only what changed.
+    colors[5] = {0.5f, 0.25f, 0.125f};
+    colors[60] = colors[61] = {1.0f, 0.0f, 0.5f};
+    dirty.add(5, 6);
+    dirty.add(60, 62);
+    std::fill(out.begin() + 3 * 6, out.begin() + 3 * 60, 0);
+    REQUIRE(renderer.renderDirty(1.0f, colors, dirty, out.data()).ranges() ==
+            dirty.ranges());
+    auto expected = render(full, Isa::scalar, 1.0f, colors);
+    std::fill(expected.begin() + 3 * 6, expected.begin() + 3 * 60, 0);
+    REQUIRE(out == expected);
+
+    // A new level or size renders everything again.
+    REQUIRE(renderer.renderDirty(0.5f, colors, dirty, out.data()).count() ==
+            100);
+    REQUIRE(out == render(full, Isa::scalar, 0.5f, colors));
+    colors.resize(50);
+    REQUIRE(renderer.renderDirty(0.5f, colors, dirty, out.data()).count() ==
+            50);
+    REQUIRE(renderer.renderDirty(0.5f, colors, {}, out.data()).empty());
+
+    r.output = Render3::Output::dither8;
+    CRenderer dither(r);
+    dither.render(1.0f, colors, out.data());
+    REQUIRE(dither.renderDirty(1.0f, colors, {}, out.data()).count() == 50);
+}
+
+} // color_list
+} // timedata
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <timedata/base/parallel.h>
+#include <timedata/color/renderer.h>
+
+namespace timedata {
+namespace color_list {
+
+/** Renders a whole frame for many LED strips in one call.
+
+    Each segment copies a range of colors from one input list to its own place
+    in the output frame, with its own gamma, limits and permutation, so strips
+    with different chipsets can be packed into one buffer for a DMA or SPI
+    transfer without any intermediate buffers.
+
+    The segments are rendered in parallel when the frame is long enough - see
+    parallel.h.  Segments with the dither8 output each keep their own
+    rounding errors from frame to frame, like a CRenderer does. */
+class CSegmentRenderer {
+  public:
+    struct Segment {
+        size_t begin, end;  // The range of colors in the input list.
+        size_t offset;      // The first byte of the segment in the output.
+        size_t kernel;      // The index of its RenderKernelData.
+    };
+
+    explicit CSegmentRenderer(Isa = bestIsa());
+
+    /** Add a segment that renders the colors [begin, end) of the input to the
+        bytes starting at `offset` in the output.  Returns false and adds
+        nothing if `begin > end`, or if the segment's bytes would overlap the
+        bytes of another segment. */
+    bool add(Render3 const&, size_t begin, size_t end, size_t offset);
+
+    void clear();
+
+    /** The number of segments. */
+    size_t size() const { return segments_.size(); }
+    Segment const& segment(size_t i) const { return segments_[i]; }
+
+    /** The smallest number of colors that an input list needs. */
+    size_t inputSize() const { return inputSize_; }
+
+    /** The smallest number of bytes that an output frame needs. */
+    size_t frameSize() const { return frameSize_; }
+
+    /** Render every segment of `colors` into the frame `out`, which holds
+        `outSize` bytes.  Bytes of the frame that no segment covers are left
+        unchanged.  Returns false and renders nothing if `colors` has fewer
+        than inputSize() colors or `outSize` is less than frameSize(). */
+    bool render(float level, CColorListRGB const& colors,
+                char* out, size_t outSize);
+
+    /** Forget the rounding errors remembered for dithering. */
+    void resetDither() { residual_.clear(); }
+
+    Isa isa() const { return isa_; }
+    void setIsa(Isa isa) { isa_ = supportedIsa(isa); }
+
+  private:
+    std::vector<Segment> segments_;
+
+    // Segments with the same Render3 share one kernel.
+    std::vector<Render3> renders_;
+    std::vector<RenderKernelData> kernels_;
+
+    // starts_[i] is the number of colors in all segments before segment i.
+    std::vector<size_t> starts_;
+
+    // The residuals for dithering, for all the segments' colors end to end.
+    std::vector<float> residual_;
+    bool dither_ = false;
+
+    size_t inputSize_ = 0, frameSize_ = 0, colorCount_ = 0;
+    Isa isa_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+
+inline bool sameRender3(Render3 const& x, Render3 const& y) {
+    return x.gamma == y.gamma and x.min == y.min and x.max == y.max and
+            x.permutation == y.permutation and x.output == y.output and
+            x.table == y.table;
+}
+
+inline CSegmentRenderer::CSegmentRenderer(Isa isa) : isa_(supportedIsa(isa)) {
+}
+
+inline bool CSegmentRenderer::add(
+        Render3 const& r, size_t begin, size_t end, size_t offset) {
+    if (begin > end)
+        return false;
+
+    auto bytes = bytesPerColor(r.output) * (end - begin);
+    for (auto& s: segments_) {
+        auto sBytes = kernels_[s.kernel].bytesPerColor() * (s.end - s.begin);
+        if (bytes and sBytes and offset < s.offset + sBytes and
+            s.offset < offset + bytes) {
+            return false;
+        }
+    }
+
+    size_t kernel = 0;
+    while (kernel < renders_.size() and not sameRender3(r, renders_[kernel]))
+        ++kernel;
+    if (kernel == renders_.size()) {
+        renders_.push_back(r);
+        kernels_.push_back(CRenderer::makeKernel(r));
+    }
+    dither_ = dither_ or r.output == Render3::Output::dither8;
+
+    segments_.push_back({begin, end, offset, kernel});
+    starts_.push_back(colorCount_);
+    colorCount_ += end - begin;
+    if (bytes) {
+        inputSize_ = std::max(inputSize_, end);
+        frameSize_ = std::max(frameSize_, offset + bytes);
+    }
+    return true;
+}
+
+inline void CSegmentRenderer::clear() {
+    segments_.clear();
+    renders_.clear();
+    kernels_.clear();
+    starts_.clear();
+    residual_.clear();
+    dither_ = false;
+    inputSize_ = frameSize_ = colorCount_ = 0;
+}
+
+inline bool CSegmentRenderer::render(float level, CColorListRGB const& colors,
+                                     char* out, size_t outSize) {
+    if (colors.size() < inputSize_ or outSize < frameSize_)
+        return false;
+    if (dither_ and residual_.size() != 3 * colorCount_)
+        resizeResidual(residual_, colorCount_);
+
+    // Chunks are taken from all the segments' colors laid end to end, so one
+    // long segment is split between threads as well as many short ones.
+    forChunks(colorCount_, sizeof(color::CColorRGB), [&](size_t b, size_t e) {
+        auto i = std::upper_bound(starts_.begin(), starts_.end(), b) - 1 -
+                starts_.begin();
+        for (; b < e; ++i) {
+            auto& s = segments_[i];
+            auto& kernel = kernels_[s.kernel];
+            auto skip = b - starts_[i];
+            auto count = std::min(e - b, s.end - s.begin - skip);
+            if (count) {
+                auto residual = dither_ ? residual_.data() + 3 * b : nullptr;
+                renderKernel(isa_, kernel, level,
+                             &*colors[s.begin + skip][0], count,
+                             out + s.offset + kernel.bytesPerColor() * skip,
+                             residual);
+            }
+            b += count;
+        }
+    });
+    return true;
+}
+
+}
+}
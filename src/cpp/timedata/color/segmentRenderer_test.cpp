@@ -0,0 +1,117 @@
+#pragma once
+
+#include <timedata/color/segmentRenderer.h>
+
+namespace timedata {
+namespace color_list {
+
+namespace {
+
+Render3 makeRender3(float gamma, Render3::Permutation permutation) {
+    Render3 r;
+    r.gamma = gamma;
+    r.permutation = permutation;
+    return r;
+}
+
+/** Render each segment on its own with a CRenderer, the slow way. */
+std::vector<char> renderSegments(
+        std::vector<std::pair<Render3, CSegmentRenderer::Segment>> const& segs,
+        CColorListRGB const& colors, size_t frameSize) {
+    std::vector<char> frame(frameSize, 'x');
+    for (auto& rs: segs) {
+        auto& s = rs.second;
+        CColorListRGB part(colors.begin() + s.begin, colors.begin() + s.end);
+        CRenderer(rs.first).render(1.0f, part, frame.data() + s.offset);
+    }
+    return frame;
+}
+
+} // namespace
+
+TEST_CASE("segmentRenderer matches separate renderers", "[renderer]") {
+    using P = Render3::Permutation;
+    auto rgb = makeRender3(1.0f, P::rgb), grb = makeRender3(2.5f, P::grb),
+        brg = makeRender3(2.0f, P::brg);
+
+    // Out of order, with gaps, an empty segment and a shared Render3.
+    std::vector<std::pair<Render3, CSegmentRenderer::Segment>> segs = {
+        {grb, {10, 40, 0, 0}},
+        {rgb, {0, 10, 93, 0}},
+        {brg, {40, 45, 150, 0}},
+        {rgb, {45, 45, 500, 0}},
+        {grb, {5, 50, 200, 0}},
+    };
+
+    auto colors = randomColors(50);
+    for (auto isa: {Isa::scalar, bestIsa()}) {
+        CSegmentRenderer renderer(isa);
+        for (auto& rs: segs) {
+            auto& s = rs.second;
+            REQUIRE(renderer.add(rs.first, s.begin, s.end, s.offset));
+        }
+        REQUIRE(renderer.size() == 5);
+        REQUIRE(renderer.segment(4).kernel == renderer.segment(0).kernel);
+        REQUIRE(renderer.inputSize() == 50);
+        REQUIRE(renderer.frameSize() == 335);
+
+        auto expected = renderSegments(segs, colors, 335);
+        for (auto threads: {1, 3}) {
+            withParallelism(threads, 0, [&]() {
+                std::vector<char> frame(335, 'x');
+                REQUIRE(renderer.render(1.0f, colors, frame.data(), 335));
+                REQUIRE(frame == expected);
+            });
+        }
+    }
+}
+
+TEST_CASE("segmentRenderer checks its segments", "[renderer]") {
+    CSegmentRenderer renderer;
+    Render3 r;
+    REQUIRE(renderer.add(r, 0, 10, 30));
+    REQUIRE(not renderer.add(r, 5, 4, 0));
+    REQUIRE(not renderer.add(r, 0, 1, 58));
+    REQUIRE(not renderer.add(r, 0, 20, 0));
+    REQUIRE(renderer.add(r, 0, 10, 0));
+    REQUIRE(renderer.add(r, 0, 0, 40));
+    REQUIRE(renderer.size() == 3);
+
+    auto colors = randomColors(10);
+    std::vector<char> frame(60);
+    REQUIRE(renderer.render(1.0f, colors, frame.data(), 60));
+    REQUIRE(not renderer.render(1.0f, colors, frame.data(), 59));
+
+    colors.pop_back();
+    REQUIRE(not renderer.render(1.0f, colors, frame.data(), 60));
+
+    renderer.clear();
+    REQUIRE(renderer.size() == 0);
+    REQUIRE(renderer.frameSize() == 0);
+    REQUIRE(renderer.render(1.0f, colors, nullptr, 0));
+}
+
+TEST_CASE("segmentRenderer outputs", "[renderer]") {
+    Render3 wide, dither;
+    wide.output = Render3::Output::bits16;
+    dither.output = Render3::Output::dither8;
+
+    CSegmentRenderer renderer;
+    REQUIRE(renderer.add(wide, 0, 10, 0));
+    REQUIRE(not renderer.add(dither, 0, 10, 57));
+    REQUIRE(renderer.add(dither, 10, 20, 60));
+    REQUIRE(renderer.frameSize() == 90);
+
+    auto colors = randomColors(20);
+    std::vector<char> frame(90);
+    for (size_t i = 0; i < 3; ++i)
+        REQUIRE(renderer.render(1.0f, colors, frame.data(), 90));
+
+    CRenderer single(wide);
+    CColorListRGB first(colors.begin(), colors.begin() + 10);
+    auto expected = render(single, Isa::scalar, 1.0f, first);
+    REQUIRE(std::vector<char>(frame.begin(), frame.begin() + 60) == expected);
+}
+
+} // color_list
+} // timedata
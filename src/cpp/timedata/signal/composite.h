@@ -0,0 +1,224 @@
+#pragma once
+
+#include <vector>
+
+#include <timedata/base/dirtyRanges.h>
+#include <timedata/signal/combiner.h>
+#include <timedata/signal/fade.h>
+
+namespace timedata {
+
+/** How a layer is blended onto the layers beneath it. */
+enum class Blend {add, multiply, screen, max, over, last = over};
+
+/** One layer of a composite.
+
+    Each component of the layer is scaled, offset, muted and inverted by the
+    layer's combiner exactly as Combiner::operator() would, then blended onto
+    the layers beneath it.  The blended value is mixed with the value beneath
+    in proportion to the layer's opacity. */
+struct Layer {
+    Combiner combiner = {1, 0, 0, 0};
+    Blend blend = Blend::over;
+    float opacity = 1;
+};
+
+/** Composite `count` lists of samples, bottom layer first, onto black and put
+    the result into `out`.  `out` is resized to the shortest of the lists and
+    may be any of them.  With no lists at all, `out` is cleared.
+
+    All the layers are composited in one pass over the lists.  Each layer's
+    combiner is turned into vectors of coefficients once per call, so the inner
+    loops don't branch and vectorize.  Apart from that small table of
+    coefficients, this only allocates if `out` has to grow. */
+template <typename List>
+void compositeOver(Layer const* layers, List const* const* inputs,
+                   size_t count, List& out);
+
+/** Like compositeOver, but only composite the samples in `dirty`, which must
+    hold every sample that has changed in any input since `out` was last
+    composited from the same layers.  If `out` is not already the size of the
+    composite, every sample is composited.
+
+    Returns the ranges of samples that were composited, which can be passed on
+    to CRenderer::renderDirty(). */
+template <typename List>
+DirtyRanges compositeDirty(Layer const* layers, List const* const* inputs,
+                           size_t count, DirtyRanges const& dirty, List& out);
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+
+/** Coefficients repeat every COMPOSITE_PERIOD floats, which is a whole number
+    of both samples and SIMD vectors. */
+static size_t const COMPOSITE_PERIOD = 24;
+
+/** Layers are composited onto a block of this many floats on the stack. */
+static size_t const COMPOSITE_BLOCK_SIZE = 32 * COMPOSITE_PERIOD;
+
+namespace detail {
+
+struct LayerCoefficients {
+    // Component j is x * scale[j] + offset[j], and then becomes sign[j] * x +
+    // invert[j] * signum(x), which is timedata::invert(x) if invert[j] is 1.
+    float scale[COMPOSITE_PERIOD], offset[COMPOSITE_PERIOD];
+    float sign[COMPOSITE_PERIOD], invert[COMPOSITE_PERIOD];
+    float opacity, keep;
+    Blend blend;
+
+    LayerCoefficients(Layer const& layer, size_t sampleSize) {
+        auto& c = layer.combiner;
+        for (size_t j = 0; j < COMPOSITE_PERIOD; ++j) {
+            auto flag = 1u << (j % sampleSize);
+            auto muted = bool(c.mute & flag);
+            auto inverted = not muted and (c.invert & flag);
+            scale[j] = muted ? 0 : c.scale;
+            offset[j] = muted ? 0 : c.offset;
+            sign[j] = inverted ? -1 : 1;
+            invert[j] = inverted ? 1 : 0;
+        }
+        opacity = layer.opacity;
+        keep = 1 - layer.opacity;
+        blend = layer.blend;
+    }
+};
+
+struct BlendAdd {
+    static float blend(float x, float y) { return x + y; }
+};
+
+struct BlendMultiply {
+    static float blend(float x, float y) { return x * y; }
+};
+
+struct BlendScreen {
+    static float blend(float x, float y) { return x + y - x * y; }
+};
+
+struct BlendMax {
+    static float blend(float x, float y) { return std::max(x, y); }
+};
+
+struct BlendOver {
+    static float blend(float, float y) { return y; }
+};
+
+template <typename Mode>
+inline void compositeSpan(LayerCoefficients const& c, float const* in,
+                          float* acc, size_t size) {
+    for (size_t j = 0; j < size; ++j) {
+        auto y = in[j] * c.scale[j] + c.offset[j];
+        y = c.sign[j] * y + c.invert[j] * (float(y >= 0) * 2 - 1);
+        acc[j] = acc[j] * c.keep + Mode::blend(acc[j], y) * c.opacity;
+    }
+}
+
+template <typename Mode>
+void compositeLayer(LayerCoefficients const& c, float const* in, float* acc,
+                    size_t size) {
+    size_t i = 0;
+    for (; i + COMPOSITE_PERIOD <= size; i += COMPOSITE_PERIOD)
+        compositeSpan<Mode>(c, in + i, acc + i, COMPOSITE_PERIOD);
+    compositeSpan<Mode>(c, in + i, acc + i, size - i);
+}
+
+inline void compositeLayer(LayerCoefficients const& c, float const* in,
+                           float* acc, size_t size) {
+    switch (c.blend) {
+        case Blend::add:
+            return compositeLayer<BlendAdd>(c, in, acc, size);
+        case Blend::multiply:
+            return compositeLayer<BlendMultiply>(c, in, acc, size);
+        case Blend::screen:
+            return compositeLayer<BlendScreen>(c, in, acc, size);
+        case Blend::max:
+            return compositeLayer<BlendMax>(c, in, acc, size);
+        case Blend::over:
+            return compositeLayer<BlendOver>(c, in, acc, size);
+    }
+}
+
+} // detail
+
+namespace detail {
+
+template <typename List>
+size_t compositeSize(List const* const* inputs, size_t count) {
+    auto size = count ? inputs[0]->size() : 0;
+    for (size_t k = 1; k < count; ++k)
+        size = std::min(size, inputs[k]->size());
+    return size;
+}
+
+/** Composite the samples of the inputs in each range into `out`. */
+template <typename List>
+void compositeRanges(Layer const* layers, List const* const* inputs,
+                      size_t count, DirtyRanges const& ranges, List& out) {
+    using Sample = typename List::value_type;
+    static_assert(COMPOSITE_PERIOD % Sample::SIZE == 0,
+                  "Coefficients must repeat on sample boundaries");
+
+    // componentData() can't point into an empty list.
+    if (out.empty())
+        return;
+
+    std::vector<LayerCoefficients> coefficients;
+    coefficients.reserve(count);
+    for (size_t k = 0; k < count; ++k)
+        coefficients.emplace_back(layers[k], size_t(Sample::SIZE));
+
+    // Chunks and blocks start on sample boundaries, so that the coefficients
+    // line up with the components.
+    auto o = componentData(out);
+    auto c = coefficients.data();
+    for (auto& range: ranges.ranges()) {
+        auto offset = range.first;
+        forChunks(range.second - offset, sizeof(Sample),
+                  [=](size_t begin, size_t end) {
+            float block[COMPOSITE_BLOCK_SIZE];
+            end = (offset + end) * Sample::SIZE;
+            for (auto i = (offset + begin) * Sample::SIZE; i < end;
+                 i += COMPOSITE_BLOCK_SIZE) {
+                auto m = std::min(COMPOSITE_BLOCK_SIZE, end - i);
+                std::fill(block, block + m, 0.0f);
+                for (size_t k = 0; k < count; ++k)
+                    compositeLayer(c[k], componentData(*inputs[k]) + i,
+                                   block, m);
+                std::copy(block, block + m, o + i);
+            }
+        });
+    }
+}
+
+} // detail
+
+template <typename List>
+void compositeOver(Layer const* layers, List const* const* inputs,
+                   size_t count, List& out) {
+    auto size = detail::compositeSize(inputs, count);
+    out.resize(size);
+
+    DirtyRanges all;
+    all.add(0, size);
+    detail::compositeRanges(layers, inputs, count, all, out);
+}
+
+template <typename List>
+DirtyRanges compositeDirty(Layer const* layers, List const* const* inputs,
+                           size_t count, DirtyRanges const& dirty, List& out) {
+    auto size = detail::compositeSize(inputs, count);
+    DirtyRanges ranges;
+    if (out.size() == size) {
+        ranges = dirty;
+        ranges.truncate(size);
+    } else {
+        out.resize(size);
+        ranges.add(0, size);
+    }
+    detail::compositeRanges(layers, inputs, count, ranges, out);
+    return ranges;
+}
+
+} // timedata
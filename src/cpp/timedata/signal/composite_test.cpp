@@ -0,0 +1,141 @@
+#pragma once
+
+#include <timedata/signal/composite.h>
+
+namespace timedata {
+namespace color_list {
+
+namespace {
+
+float blendComponent(Blend blend, float x, float y) {
+    switch (blend) {
+        case Blend::add: return x + y;
+        case Blend::multiply: return x * y;
+        case Blend::screen: return x + y - x * y;
+        case Blend::max: return std::max(x, y);
+        case Blend::over: return y;
+    }
+    return 0;
+}
+
+/** Composite one sample at a time with Combiner::operator(). */
+CColorListRGB compositeSamples(std::vector<Layer> const& layers,
+                               std::vector<CColorListRGB const*> inputs) {
+    auto size = inputs[0]->size();
+    for (auto i: inputs)
+        size = std::min(size, i->size());
+
+    CColorListRGB out(size);
+    for (size_t i = 0; i < size; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            float x = 0;
+            for (size_t k = 0; k < layers.size(); ++k) {
+                auto& layer = layers[k];
+                auto y = layer.combiner(*(*inputs[k])[i][j], uint(j));
+                x = x * (1 - layer.opacity) +
+                        blendComponent(layer.blend, x, y) * layer.opacity;
+            }
+            out[i][j] = x;
+        }
+    }
+    return out;
+}
+
+Layer makeLayer(Blend blend, float opacity, float scale, float offset,
+                uint mute, uint invert) {
+    Layer layer;
+    layer.blend = blend;
+    layer.opacity = opacity;
+    layer.combiner = {scale, offset, mute, invert};
+    return layer;
+}
+
+} // namespace
+
+TEST_CASE("compositeOver", "[composite]") {
+    using B = Blend;
+    std::vector<Layer> layers = {
+        makeLayer(B::over, 1, 1, 0, 0, 0),
+        makeLayer(B::add, 0.5f, 2, -0.5f, 2, 0),
+        makeLayer(B::multiply, 1, 1, 0.25f, 0, 5),
+        makeLayer(B::screen, 0.75f, -1, 0, 1, 3),
+        makeLayer(B::max, 1, 0.5f, 0, 0, 7),
+        makeLayer(B::over, 0.25f, 3, 0.1f, 4, 4),
+    };
+    auto a = randomColors(1000), b = randomColors(950), c = randomColors(990);
+    auto d = randomColors(1001), e = randomColors(1000), f = randomColors(999);
+    std::vector<CColorListRGB const*> inputs = {&a, &b, &c, &d, &e, &f};
+
+    auto expected = compositeSamples(layers, inputs);
+    CColorListRGB out;
+    compositeOver(layers.data(), inputs.data(), layers.size(), out);
+    REQUIRE(out.size() == 950);
+    REQUIRE(out == expected);
+
+    // A single opaque layer is just the combiner.
+    for (size_t k = 1; k <= layers.size(); ++k) {
+        expected = compositeSamples({layers.begin(), layers.begin() + k},
+                                    {inputs.begin(), inputs.begin() + k});
+        compositeOver(layers.data(), inputs.data(), k, out);
+        REQUIRE(out == expected);
+    }
+
+    // Compositing into one of the inputs, in parallel.
+    expected = compositeSamples(layers, inputs);
+    withParallelism(3, 0, [&]() {
+        compositeOver(layers.data(), inputs.data(), layers.size(), c);
+    });
+    REQUIRE(c == expected);
+
+    compositeOver(layers.data(), inputs.data(), 0, out);
+    REQUIRE(out.empty());
+
+    // An empty input makes the composite empty.
+    CColorListRGB empty;
+    inputs[2] = &empty;
+    compositeOver(layers.data(), inputs.data(), layers.size(), out);
+    REQUIRE(out.empty());
+    DirtyRanges dirty;
+    dirty.add(0, 10);
+    REQUIRE(compositeDirty(layers.data(), inputs.data(), layers.size(), dirty,
+                           out).count() == 0);
+    REQUIRE(out.empty());
+}
+
+// Only the dirty samples are composited, once `out` has the size of the
+// composite.
+TEST_CASE("compositeDirty", "[composite]") {
+    std::vector<Layer> layers(2);
+    layers[1].blend = Blend::add;
+    layers[1].opacity = 0.5f;
+    auto a = randomColors(2000), b = randomColors(2100);
+    std::vector<CColorListRGB const*> inputs = {&a, &b};
+
+    // At first, everything is composited.
+    CColorListRGB out, expected;
+    DirtyRanges dirty;
+    dirty.add(10, 20);
+    REQUIRE(compositeDirty(layers.data(), inputs.data(), 2, dirty, out)
+            .count() == 2000);
+    compositeOver(layers.data(), inputs.data(), 2, expected);
+    REQUIRE(out == expected);
+
+    for (size_t i = 10; i < 20; ++i)
+        a[i] = b[i + 1000] = {0.5f, 0.5f, 0.5f};
+    for (size_t i = 1000; i < 1500; ++i)
+        b[i] = {0.25f, 0.0f, 1.0f};
+    dirty.add(1000, 1500);
+
+    // Samples that aren't dirty are left alone, even if they are wrong.
+    out[500] = {2.0f, 2.0f, 2.0f};
+    withParallelism(3, 0, [&]() {
+        auto done = compositeDirty(layers.data(), inputs.data(), 2, dirty, out);
+        REQUIRE(done.ranges() == dirty.ranges());
+    });
+    compositeOver(layers.data(), inputs.data(), 2, expected);
+    expected[500] = {2.0f, 2.0f, 2.0f};
+    REQUIRE(out == expected);
+}
+
+} // color_list
+} // timedata
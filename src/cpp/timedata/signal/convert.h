@@ -15,6 +15,12 @@ namespace converter {
 template <typename Sample>
 std::string loadConverter();
 
+/** Loads a converter like loadConverter, returning a small integer ID for the
+    sample type instead.  Converting by ID is a lookup in a dense table rather
+    than a search by name. */
+template <typename Sample>
+size_t converterId();
+
 
 /** PointerAsInt is just a mnemonic typedef to indicate that the integer
     in question is actually some pointer, encoded.
@@ -65,8 +71,54 @@ void convertSample(Sample1 const& in, Sample2& out);
     maps onto every part of every other one...
 */
 template <typename T>
-bool convertSampleCython(
-    PointerAsInt inPtr, std::string const& inputModel, T& out);
+bool convertSampleCython(PointerAsInt inPtr, size_t inputModelId, T& out);
+
+/** Lists are converted a tile at a time.  A tile holds the components of up to
+    CONVERT_TILE_SIZE samples in the normal range [0, 1], stored as planes like
+    a Planar list, so the loops that convert them are over contiguous floats
+    and vectorize well. */
+static size_t const CONVERT_TILE_SIZE = 256;
+
+struct ConvertTile {
+    float planes[3][CONVERT_TILE_SIZE];
+};
+
+/** Convert the first `n` samples of a tile from one model to another, in
+    place.  The default converts one sample at a time with convertSample, so a
+    model only needs to specialize this for speed. */
+template <typename ModelIn, typename ModelOut>
+void convertPlanes(ConvertTile&, size_t n);
+
+/** Converts a whole list of samples to another model or range, resizing `out`
+    to match `in`.  This goes through the normal model a tile at a time,
+    without allocating anything for each sample, and gives the same results as
+    calling convertSample on each sample. */
+template <typename ListIn, typename ListOut>
+void convertList(ListIn const& in, ListOut& out);
+
+/** Converts a list from Python, like convertSampleCython.  `inPtr` points to
+    a std::vector of samples of the model with ID `inputModelId`. */
+template <typename T>
+bool convertListCython(PointerAsInt inPtr, size_t inputModelId, T& out);
+
+/** Multiply the samples in a tile by a matrix, like matrixMultiply. */
+template <typename Matrix>
+void multiplyPlanes(Matrix const& matrix, ConvertTile& tile, size_t n) {
+    // Copy the matrix so the compiler knows that it can't change in the loop.
+    float m[3][3];
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 3; ++j)
+            m[i][j] = matrix[i][j];
+    }
+
+    auto x = tile.planes[0], y = tile.planes[1], z = tile.planes[2];
+    for (size_t i = 0; i < n; ++i) {
+        auto a = x[i], b = y[i], c = z[i];
+        x[i] = m[0][0] * a + m[0][1] * b + m[0][2] * c;
+        y[i] = m[1][0] * a + m[1][1] * b + m[1][2] * c;
+        z[i] = m[2][0] * a + m[2][1] * b + m[2][2] * c;
+    }
+}
 
 } // converter
 } // timedata
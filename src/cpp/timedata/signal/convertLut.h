@@ -0,0 +1,322 @@
+#pragma once
+
+#include <cmath>
+
+#include <timedata/signal/convert_inl.h>
+
+namespace timedata {
+namespace converter {
+
+/** A ConvertLut converts lists of samples from one model to another by
+    interpolating in a precomputed three dimensional table, which is faster
+    than convertList for models with complicated conversions like HSV or HSL,
+    at the cost of a little accuracy.
+
+    The table samples the conversion at `gridSize` evenly spaced points along
+    each component of the input in the range [0, 1] after unscaling, so inputs
+    outside that range are clamped to it.  The conversion is exact at the grid
+    points, and conversions that are linear, like RGB to XYZ, are exact
+    everywhere.
+
+    Interpolation is tetrahedral by default, which only reads four of the
+    eight corners of each cube of the grid.  Trilinear interpolation reads all
+    eight and is slower, but it is exact for conversions that are linear in
+    each component separately.  HSV and HSL to RGB are like that between the
+    six corners of the hue hexagon, so with a grid size of 6k + 1, like 25 or
+    49, trilinear interpolation is exact for them, and tetrahedral
+    interpolation is much more accurate than with other sizes.
+
+    Conversions with discontinuities, like RGB to HSV where the hue jumps
+    from 1 back to 0 at red, or is undefined for grays, interpolate badly near
+    the discontinuity, so don't use a ConvertLut for them.
+*/
+enum class LutInterpolation {tetrahedral, trilinear};
+
+static size_t const DEFAULT_LUT_GRID_SIZE = 25;
+static size_t const MAX_LUT_GRID_SIZE = 129;
+
+template <typename In, typename Out>
+class ConvertLut {
+  public:
+    /** `gridSize` is clamped to [2, MAX_LUT_GRID_SIZE]. */
+    explicit ConvertLut(
+        size_t gridSize = DEFAULT_LUT_GRID_SIZE,
+        LutInterpolation = LutInterpolation::tetrahedral);
+
+    size_t gridSize() const { return gridSize_; }
+    LutInterpolation interpolation() const { return interpolation_; }
+
+    /** Convert `size` samples from `in` to `out`, which may not overlap. */
+    void convert(In const* in, size_t size, Out* out) const;
+
+    /** Convert a whole list, resizing `out` to match `in`, like
+        convertList. */
+    template <typename ListIn, typename ListOut>
+    void convert(ListIn const& in, ListOut& out) const;
+
+    /** Interpolate the first `n` samples of a tile in place. */
+    void interpolate(ConvertTile&, size_t n) const;
+
+    /** The instruction set used for tetrahedral interpolation. */
+    Isa isa() const { return isa_; }
+
+    /** Select the instruction set for tetrahedral interpolation.  If the CPU
+        doesn't support `isa`, the best one that it does support is used
+        instead. */
+    void setIsa(Isa isa) { isa_ = supportedIsa(isa); }
+
+  private:
+    void tetrahedral(ConvertTile&, size_t n) const;
+    void trilinear(ConvertTile&, size_t n) const;
+
+    size_t gridSize_;
+    LutInterpolation interpolation_;
+    Isa isa_ = bestIsa();
+
+    // The output components of each grid point, padded to four floats so
+    // that one load reads a whole point.  Point (x, y, z) starts at
+    // 4 * ((x * gridSize_ + y) * gridSize_ + z).
+    std::vector<float> table_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+
+template <typename In, typename Out>
+ConvertLut<In, Out>::ConvertLut(size_t gridSize, LutInterpolation interp)
+        : gridSize_(std::max(size_t(2), std::min(gridSize, MAX_LUT_GRID_SIZE))),
+          interpolation_(interp) {
+    using RangeIn = typename In::range_type;
+    using RangeOut = typename Out::range_type;
+
+    // The last grid point is just below 1 so that components that wrap
+    // around at 1, like hue, take their values from the left.
+    auto n = gridSize_, size = n * n * n;
+    std::vector<float> points(n);
+    for (size_t i = 0; i < n; ++i)
+        points[i] = static_cast<float>(i) / (n - 1);
+    points.back() = std::nextafter(1.0f, 0.0f);
+
+    std::vector<In> in(size);
+    for (size_t i = 0; i < size; ++i) {
+        *in[i][0] = scale<RangeIn>(points[i / (n * n)]);
+        *in[i][1] = scale<RangeIn>(points[i / n % n]);
+        *in[i][2] = scale<RangeIn>(points[i % n]);
+    }
+
+    std::vector<Out> out;
+    convertList(in, out);
+    table_.resize(4 * size);
+    for (size_t i = 0; i < size; ++i) {
+        for (size_t j = 0; j < 3; ++j)
+            table_[4 * i + j] = unscale<RangeOut>(*out[i][j]);
+    }
+}
+
+template <typename In, typename Out>
+void ConvertLut<In, Out>::convert(In const* in, size_t size, Out* out) const {
+    forChunks(size, sizeof(Out), [=](size_t begin, size_t end) {
+        ConvertTile tile;
+        for (auto i = begin; i < end; i += CONVERT_TILE_SIZE) {
+            auto n = std::min(CONVERT_TILE_SIZE, end - i);
+            loadTile(in + i, n, tile, false);
+            interpolate(tile, n);
+            storeTile(tile, n, out + i, false);
+        }
+    });
+}
+
+template <typename In, typename Out>
+template <typename ListIn, typename ListOut>
+void ConvertLut<In, Out>::convert(ListIn const& in, ListOut& out) const {
+    out.resize(in.size());
+    if (not in.empty())
+        convert(in.data(), in.size(), out.data());
+}
+
+template <typename In, typename Out>
+void ConvertLut<In, Out>::interpolate(ConvertTile& tile, size_t n) const {
+    if (interpolation_ == LutInterpolation::trilinear)
+        trilinear(tile, n);
+    else
+        tetrahedral(tile, n);
+}
+
+/** Split a component into the index of its cell in the grid and the
+    fractional position in that cell. */
+inline uint32_t lutCell(float x, float last, float& fraction) {
+    // This also sends NaN to 0.
+    x = x > 0.0f ? (x < 1.0f ? x * last : last) : 0.0f;
+    auto index = static_cast<uint32_t>(std::min(x, last - 1.0f));
+    fraction = x - index;
+    return index;
+}
+
+#if TIMEDATA_X86_DISPATCH
+
+/** Interpolate the samples of a tile four at a time, returning how many were
+    interpolated.  This does the same arithmetic, in the same order, as the
+    scalar loop. */
+__attribute__((target("sse2")))
+inline size_t lutTetrahedralSse2(
+        float const* table, size_t gridSize, ConvertTile& tile, size_t n) {
+    auto zero = _mm_setzero_ps();
+    auto last = _mm_set1_ps(static_cast<float>(gridSize - 1));
+    auto lastCell = _mm_set1_ps(static_cast<float>(gridSize - 2));
+    auto strideX = static_cast<int>(4 * gridSize * gridSize);
+    auto strideY = static_cast<int>(4 * gridSize);
+    auto sx = _mm_set1_epi32(strideX), sy = _mm_set1_epi32(strideY);
+    auto sz = _mm_set1_epi32(4);
+    auto all = _mm_set1_epi32(-1);
+    auto x = tile.planes[0], y = tile.planes[1], z = tile.planes[2];
+
+    // The table index of each cell fits exactly in a float.
+    auto cell = [&](__m128 v, __m128& fraction) {
+        v = _mm_min_ps(_mm_max_ps(_mm_mul_ps(v, last), zero), last);
+        auto index = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_min_ps(v, lastCell)));
+        fraction = _mm_sub_ps(v, index);
+        return index;
+    };
+
+    alignas(16) int32_t corners[4][4];
+    alignas(16) float weights[3][4];
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 fx, fy, fz;
+        auto ix = cell(_mm_loadu_ps(x + i), fx);
+        auto iy = cell(_mm_loadu_ps(y + i), fy);
+        auto iz = cell(_mm_loadu_ps(z + i), fz);
+        auto c0 = _mm_cvttps_epi32(_mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(ix, _mm_set1_ps(strideX)),
+                       _mm_mul_ps(iy, _mm_set1_ps(strideY))),
+            _mm_mul_ps(iz, _mm_set1_ps(4.0f))));
+
+        auto xy = _mm_castps_si128(_mm_cmpge_ps(fx, fy));
+        auto xz = _mm_castps_si128(_mm_cmpge_ps(fx, fz));
+        auto yz = _mm_castps_si128(_mm_cmpge_ps(fy, fz));
+        auto xMax = _mm_and_si128(xy, xz);
+        auto yMax = _mm_andnot_si128(xy, yz);
+        auto zMax = _mm_andnot_si128(_mm_or_si128(xMax, yMax), all);
+        auto xMin = _mm_andnot_si128(_mm_or_si128(xy, xz), all);
+        auto yMin = _mm_andnot_si128(yz, xy);
+        auto zMin = _mm_andnot_si128(_mm_or_si128(xMin, yMin), all);
+
+        auto first = _mm_or_si128(
+            _mm_or_si128(_mm_and_si128(xMax, sx), _mm_and_si128(yMax, sy)),
+            _mm_and_si128(zMax, sz));
+        auto smallest = _mm_or_si128(
+            _mm_or_si128(_mm_and_si128(xMin, sx), _mm_and_si128(yMin, sy)),
+            _mm_and_si128(zMin, sz));
+        auto c3 = _mm_add_epi32(
+            c0, _mm_add_epi32(_mm_add_epi32(sx, sy), sz));
+        _mm_store_si128(reinterpret_cast<__m128i*>(corners[0]), c0);
+        _mm_store_si128(reinterpret_cast<__m128i*>(corners[1]),
+                        _mm_add_epi32(c0, first));
+        _mm_store_si128(reinterpret_cast<__m128i*>(corners[2]),
+                        _mm_sub_epi32(c3, smallest));
+        _mm_store_si128(reinterpret_cast<__m128i*>(corners[3]), c3);
+
+        auto f1 = _mm_max_ps(fz, _mm_max_ps(fy, fx));
+        auto f3 = _mm_min_ps(fz, _mm_min_ps(fy, fx));
+        auto f2 = _mm_sub_ps(
+            _mm_sub_ps(_mm_add_ps(_mm_add_ps(fx, fy), fz), f1), f3);
+        _mm_store_ps(weights[0], f1);
+        _mm_store_ps(weights[1], f2);
+        _mm_store_ps(weights[2], f3);
+
+        // Each corner holds all the components of one grid point.
+        __m128 out[4];
+        for (size_t k = 0; k < 4; ++k) {
+            auto t0 = _mm_loadu_ps(table + corners[0][k]);
+            auto t1 = _mm_loadu_ps(table + corners[1][k]);
+            auto t2 = _mm_loadu_ps(table + corners[2][k]);
+            auto t3 = _mm_loadu_ps(table + corners[3][k]);
+            auto r = _mm_add_ps(t0, _mm_mul_ps(_mm_set1_ps(weights[0][k]),
+                                               _mm_sub_ps(t1, t0)));
+            r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(weights[1][k]),
+                                         _mm_sub_ps(t2, t1)));
+            out[k] = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(weights[2][k]),
+                                              _mm_sub_ps(t3, t2)));
+        }
+        _MM_TRANSPOSE4_PS(out[0], out[1], out[2], out[3]);
+        _mm_storeu_ps(x + i, out[0]);
+        _mm_storeu_ps(y + i, out[1]);
+        _mm_storeu_ps(z + i, out[2]);
+    }
+    return i;
+}
+
+#endif
+
+template <typename In, typename Out>
+void ConvertLut<In, Out>::tetrahedral(ConvertTile& tile, size_t n) const {
+    auto t = table_.data();
+    size_t i = 0;
+#if TIMEDATA_X86_DISPATCH
+    if (isa_ != Isa::scalar)
+        i = lutTetrahedralSse2(t, gridSize_, tile, n);
+#endif
+
+    auto last = static_cast<float>(gridSize_ - 1);
+    auto sx = static_cast<uint32_t>(4 * gridSize_ * gridSize_);
+    auto sy = static_cast<uint32_t>(4 * gridSize_), sz = 4u;
+    auto x = tile.planes[0], y = tile.planes[1], z = tile.planes[2];
+
+    for (; i < n; ++i) {
+        float fx, fy, fz;
+        auto c0 = lutCell(x[i], last, fx) * sx + lutCell(y[i], last, fy) * sy +
+                lutCell(z[i], last, fz) * sz;
+
+        // The tetrahedron goes from the cell's first corner along the axis with
+        // the largest fraction, then along the middle one, then the smallest,
+        // to the opposite corner.  This is written without branches, which
+        // random colors would mispredict half the time.
+        uint32_t xy = fx >= fy, xz = fx >= fz, yz = fy >= fz;
+        auto xMax = xy & xz, yMax = (1 - xy) & yz, zMax = 1 - xMax - yMax;
+        auto xMin = (1 - xy) & (1 - xz), yMin = xy & (1 - yz);
+        auto zMin = 1 - xMin - yMin;
+        auto c1 = c0 + xMax * sx + yMax * sy + zMax * sz;
+        auto c3 = c0 + sx + sy + sz;
+        auto c2 = c3 - (xMin * sx + yMin * sy + zMin * sz);
+
+        auto f1 = std::max(fz, std::max(fy, fx));
+        auto f3 = std::min(fz, std::min(fy, fx));
+        auto f2 = fx + fy + fz - f1 - f3;
+
+        for (size_t j = 0; j < 3; ++j) {
+            auto t0 = t[c0 + j], t1 = t[c1 + j], t2 = t[c2 + j];
+            auto t3 = t[c3 + j];
+            tile.planes[j][i] =
+                    t0 + f1 * (t1 - t0) + f2 * (t2 - t1) + f3 * (t3 - t2);
+        }
+    }
+}
+
+template <typename In, typename Out>
+void ConvertLut<In, Out>::trilinear(ConvertTile& tile, size_t n) const {
+    auto last = static_cast<float>(gridSize_ - 1);
+    auto sx = static_cast<uint32_t>(4 * gridSize_ * gridSize_);
+    auto sy = static_cast<uint32_t>(4 * gridSize_), sz = 4u;
+    auto x = tile.planes[0], y = tile.planes[1], z = tile.planes[2];
+    auto lerp = [](float a, float b, float f) { return a + f * (b - a); };
+
+    for (size_t i = 0; i < n; ++i) {
+        float fx, fy, fz;
+        auto c = lutCell(x[i], last, fx) * sx + lutCell(y[i], last, fy) * sy +
+                lutCell(z[i], last, fz) * sz;
+        for (size_t j = 0; j < 3; ++j) {
+            auto t = table_.data() + c + j;
+            auto y0 = lerp(lerp(t[0], t[sz], fz),
+                           lerp(t[sy], t[sy + sz], fz), fy);
+            auto y1 = lerp(lerp(t[sx], t[sx + sz], fz),
+                           lerp(t[sx + sy], t[sx + sy + sz], fz), fy);
+            tile.planes[j][i] = lerp(y0, y1, fx);
+        }
+    }
+}
+
+} // converter
+} // timedata
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+#include <timedata/base/nearlyEqual_test.h>
+#include <timedata/signal/convertLut.h>
+
+namespace timedata {
+namespace converter {
+
+namespace {
+
+/** The largest difference between any component of two lists, unscaled. */
+template <typename Sample>
+float lutError(std::vector<Sample> const& x, std::vector<Sample> const& y) {
+    using Range = typename Sample::range_type;
+    float error = 0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        for (size_t j = 0; j < Sample::SIZE; ++j) {
+            auto d = unscale<Range>(*x[i][j]) - unscale<Range>(*y[i][j]);
+            error = std::max(error, std::abs(d));
+        }
+    }
+    return error;
+}
+
+template <typename In, typename Out>
+float testLutError(size_t gridSize, LutInterpolation interp, size_t size) {
+    // A ConvertLut clamps out-of-band components, and convertList doesn't.
+    auto in = testSamples<In>(size, 0.0f, 1.0f);
+    std::vector<Out> expected, out;
+    convertList(in, expected);
+    ConvertLut<In, Out>(gridSize, interp).convert(in, out);
+    REQUIRE(out.size() == size);
+    return lutError(out, expected);
+}
+
+template <typename Function>
+double lutSeconds(Function f) {
+    // The best of a few runs.
+    auto best = 1e10;
+    for (auto i = 0; i < 5; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double> d = std::chrono::steady_clock::now() -
+                start;
+        best = std::min(best, d.count());
+    }
+    return best;
+}
+
+template <typename In, typename Out>
+void reportLut(char const* name) {
+    auto in = testSamples<In>(100000, 0.0f, 1.0f);
+    std::vector<Out> expected, out;
+    auto exact = lutSeconds([&]() { convertList(in, expected); });
+    printf("%s: convertList %.0f us\n", name, 1e6 * exact);
+
+    for (auto interp: {LutInterpolation::tetrahedral,
+                       LutInterpolation::trilinear}) {
+        for (auto gridSize: {17, 25, 33, 49, 65}) {
+            ConvertLut<In, Out> lut(gridSize, interp);
+            auto time = lutSeconds([&]() { lut.convert(in, out); });
+            printf("  %-11s %2d^3: max error %.2e, %5.0f us, %.2fx\n",
+                   interp == LutInterpolation::trilinear ?
+                   "trilinear" : "tetrahedral",
+                   gridSize, lutError(out, expected), 1e6 * time,
+                   exact / time);
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("convertLut is exact for linear conversions", "[convertLut]") {
+    for (auto interp: {LutInterpolation::tetrahedral,
+                       LutInterpolation::trilinear}) {
+        auto size = 1000;
+        REQUIRE((testLutError<ColorRGB, ColorXYZ>(5, interp, size)) < 1e-5f);
+        REQUIRE((testLutError<ColorYIQ, ColorRGB255>(2, interp, size)) < 1e-5f);
+        REQUIRE((testLutError<ColorRGB255, ColorRGB>(9, interp, size)) < 1e-5f);
+    }
+}
+
+TEST_CASE("convertLut accuracy", "[convertLut]") {
+    auto tet = LutInterpolation::tetrahedral, tri = LutInterpolation::trilinear;
+    auto size = 5000;
+
+    // Grids of 6k + 1 points have a point at each corner of the hue hexagon.
+    REQUIRE((testLutError<ColorHSV, ColorRGB>(17, tet, size)) < 0.1f);
+    REQUIRE((testLutError<ColorHSV, ColorRGB>(25, tet, size)) < 0.01f);
+    REQUIRE((testLutError<ColorHSV, ColorRGB>(49, tet, size)) < 0.003f);
+    REQUIRE((testLutError<ColorHSV, ColorRGB>(25, tri, size)) < 1e-5f);
+
+    REQUIRE((testLutError<ColorHSL, ColorRGB>(17, tet, size)) < 0.1f);
+    REQUIRE((testLutError<ColorHSL, ColorRGB>(25, tet, size)) < 0.01f);
+    REQUIRE((testLutError<ColorHSL, ColorRGB>(49, tet, size)) < 0.003f);
+    REQUIRE((testLutError<ColorHSL, ColorRGB255>(25, tri, size)) < 1e-5f);
+}
+
+TEST_CASE("convertLut grid points and clamping", "[convertLut]") {
+    ConvertLut<ColorHSV, ColorRGB> lut(5);
+    REQUIRE(lut.gridSize() == 5);
+    using Lut = ConvertLut<ColorHSV, ColorRGB>;
+    REQUIRE(Lut(0).gridSize() == 2);
+    REQUIRE(Lut(1000).gridSize() == MAX_LUT_GRID_SIZE);
+
+    std::vector<ColorHSV> in = {
+        {0.25f, 0.5f, 0.75f}, {0.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f},
+        {-1.0f, 2.0f, 1.5f}};
+    std::vector<ColorRGB> expected, out;
+    convertList(in, expected);
+    lut.convert(in, out);
+    for (size_t j = 0; j < 3; ++j) {
+        REQUIRE(nearlyEqual(*out[0][j], *expected[0][j]));
+        REQUIRE(nearlyEqual(*out[1][j], *expected[1][j]));
+
+        // Hue wraps around to red at 1.
+        REQUIRE(nearlyEqual(*out[2][j], *expected[1][j]));
+    }
+    REQUIRE(out[3] == out[1]);
+
+    lut.convert(std::vector<ColorHSV>(), out);
+    REQUIRE(out.empty());
+}
+
+TEST_CASE("convertLut SSE2 matches scalar", "[convertLut]") {
+    // Out-of-band and NaN components are clamped the same way, and 1003 leaves
+    // a few samples over for the scalar loop after the SSE2 one.
+    auto in = testSamples<ColorHSV>(1003);
+    *in[5][1] = std::numeric_limits<float>::quiet_NaN();
+    ConvertLut<ColorHSV, ColorRGB> lut;
+    std::vector<ColorRGB> expected, out;
+    lut.setIsa(Isa::scalar);
+    REQUIRE(lut.isa() == Isa::scalar);
+    lut.convert(in, expected);
+    lut.setIsa(Isa::sse2);
+    lut.convert(in, out);
+    REQUIRE(nearlyEqualLists(out, expected));
+}
+
+TEST_CASE("convertLut in parallel", "[convertLut]") {
+    auto in = testSamples<ColorHSL>(2000, 0.0f, 1.0f);
+    ConvertLut<ColorHSL, ColorRGB256> lut;
+    std::vector<ColorRGB256> expected, out;
+    lut.convert(in, expected);
+    withParallelism(3, 0, [&]() { lut.convert(in, out); });
+    REQUIRE(out == expected);
+}
+
+// Run with `build/tests [report]`.
+TEST_CASE("convertLut report", "[.][report]") {
+    reportLut<ColorHSV, ColorRGB>("hsv->rgb");
+    reportLut<ColorHSL, ColorRGB>("hsl->rgb");
+    reportLut<ColorHSV, ColorRGB255>("hsv->rgb255");
+    reportLut<ColorYIQ, ColorRGB>("yiq->rgb");
+}
+
+} // converter
+} // timedata
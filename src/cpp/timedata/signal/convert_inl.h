@@ -1,11 +1,14 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
-#include <map>
+#include <new>
 #include <string>
+#include <vector>
 
 #include <timedata/base/className.h>
-#include <timedata/base/deletable.h>
+#include <timedata/base/instrument.h>
+#include <timedata/base/parallel.h>
 #include <timedata/base/join_inl.h>
 #include <timedata/color/models/rgb.h>
 #include <timedata/color/models/hsv.h>
@@ -72,19 +75,38 @@ void convertSample(Sample<ModelIn> const& in, Sample<ModelOut, RangeOut>& out) {
 /* Even though we're converting between a lot of different types, all this
    interface has to be uniform so we can put it into a single table.
 
-   So we hide the intermediate.
+   So we hide the intermediate: each converter converts its samples to and from
+   a normal sample held in a NormalStorage on the caller's stack, so converting
+   a single sample never allocates.
 */
+struct NormalStorage {
+    static size_t const SIZE = 4 * sizeof(float);
+    alignas(double) char data[SIZE];
+};
+
 struct Converter {
-    using From = Ptr<Deletable> (*)(PointerAsInt);
-    using To = void (*)(Deletable const&, PointerAsInt outPtr);
+    using ToNormal = void (*)(PointerAsInt inPtr, NormalStorage&);
+    using FromNormal = void (*)(NormalStorage const&, PointerAsInt outPtr);
+
+    // Lists are converted through a ConvertTile in the normal form instead.
+    using ListSize = size_t (*)(PointerAsInt);
+    using ListFrom = void (*)(PointerAsInt, size_t begin, size_t n,
+                              ConvertTile&);
+    using ListTo = void (*)(ConvertTile&, size_t begin, size_t n,
+                            PointerAsInt outPtr);
 
     std::string name;
-    From from;
-    To to;
+    ToNormal toNormal;
+    FromNormal fromNormal;
     Converter const* normal; // nullptr means "this is the normal form".
+
+    ListSize listSize;
+    ListFrom listFrom;
+    ListTo listTo;
 };
 
-using Converters = std::map<std::string, Converter const*>;
+/** The loaded converters, indexed by the model IDs from converterId. */
+using Converters = std::vector<Converter const*>;
 
 /** Get the singleton list of converters. */
 Converters& converters();
@@ -94,32 +116,49 @@ bool canConvert(Converter const&, Converter const&);
 template <typename Sample>
 Converter const& getConverterByType();
 
+/** Loads the converter for a sample type the first time it is called, and
+    returns its index in converters().  Like loadConverter, this must only be
+    called on a single thread. */
+template <typename Sample>
+size_t converterId() {
+    static const auto id = [] {
+        converters().push_back(&getConverterByType<Sample>());
+        return converters().size() - 1;
+    }();
+    return id;
+}
+
 template <typename Sample>
 std::string loadConverter() {
-    auto name = className<Sample>();
-    if (converters().find(name) == converters().end())
-        converters()[name] = &getConverterByType<Sample>();
-    return name;
+    converterId<Sample>();
+    return className<Sample>();
 }
 
-template <typename T>
-bool convertSampleCython(PointerAsInt inPtr,
-                         std::string const& modelName, T& out) {
-    auto i = converters().find(modelName);
-    if (i == converters().end()) {
-        log("Couldn't find converter", modelName);
-        return false;
+/** Returns the converter with ID `modelId` if it can convert to `to`. */
+inline Converter const* findConverter(size_t modelId, Converter const& to) {
+    if (modelId >= converters().size()) {
+        log("Couldn't find converter", modelId);
+        return nullptr;
     }
 
+    auto from = converters()[modelId];
+    if (not canConvert(to, *from)) {
+        log("Did not share common normal", from->name, to.name);
+        return nullptr;
+    }
+    return from;
+}
+
+template <typename T>
+bool convertSampleCython(PointerAsInt inPtr, size_t modelId, T& out) {
     auto& to = getConverterByType<T>();
-    auto& from = *(i->second);
-    if (not canConvert(to, from)) {
-        log("Did not share common normal", modelName, className<T>());
+    auto from = findConverter(modelId, to);
+    if (not from)
         return false;
-    }
 
-    auto outPtr = referenceToInteger(out);
-    to.to(*from.from(inPtr), outPtr);
+    NormalStorage normal;
+    from->toNormal(inPtr, normal);
+    to.fromNormal(normal, referenceToInteger(out));
     return true;
 }
 
@@ -136,20 +175,141 @@ inline bool canConvert(Converter const& x, Converter const& y) {
 }
 
 template <typename Sample>
-Ptr<Deletable> convertFrom(PointerAsInt p) {
+void toNormal(PointerAsInt p, NormalStorage& storage) {
+    using Normal = NormalType<Sample>;
+    static_assert(sizeof(Normal) <= NormalStorage::SIZE,
+                  "Normal sample is too big for NormalStorage");
+    static_assert(std::is_trivially_destructible<Normal>::value,
+                  "Normal sample must be trivially destructible");
+
     auto& in = integerToReference<Sample const>(p);
-    auto out = makeWrapper<NormalType<Sample>>();
-    convertSample(in, out->value);
-    return std::move(out);
+    convertSample(in, *new (storage.data) Normal);
 }
 
 template <typename Sample>
-void convertTo(Deletable const& input, PointerAsInt outPtr) {
-    auto& out = integerToReference<Sample>(outPtr);
-    if (auto in = unwrap<NormalType<Sample>>(input))
-        convertSample(*in, out);
-    else
-        log("Horrible programmer error", className<Sample>());
+void fromNormal(NormalStorage const& storage, PointerAsInt outPtr) {
+    auto& in = *reinterpret_cast<NormalType<Sample> const*>(storage.data);
+    convertSample(in, integerToReference<Sample>(outPtr));
+}
+
+template <typename ModelIn, typename ModelOut>
+void convertPlanes(ConvertTile& tile, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        Sample<ModelIn> in;
+        Sample<ModelOut> out;
+        for (size_t j = 0; j < in.size(); ++j)
+            in[j] = tile.planes[j][i];
+        convertSample(in, out);
+        for (size_t j = 0; j < out.size(); ++j)
+            tile.planes[j][i] = out[j];
+    }
+}
+
+/** Load `n` samples into a tile, converting them to the normal model if
+    `normalize` is true. */
+template <typename Sample>
+void loadTile(Sample const* in, size_t n, ConvertTile& tile, bool normalize) {
+    static_assert(Sample::SIZE == 3, "ConvertTile only has three planes");
+    using Range = typename Sample::range_type;
+    using Model = typename Sample::model_type;
+    using NormalModel = typename NormalType<Sample>::model_type;
+
+    auto x = tile.planes[0], y = tile.planes[1], z = tile.planes[2];
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = unscale<Range>(*in[i][0]);
+        y[i] = unscale<Range>(*in[i][1]);
+        z[i] = unscale<Range>(*in[i][2]);
+    }
+    if (normalize and not std::is_same<Model, NormalModel>::value)
+        convertPlanes<Model, NormalModel>(tile, n);
+}
+
+/** Store `n` samples from a tile, converting them from the normal model if
+    `normalize` is true. */
+template <typename Sample>
+void storeTile(ConvertTile& tile, size_t n, Sample* out, bool normalize) {
+    static_assert(Sample::SIZE == 3, "ConvertTile only has three planes");
+    using Range = typename Sample::range_type;
+    using Model = typename Sample::model_type;
+    using NormalModel = typename NormalType<Sample>::model_type;
+
+    if (normalize and not std::is_same<Model, NormalModel>::value)
+        convertPlanes<NormalModel, Model>(tile, n);
+    auto x = tile.planes[0], y = tile.planes[1], z = tile.planes[2];
+    for (size_t i = 0; i < n; ++i) {
+        *out[i][0] = scale<Range>(x[i]);
+        *out[i][1] = scale<Range>(y[i]);
+        *out[i][2] = scale<Range>(z[i]);
+    }
+}
+
+template <typename SampleIn, typename SampleOut>
+void convertSamples(SampleIn const* in, size_t size, SampleOut* out) {
+    // Samples of the same model don't need to visit the normal model.
+    auto normalize = not std::is_same<typename SampleIn::model_type,
+                                      typename SampleOut::model_type>::value;
+    forChunks(size, sizeof(SampleOut), [=](size_t begin, size_t end) {
+        ConvertTile tile;
+        for (auto i = begin; i < end; i += CONVERT_TILE_SIZE) {
+            auto n = std::min(CONVERT_TILE_SIZE, end - i);
+            loadTile(in + i, n, tile, normalize);
+            storeTile(tile, n, out + i, normalize);
+        }
+    });
+}
+
+template <typename ListIn, typename ListOut>
+void convertList(ListIn const& in, ListOut& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("convert", in.size());
+    out.resize(in.size());
+    if (not in.empty())
+        convertSamples(in.data(), in.size(), out.data());
+}
+
+template <typename List>
+void convertList(List const& in, List& out) {
+    TIMEDATA_INSTRUMENT_SCOPE("convert", in.size());
+    if (&in != &out)
+        out.assign(in.begin(), in.end());
+}
+
+template <typename Sample>
+size_t listSize(PointerAsInt p) {
+    return integerToReference<std::vector<Sample> const>(p).size();
+}
+
+template <typename Sample>
+void listFrom(PointerAsInt p, size_t begin, size_t n, ConvertTile& tile) {
+    auto& in = integerToReference<std::vector<Sample> const>(p);
+    loadTile(in.data() + begin, n, tile, true);
+}
+
+template <typename Sample>
+void listTo(ConvertTile& tile, size_t begin, size_t n, PointerAsInt outPtr) {
+    auto& out = integerToReference<std::vector<Sample>>(outPtr);
+    storeTile(tile, n, out.data() + begin, true);
+}
+
+template <typename T>
+bool convertListCython(PointerAsInt inPtr, size_t modelId, T& out) {
+    using Sample = typename T::value_type;
+    auto& to = getConverterByType<Sample>();
+    auto from = findConverter(modelId, to);
+    if (not from)
+        return false;
+
+    out.resize(from->listSize(inPtr));
+    TIMEDATA_INSTRUMENT_SCOPE("convert", out.size());
+    auto outPtr = referenceToInteger(out);
+    forChunks(out.size(), sizeof(Sample), [&](size_t begin, size_t end) {
+        ConvertTile tile;
+        for (auto j = begin; j < end; j += CONVERT_TILE_SIZE) {
+            auto n = std::min(CONVERT_TILE_SIZE, end - j);
+            from->listFrom(inPtr, j, n, tile);
+            to.listTo(tile, j, n, outPtr);
+        }
+    });
+    return true;
 }
 
 template <typename Sample>
@@ -163,7 +323,8 @@ Converter makeConverterByType() {
     auto isNormal = std::is_same<Normal, Sample>::value;
     auto normal = isNormal ? nullptr : &getConverterByType<Normal>();
 
-    return {name, &convertFrom<Sample>, &convertTo<Sample>, normal};
+    return {name, &toNormal<Sample>, &fromNormal<Sample>, normal,
+            &listSize<Sample>, &listFrom<Sample>, &listTo<Sample>};
 }
 
 template <typename Sample>
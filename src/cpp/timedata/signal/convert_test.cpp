@@ -0,0 +1,159 @@
+#pragma once
+
+#include <random>
+
+#include <timedata/base/nearlyEqual_test.h>
+#include <timedata/color/cython_inl.h>
+#include <timedata/signal/convert_inl.h>
+
+namespace timedata {
+namespace converter {
+
+namespace {
+
+/** Random samples with components in [low, high], and black and gray, which
+    are special cases for HSV.  By default, some components are out of
+    band. */
+template <typename Sample>
+typename Sample::List testSamples(
+        size_t size, float low = -0.25f, float high = 1.25f) {
+    std::mt19937 generator(size);
+    std::uniform_real_distribution<float> dist(low, high);
+
+    typename Sample::List samples(size);
+    for (size_t i = 0; i < size; ++i) {
+        for (size_t j = 0; j < Sample::SIZE; ++j) {
+            auto x = i % 10 == 0 ? 0.0f : i % 10 == 1 ? 0.5f : dist(generator);
+            samples[i][j] = scale<typename Sample::range_type>(x);
+        }
+    }
+    return samples;
+}
+
+/** Convert a sample through the normal model, as Python does. */
+template <typename In, typename Out>
+void convertThroughNormal(In const& in, Out& out) {
+    NormalType<In> normal;
+    convertSample(in, normal);
+    convertSample(normal, out);
+}
+
+/** Python copies samples of the same type. */
+template <typename Sample>
+void convertThroughNormal(Sample const& in, Sample& out) {
+    out = in;
+}
+
+template <typename In, typename Out>
+void testConvertList(size_t size) {
+    auto in = testSamples<In>(size);
+    typename Out::List expected(size);
+    for (size_t i = 0; i < size; ++i)
+        convertThroughNormal(in[i], expected[i]);
+
+    typename Out::List out(3);
+    convertList(in, out);
+    REQUIRE(out.size() == size);
+
+    // Compare in the normal range, so the tolerance doesn't depend on it.  Far
+    // out of band, HSL saturation divides by a number near zero, so its error
+    // grows with the square of its size.
+    using Range = typename Out::range_type;
+    for (size_t i = 0; i < size; ++i) {
+        for (size_t j = 0; j < Out::SIZE; ++j) {
+            auto x = unscale<Range>(*out[i][j]);
+            auto y = unscale<Range>(*expected[i][j]);
+            REQUIRE(nearlyEqual(x, y, std::max(1.0f, y * y)));
+        }
+    }
+}
+
+template <typename In>
+void testConvertFrom(size_t size) {
+    testConvertList<In, ColorRGB>(size);
+    testConvertList<In, ColorRGB255>(size);
+    testConvertList<In, ColorRGB256>(size);
+    testConvertList<In, ColorHSV>(size);
+    testConvertList<In, ColorHSL>(size);
+    testConvertList<In, ColorXYZ>(size);
+    testConvertList<In, ColorYIQ>(size);
+    testConvertList<In, ColorYUV>(size);
+}
+
+void testConvertAll(size_t size) {
+    testConvertFrom<ColorRGB>(size);
+    testConvertFrom<ColorRGB255>(size);
+    testConvertFrom<ColorRGB256>(size);
+    testConvertFrom<ColorHSV>(size);
+    testConvertFrom<ColorHSL>(size);
+    testConvertFrom<ColorXYZ>(size);
+    testConvertFrom<ColorYIQ>(size);
+    testConvertFrom<ColorYUV>(size);
+}
+
+} // namespace
+
+TEST_CASE("convertList matches convertSample", "[convert]") {
+    // Sizes around the size of a tile.
+    for (auto size: {0, 1, 255, 256, 700})
+        testConvertAll(size);
+}
+
+TEST_CASE("convertList in parallel", "[convert]") {
+    withParallelism(3, 0, []() { testConvertAll(1000); });
+}
+
+TEST_CASE("convert black and white to HSL", "[convert]") {
+    // HSL saturation is 0 / 0 for both.  convertList goes through RGB, where
+    // white, like any gray, has no hue.
+    ColorHSV::List in = {{0.5f, 0.5f, 0.0f}, {0.5f, 0.0f, 1.0f}};
+    ColorHSL::List out;
+    convertList(in, out);
+    REQUIRE(out.size() == 2);
+    for (size_t i = 0; i < in.size(); ++i) {
+        ColorHSL sample;
+        convertSample(in[i], sample);
+        for (auto& s: {sample, out[i]}) {
+            REQUIRE(*s[HSL::saturation] == 0.0f);
+            REQUIRE(*s[HSL::lightness] == float(i));
+        }
+    }
+}
+
+TEST_CASE("convertList same type", "[convert]") {
+    auto in = testSamples<ColorHSV>(10);
+    ColorHSV::List out;
+    convertList(in, out);
+    REQUIRE(out == in);
+    convertList(out, out);
+    REQUIRE(out == in);
+}
+
+TEST_CASE("convert by model ID", "[convert]") {
+    auto hsv = converterId<ColorHSV>(), rgb255 = converterId<ColorRGB255>();
+    REQUIRE(hsv != rgb255);
+    REQUIRE(converterId<ColorHSV>() == hsv);
+    REQUIRE(loadConverter<ColorHSV>() == className<ColorHSV>());
+    REQUIRE(converters()[hsv] == &getConverterByType<ColorHSV>());
+
+    auto in = testSamples<ColorHSV>(20);
+    for (auto& sample: in) {
+        ColorRGB255 out, expected;
+        convertThroughNormal(sample, expected);
+        auto p = referenceToInteger(sample);
+        REQUIRE(convertSampleCython(p, hsv, out));
+        REQUIRE(out == expected);
+    }
+
+    ColorRGB255::List out;
+    REQUIRE(convertListCython(referenceToInteger(in), hsv, out));
+    REQUIRE(out.size() == in.size());
+
+    ColorRGB255 sample;
+    auto p = referenceToInteger(in[0]);
+    REQUIRE(not convertSampleCython(p, converters().size(), sample));
+    REQUIRE(not convertListCython(referenceToInteger(in), 1000, out));
+}
+
+} // converter
+} // timedata
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <utility>
+
 #include <timedata/color/models/rgb.h>
 #include <timedata/base/math.h>
+#include <timedata/base/parallel.h>
 
 namespace timedata {
 
@@ -11,7 +15,9 @@ struct Fade {
     float begin = 0, end = 1;
     Type type = Type::linear;
 
-    float operator()(float fader, float x, float y) const {
+    // Return how much of the first and the second input are in the fade at
+    // `fader`.
+    std::pair<float, float> ratios(float fader) const {
         auto xratio = begin + invert(fader) * (end - begin);
         auto yratio = begin + fader * (end - begin);
 
@@ -27,9 +33,13 @@ struct Fade {
                 yratio = sqrt(std::abs(yratio)) * signum(yratio);
                 break;
         }
+        return {xratio, yratio};
+    }
 
+    float operator()(float fader, float x, float y) const {
         // TODO: perhaps we should be applying end and begin after this step?
-        return xratio * x + yratio * y;
+        auto r = ratios(fader);
+        return r.first * x + r.second * y;
     }
 };
 
@@ -41,14 +51,99 @@ ColorRGB fadeTo(float fader, Fade const& fade, ColorRGB const& in1, ColorRGB con
     return out;
 }
 
-#if 0
+/** Crossfade two lists of samples into `out`, which is resized to the
+    shorter of the two and may be either of them.
+
+    This gives the same results as calling fadeTo on each pair of samples, but
+    the fade's ratios are only computed once, and the loop runs over all the
+    components as one array of floats so that it vectorizes.  Nothing is
+    allocated unless `out` has to grow. */
+template <typename List>
+void fadeOver(float fader, Fade const& fade,
+              List const& in1, List const& in2, List& out);
+
+/** Mix `count` lists of samples into `out`, multiplying each list by its
+    weight.  `out` is resized to the shortest of the lists and may be any of
+    them.  With no lists at all, `out` is cleared.
+
+    Like fadeOver, this only allocates if `out` has to grow. */
+template <typename List>
+void mixOver(float const* weights, List const* const* inputs, size_t count,
+             List& out);
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+
+/** Mixes are accumulated this many floats at a time, which fits easily in the
+    L1 cache. */
+static size_t const MIX_BLOCK_SIZE = 1024;
+
+template <typename List>
+float const* componentData(List const& list) {
+    using Sample = typename List::value_type;
+    static_assert(sizeof(Sample) == Sample::SIZE * sizeof(float),
+                  "Samples must be packed floats");
+    return &*list[0][0];
+}
+
+template <typename List>
+float* componentData(List& list) {
+    return const_cast<float*>(componentData(static_cast<List const&>(list)));
+}
+
+template <typename List>
 void fadeOver(float fader, Fade const& fade,
-              ColorVector const& in1, ColorVector const& in2, ColorVector& out) {
+              List const& in1, List const& in2, List& out) {
     auto size = std::min(in1.size(), in2.size());
     out.resize(size);
-    for (size_t i = 0; i < size; ++i)
-        out[i] = fadeTo(fader, fade, in1[i], in2[i]);
+    if (not size)
+        return;
+
+    auto r = fade.ratios(fader);
+    auto x = r.first, y = r.second;
+    auto a = componentData(in1), b = componentData(in2);
+    auto o = componentData(out);
+    auto n = size * List::value_type::SIZE;
+    forChunks(n, sizeof(float), [=](size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i)
+            o[i] = x * a[i] + y * b[i];
+    });
+}
+
+template <typename List>
+void mixOver(float const* weights, List const* const* inputs, size_t count,
+             List& out) {
+    auto size = count ? inputs[0]->size() : 0;
+    for (size_t k = 1; k < count; ++k)
+        size = std::min(size, inputs[k]->size());
+    out.resize(size);
+    if (not size)
+        return;
+
+    // `out` might be one of the inputs, so each block is summed on the stack
+    // before it is written.
+    auto o = componentData(out);
+    auto n = size * List::value_type::SIZE;
+    forChunks(n, sizeof(float), [=](size_t begin, size_t end) {
+        float block[MIX_BLOCK_SIZE];
+        for (auto i = begin; i < end; i += MIX_BLOCK_SIZE) {
+            auto m = std::min(MIX_BLOCK_SIZE, end - i);
+            auto w = weights[0];
+            auto in = componentData(*inputs[0]) + i;
+            for (size_t j = 0; j < m; ++j)
+                block[j] = w * in[j];
+
+            for (size_t k = 1; k < count; ++k) {
+                w = weights[k];
+                in = componentData(*inputs[k]) + i;
+                for (size_t j = 0; j < m; ++j)
+                    block[j] += w * in[j];
+            }
+            std::copy(block, block + m, o + i);
+        }
+    });
 }
-#endif
 
 } // timedata
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <timedata/base/nearlyEqual_test.h>
+#include <timedata/signal/fade.h>
+
+namespace timedata {
+namespace color_list {
+
+namespace {
+
+Fade makeFade(Fade::Type type, float begin = 0, float end = 1) {
+    Fade fade;
+    fade.type = type;
+    fade.begin = begin;
+    fade.end = end;
+    return fade;
+}
+
+} // namespace
+
+TEST_CASE("fadeOver matches fadeTo", "[fade]") {
+    using T = Fade::Type;
+    auto in1 = randomColors(100), in2 = randomColors(77);
+    for (auto fade: {makeFade(T::linear), makeFade(T::sqr),
+                     makeFade(T::sqrt), makeFade(T::sqr, 0.25f, 0.75f)}) {
+        for (auto fader: {0.0f, 0.3f, 1.0f, -0.5f}) {
+            CColorListRGB out;
+            fadeOver(fader, fade, in1, in2, out);
+            REQUIRE(out.size() == 77);
+            for (size_t i = 0; i < out.size(); ++i)
+                REQUIRE(out[i] == fadeTo(fader, fade, in1[i], in2[i]));
+
+            // In place, and in parallel.
+            auto first = in1, second = in2;
+            withParallelism(3, 0, [&]() {
+                fadeOver(fader, fade, first, in2, first);
+                fadeOver(fader, fade, in1, second, second);
+            });
+            REQUIRE(first == out);
+            REQUIRE(second == out);
+        }
+    }
+}
+
+TEST_CASE("mixOver", "[fade]") {
+    auto a = randomColors(3000), b = randomColors(2500), c = randomColors(2600);
+    std::vector<float> weights = {0.5f, -2.0f, 0.25f};
+    std::vector<CColorListRGB const*> inputs = {&a, &b, &c};
+
+    CColorListRGB out;
+    mixOver(weights.data(), inputs.data(), 3, out);
+    REQUIRE(out.size() == 2500);
+    for (size_t i = 0; i < out.size(); ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            auto expected = 0.5f * *a[i][j] - 2.0f * *b[i][j];
+            expected += 0.25f * *c[i][j];
+            REQUIRE(nearlyEqual(*out[i][j], expected));
+        }
+    }
+
+    // Mixing into the last input.
+    auto expected = out;
+    withParallelism(3, 0, [&]() {
+        mixOver(weights.data(), inputs.data(), 3, c);
+    });
+    REQUIRE(c == expected);
+
+    // Two lists mix like a linear fade.
+    CColorListRGB faded;
+    Fade fade;
+    fadeOver(0.25f, fade, a, b, faded);
+    std::vector<float> fadeWeights = {0.75f, 0.25f};
+    mixOver(fadeWeights.data(), inputs.data(), 2, out);
+    REQUIRE(nearlyEqualLists(out, faded));
+
+    mixOver(weights.data(), inputs.data(), 0, out);
+    REQUIRE(out.empty());
+}
+
+} // color_list
+} // timedata
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include <timedata/base/trig_inl.h>
+#include <timedata/signal/fade.h>
+#include <timedata/signal/noise.h>
+#include <timedata/signal/oscillator.h>
+#include <timedata/signal/ramp.h>
+
+namespace timedata {
+
+/** Fill every component of every sample. */
+static int const ALL_CHANNELS = -1;
+
+/** Fill one channel of a list of samples - or all of them, if `channel` is
+    ALL_CHANNELS - with the values of a generator, which is an Oscillator,
+    Noise or a Ramp.  The list keeps its size.
+
+    Values are computed a block at a time into an array of floats, in loops
+    with no branches that vectorize, and then copied into the channels.  Long
+    lists are split across threads. */
+template <typename Generator, typename List>
+void generate(Generator const&, List& out, int channel = ALL_CHANNELS);
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+
+/** Values are generated this many at a time on the stack. */
+static size_t const GENERATOR_BLOCK_SIZE = 256;
+
+namespace detail {
+
+/** 2^32, for turning fractions of a turn into 32-bit fixed point. */
+static double const FIXED_TURN = 4294967296.0;
+
+/** Return x mod 1 as a 32-bit fixed point fraction. */
+inline uint32_t fixedFraction(double x) {
+    // Rounding can make the fraction exactly one turn, which wraps to 0.
+    return uint32_t(uint64_t((x - std::floor(x)) * FIXED_TURN));
+}
+
+/** Return the top 24 bits of a 32-bit fixed point fraction as a float in
+    [0, 1), which is exact. */
+inline float fixedToFloat(uint32_t x) {
+    return float(int32_t(x >> 8)) * (1.0f / (1 << 24));
+}
+
+/** The waves are computed from the phase in 32-bit fixed point, so phases
+    wrap exactly with integer arithmetic however long the list. */
+inline void fill(Oscillator const& o, size_t begin, size_t end, float* out) {
+    auto step = fixedFraction(o.step);
+    auto phase = fixedFraction(o.phase) + uint32_t(begin) * step;
+    auto low = o.low, range = o.high - o.low;
+    auto n = end - begin;
+    using Wave = Oscillator::Wave;
+
+    // u is the position in the cycle, in [0, 1).
+    switch (o.wave) {
+        case Wave::sine:
+            for (size_t i = 0; i < n; ++i) {
+                auto x = fixedToFloat(phase + uint32_t(i) * step) - 0.5f;
+                // cos(2 pi x) = sin(2 pi (1/4 - |x|)), and 1/4 - |x| is in
+                // [-1/4, 1/4].
+                auto c = fastSinTurns(0.25f - std::abs(x));
+                out[i] = low + range * (0.5f + 0.5f * c);
+            }
+            break;
+
+        case Wave::triangle:
+            for (size_t i = 0; i < n; ++i) {
+                auto u = fixedToFloat(phase + uint32_t(i) * step);
+                out[i] = low + range * (1 - std::abs(2 * u - 1));
+            }
+            break;
+
+        case Wave::saw:
+            for (size_t i = 0; i < n; ++i) {
+                auto u = fixedToFloat(phase + uint32_t(i) * step);
+                out[i] = low + range * u;
+            }
+            break;
+
+        case Wave::square:
+            for (size_t i = 0; i < n; ++i) {
+                // 1 for u in [1/4, 3/4), and 0 otherwise.
+                auto u = fixedToFloat(phase + uint32_t(i) * step);
+                auto on = int32_t(u + 0.75f) - int32_t(u + 0.25f);
+                out[i] = low + range * float(on);
+            }
+            break;
+    }
+}
+
+/** A well-mixed hash of a grid point, as a float in [0, 1). */
+inline float noiseValue(int32_t x, int32_t t, uint32_t seed) {
+    auto h = uint32_t(x) * 0x27d4eb2du ^ uint32_t(t) * 0x165667b1u ^ seed;
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    h *= 0x297a2d39u;
+    h ^= h >> 15;
+    return float(int32_t(h >> 8)) * (1.0f / (1 << 24));
+}
+
+inline float smoothStep(float x) {
+    return x * x * (3 - 2 * x);
+}
+
+/** Positions are in 16.16 fixed point, so that the grid point and fraction
+    come from a shift and a mask. */
+inline void fill(Noise const& noise, size_t begin, size_t end, float* out) {
+    static double const FIXED_POINT = 65536.0;
+    static float const FIXED_FRACTION = 1.0f / 65536;
+    auto step = uint32_t(std::llround(noise.scale * FIXED_POINT));
+    auto start = std::llround(noise.offset * FIXED_POINT);
+    auto position = uint32_t(start) + uint32_t(begin) * step;
+
+    auto t0 = std::floor(noise.time);
+    auto t = int32_t(t0);
+    auto ft = smoothStep(float(noise.time - t0));
+    auto low = noise.low, range = noise.high - noise.low;
+    auto seed = noise.seed;
+    auto n = end - begin;
+    for (size_t i = 0; i < n; ++i) {
+        auto p = int32_t(position + uint32_t(i) * step);
+        auto x = p >> 16;
+        auto fx = smoothStep(float(p & 0xffff) * FIXED_FRACTION);
+        auto a = noiseValue(x, t, seed), b = noiseValue(x + 1, t, seed);
+        auto c = noiseValue(x, t + 1, seed);
+        auto d = noiseValue(x + 1, t + 1, seed);
+        auto ab = a + fx * (b - a), cd = c + fx * (d - c);
+        out[i] = low + range * (ab + ft * (cd - ab));
+    }
+}
+
+inline void rampSpan(Ramp const& ramp, float const* distance, float* out,
+                     size_t n) {
+    auto begin = ramp.begin, low = ramp.low, range = ramp.high - ramp.low;
+    if (ramp.end == ramp.begin) {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = distance[i] < begin ? ramp.low : ramp.high;
+        return;
+    }
+
+    auto scale = 1 / (ramp.end - ramp.begin);
+    for (size_t i = 0; i < n; ++i) {
+        // This is r clamped to [0, 1], written so that it vectorizes.
+        auto r = (distance[i] - begin) * scale;
+        out[i] = low + range * 0.5f * (std::abs(r) - std::abs(r - 1) + 1);
+    }
+}
+
+inline void fill(Ramp const& ramp, size_t begin, size_t end, float* out) {
+    float distance[GENERATOR_BLOCK_SIZE];
+    auto n = end - begin;
+    if (ramp.shape == Ramp::Shape::line) {
+        for (size_t i = 0; i < n; ++i)
+            distance[i] = float(begin + i);
+    } else {
+        auto width = ramp.width ? size_t(ramp.width) : ~size_t(0);
+        for (size_t i = 0; i < n; ++i) {
+            auto dx = float((begin + i) % width) - ramp.x;
+            auto dy = float((begin + i) / width) - ramp.y;
+            distance[i] = std::sqrt(dx * dx + dy * dy);
+        }
+    }
+    rampSpan(ramp, distance, out, n);
+}
+
+} // detail
+
+template <typename Generator, typename List>
+void generate(Generator const& generator, List& out, int channel) {
+    using Sample = typename List::value_type;
+    auto size = out.size();
+    if (not size or channel < ALL_CHANNELS or channel >= int(Sample::SIZE))
+        return;
+
+    auto o = componentData(out);
+    forChunks(size, sizeof(Sample), [=, &generator](size_t begin, size_t end) {
+        float block[GENERATOR_BLOCK_SIZE];
+        for (auto i = begin; i < end; i += GENERATOR_BLOCK_SIZE) {
+            auto m = std::min(GENERATOR_BLOCK_SIZE, end - i);
+            detail::fill(generator, i, i + m, block);
+            auto samples = o + i * Sample::SIZE;
+            if (channel == ALL_CHANNELS) {
+                for (size_t k = 0; k < m; ++k) {
+                    for (size_t j = 0; j < Sample::SIZE; ++j)
+                        samples[k * Sample::SIZE + j] = block[k];
+                }
+            } else {
+                for (size_t k = 0; k < m; ++k)
+                    samples[k * Sample::SIZE + channel] = block[k];
+            }
+        }
+    });
+}
+
+} // timedata
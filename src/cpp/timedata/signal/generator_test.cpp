@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cmath>
+
+#include <timedata/signal/generator.h>
+
+namespace timedata {
+namespace color_list {
+namespace generator {
+
+/** The values in one channel of a list. */
+std::vector<float> channel(CColorListRGB const& list, size_t c) {
+    std::vector<float> result;
+    for (auto& sample: list)
+        result.push_back(*sample[c]);
+    return result;
+}
+
+TEST_CASE("oscillator", "[generator]") {
+    auto pi = 3.14159265358979323846;
+    using Wave = Oscillator::Wave;
+    Oscillator o;
+    o.phase = -0.3f;
+    o.step = 0.01f;
+    o.low = 0.25f;
+    o.high = 0.75f;
+
+    CColorListRGB list(1000);
+    for (auto wave: {Wave::sine, Wave::triangle, Wave::saw, Wave::square}) {
+        o.wave = wave;
+        generate(o, list);
+        for (size_t i = 0; i < list.size(); ++i) {
+            auto u = i * 0.01 - 0.3;
+            u -= std::floor(u);
+            auto triangle = 1 - std::abs(2 * u - 1);
+            double expected = 0;
+            switch (wave) {
+                case Wave::sine:
+                    expected = 0.5 - 0.5 * std::cos(2 * pi * u);
+                    break;
+                case Wave::triangle:
+                    expected = triangle;
+                    break;
+                case Wave::saw:
+                    if (u < 1e-4 or u > 1 - 1e-4)
+                        continue;
+                    expected = u;
+                    break;
+                case Wave::square:
+                    // Skip the edges, where rounding decides.
+                    if (std::abs(triangle - 0.5) < 1e-4)
+                        continue;
+                    expected = triangle > 0.5;
+                    break;
+            }
+            expected = 0.25 + 0.5 * expected;
+            REQUIRE(std::abs(*list[i][0] - expected) < 0.001);
+            REQUIRE(*list[i][1] == *list[i][0]);
+            REQUIRE(*list[i][2] == *list[i][0]);
+        }
+    }
+
+    // Phases wrap exactly however far along the list.
+    o.wave = Wave::saw;
+    o.phase = 0;
+    o.step = 0.25f;
+    list.resize(100000);
+    generate(o, list);
+    REQUIRE(*list[99999][0] == 0.25f + 0.5f * 0.75f);
+}
+
+TEST_CASE("generate one channel", "[generator]") {
+    Oscillator o;
+    o.step = 0.001f;
+    auto list = randomColors(5000);
+    auto original = list;
+
+    generate(o, list, 1);
+    REQUIRE(channel(list, 0) == channel(original, 0));
+    REQUIRE(channel(list, 2) == channel(original, 2));
+    REQUIRE(channel(list, 1) != channel(original, 1));
+
+    // Bad channels do nothing.
+    auto copy = list;
+    generate(o, list, 3);
+    generate(o, list, -2);
+    REQUIRE(list == copy);
+}
+
+TEST_CASE("generate in parallel", "[generator]") {
+    Oscillator o;
+    o.step = 0.0123f;
+    Noise n;
+    n.offset = -17.5f;
+    n.time = 2.25f;
+    Ramp r;
+    r.shape = Ramp::Shape::circle;
+    r.width = 100;
+    r.end = 40;
+
+    CColorListRGB serial(10000), parallel(10000);
+    generate(o, serial, 0);
+    generate(n, serial, 1);
+    generate(r, serial, 2);
+    withParallelism(4, 0, [&]() {
+        generate(o, parallel, 0);
+        generate(n, parallel, 1);
+        generate(r, parallel, 2);
+    });
+    REQUIRE(serial == parallel);
+}
+
+TEST_CASE("noise", "[generator]") {
+    Noise n;
+    n.scale = 0.0625f;
+    n.low = -1;
+    n.high = 2;
+    CColorListRGB a(2000), b(2000);
+    generate(n, a);
+    generate(n, b);
+    REQUIRE(a == b);
+
+    auto values = channel(a, 0);
+    auto minmax = std::minmax_element(values.begin(), values.end());
+    REQUIRE(*minmax.first >= -1);
+    REQUIRE(*minmax.second < 2);
+    REQUIRE(*minmax.second - *minmax.first > 1);
+
+    // Smooth along the list.
+    for (size_t i = 1; i < values.size(); ++i)
+        REQUIRE(std::abs(values[i] - values[i - 1]) < 3 * 0.0625 * 1.5);
+
+    // And over time.
+    n.time = 0.01f;
+    generate(n, b);
+    for (size_t i = 0; i < values.size(); ++i)
+        REQUIRE(std::abs(*b[i][0] - values[i]) < 0.05);
+
+    n.time = 0;
+    n.seed = 1;
+    generate(n, b);
+    REQUIRE(a != b);
+
+    // Moving the offset by 20 samples' worth moves the noise by 20 samples.
+    n.seed = 0;
+    n.offset = 0.0625f * 20;
+    generate(n, b);
+    for (size_t i = 0; i + 20 < values.size(); ++i)
+        REQUIRE(*b[i][0] == values[i + 20]);
+}
+
+TEST_CASE("ramp", "[generator]") {
+    Ramp r;
+    r.begin = 2;
+    r.end = 6;
+    r.low = 1;
+    r.high = 0;
+    CColorListRGB list(10);
+    generate(r, list, 0);
+    std::vector<float> expected = {1, 1, 1, 0.75f, 0.5f, 0.25f, 0, 0, 0, 0};
+    REQUIRE(channel(list, 0) == expected);
+
+    r.end = 2;
+    generate(r, list, 0);
+    expected = {1, 1, 0, 0, 0, 0, 0, 0, 0, 0};
+    REQUIRE(channel(list, 0) == expected);
+
+    // A circle of radius 2 around (1, 1) in a 3 by 3 grid.
+    r.shape = Ramp::Shape::circle;
+    r.begin = 0;
+    r.end = 2;
+    r.low = 0;
+    r.high = 1;
+    r.x = r.y = 1;
+    r.width = 3;
+    list.resize(9);
+    generate(r, list);
+    auto root = std::sqrt(2.0f) / 2;
+    expected = {root, 0.5f, root, 0.5f, 0, 0.5f, root, 0.5f, root};
+    auto values = channel(list, 2);
+    for (size_t i = 0; i < values.size(); ++i)
+        REQUIRE(std::abs(values[i] - expected[i]) < 1e-6);
+}
+
+} // generator
+} // color_list
+} // timedata
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace timedata {
+
+/** Smooth value noise along a list that evolves smoothly over time.
+
+    Random values in [low, high) are placed on a grid of positions and times,
+    and interpolated between them.  Sample i of the list is at position
+    i * scale + offset, so `scale` is the number of grid points per sample.
+    The same seed always gives the same noise. */
+struct Noise {
+    float scale = 0.1f, offset = 0, time = 0;
+    float low = 0, high = 1;
+    uint32_t seed = 0;
+};
+
+} // timedata
@@ -0,0 +1,20 @@
+#pragma once
+
+namespace timedata {
+
+/** A periodic wave along a list, with the phase advancing by `step` turns
+    from each sample to the next.
+
+    Each wave rises from `low` at the start of its cycle to `high` half way
+    through and back, except for the saw, which rises through the whole cycle
+    and drops back to `low` at the end.  The square wave is `high` for the
+    middle half of its cycle, from 1/4 of the way through to 3/4. */
+struct Oscillator {
+    enum class Wave {sine, triangle, saw, square, last = square};
+
+    Wave wave = Wave::sine;
+    float phase = 0, step = 0;  // In turns.
+    float low = 0, high = 1;
+};
+
+} // timedata
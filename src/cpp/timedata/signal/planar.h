@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include <timedata/signal/sample.h>
+
+namespace timedata {
+
+/** A Planar list holds the same data as a Sample::List, but stored as a
+    "structure of arrays": each component of the samples lives in its own
+    contiguous plane.
+
+    Sample::List stores each sample's components together, so a loop over one
+    component has a stride of Sample::SIZE, and compilers vectorize that
+    badly.  Loops over a Planar list are over contiguous numbers instead.
+
+    Planar lists are for bulk arithmetic - reading or writing single samples is
+    slower than with a Sample::List. */
+template <typename Sample>
+struct Planar {
+    using model_type = typename Sample::model_type;
+    using number_type = typename Sample::number_type;
+    using range_type = typename Sample::range_type;
+    using ranged_type = typename Sample::value_type;
+    using sample_type = Sample;
+    using value_type = Sample;
+    using list_type = typename Sample::List;
+
+    using is_container = std::true_type;
+
+    static const auto SIZE = Sample::SIZE;
+
+    using Plane = std::vector<number_type>;
+    std::array<Plane, SIZE> planes;
+
+    Planar() = default;
+    explicit Planar(size_t size) { resize(size); }
+
+    size_t size() const { return planes[0].size(); }
+    bool empty() const { return planes[0].empty(); }
+
+    void resize(size_t size) {
+        for (auto& p: planes)
+            p.resize(size);
+    }
+
+    void clear() {
+        for (auto& p: planes)
+            p.clear();
+    }
+
+    Sample get(size_t i) const {
+        Sample s;
+        for (size_t j = 0; j < SIZE; ++j)
+            s[j] = planes[j][i];
+        return s;
+    }
+
+    void set(size_t i, Sample const& s) {
+        for (size_t j = 0; j < SIZE; ++j)
+            planes[j][i] = s[j];
+    }
+};
+
+/** Copy a Sample::List into a Planar list in a single pass, resizing `out`
+    only if it's the wrong size. */
+template <typename Sample>
+void toPlanar(typename Sample::List const& in, Planar<Sample>& out);
+
+/** Copy a Planar list into a Sample::List in a single pass, resizing `out`
+    only if it's the wrong size. */
+template <typename Sample>
+void fromPlanar(Planar<Sample> const& in, typename Sample::List& out);
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename Sample>
+void toPlanar(typename Sample::List const& in, Planar<Sample>& out) {
+    if (out.size() != in.size())
+        out.resize(in.size());
+    for (size_t j = 0; j < Sample::SIZE; ++j) {
+        auto plane = out.planes[j].data();
+        for (size_t i = 0; i < in.size(); ++i)
+            plane[i] = in[i][j];
+    }
+}
+
+template <typename Sample>
+void fromPlanar(Planar<Sample> const& in, typename Sample::List& out) {
+    if (out.size() != in.size())
+        out.resize(in.size());
+    for (size_t j = 0; j < Sample::SIZE; ++j) {
+        auto plane = in.planes[j].data();
+        for (size_t i = 0; i < in.size(); ++i)
+            out[i][j] = plane[i];
+    }
+}
+
+}  // timedata
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+namespace timedata {
+
+/** A ramp from `low` at distance `begin` to `high` at distance `end`, held at
+    `low` before `begin` and at `high` after `end`.
+
+    A line ramp measures distance by the index in the list.  A circle ramp
+    treats the list as rows of `width` samples - one row if `width` is 0 - and
+    measures distance from the point (x, y), where x is the column and y the
+    row. */
+struct Ramp {
+    enum class Shape {line, circle, last = circle};
+
+    Shape shape = Shape::line;
+    float begin = 0, end = 1;
+    float low = 0, high = 1;
+    float x = 0, y = 0;
+    uint32_t width = 0;
+};
+
+} // timedata
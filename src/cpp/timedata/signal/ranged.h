@@ -1,5 +1,7 @@
 #pragma once
 
+#include <limits>
+
 #include <timedata/signal/range.h>
 
 namespace timedata {
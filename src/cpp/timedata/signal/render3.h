@@ -6,10 +6,14 @@ namespace timedata {
 
 struct Render3 {
     enum class Permutation {rgb, rbg, grb, gbr, brg, bgr};
+    enum class Output {bits8, dither8, bits16};
+    enum class Table {full, compact};
 
     float gamma = 1.0f;
     uint8_t min = 0, max = 255;
     Permutation permutation = Permutation::rgb;
+    Output output = Output::bits8;
+    Table table = Table::full;
 };
 
 } // timedata
@@ -1,10 +1,20 @@
 #pragma once
 
-#include <timedata/base/enum.h>
-#include <timedata/color/models/rgb.h>
+#include <cstdint>
+#include <vector>
+
+#include <timedata/base/join_inl.h>
 
 namespace timedata {
 
+/** A Stripe is a walk through the indices of a list of some size.
+
+    Step k of the walk is at position begin + k * skip.  Each time the walk
+    runs off the end of the list in the direction of travel, it wraps back to
+    the other end and starts a new pass, and it is done after `repeats`
+    passes.  If `reflect` is true, every second pass runs backwards so the walk
+    bounces between the ends of the list.  Positions before the start of the
+    walk's first pass are gaps that don't touch the list. */
 struct Stripe {
     int begin = 0, skip = 1;
     size_t repeats = 1;  // Repeats == 0 means "repeat forever".
@@ -13,11 +23,19 @@ struct Stripe {
     class Iterator;
 };
 
+/** Return the number of steps in a stripe's walk over a list, or SIZE_MAX if
+    it repeats forever. */
+size_t stripeSteps(Stripe const&, size_t size);
+
+/** Return the list index of step k of a stripe's walk, or -1 if that step is a
+    gap, computed directly without stepping through the walk. */
+int64_t stripeIndex(Stripe const&, size_t size, size_t k);
+
 class Stripe::Iterator {
   public:
     Iterator(Stripe const&, size_t);
 
-    bool hasValue() const { return index_ >= 0 and index_ < int(size_); }
+    bool hasValue() const { return index_ >= 0; }
     size_t value() const { return static_cast<size_t>(index_); }
     bool done() const { return done_; }
     void next();
@@ -27,13 +45,45 @@ class Stripe::Iterator {
     void adjustIndex();
 
     Stripe const& stripe_;
-    size_t const size_;
-    int index_, repeat_ = 0;
+    size_t const size_, steps_;
+    size_t step_ = 0;
+    int64_t index_ = -1;
     bool done_ = false;
 };
 
+/** A run of index pairs starting at (in, out), each step moving by inSkip
+    and outSkip. */
+struct StripeRun {
+    uint32_t in, out, size;
+    int32_t inSkip, outSkip;
+};
+
+/** A pair of stripes over lists of fixed sizes, precompiled into runs of
+    index pairs so they can be applied repeatedly without walking the stripes
+    again. */
+struct StripeTable {
+    size_t inSize = 0, outSize = 0;
+    std::vector<StripeRun> runs;
+
+    /** The total number of index pairs. */
+    size_t size() const;
+};
+
+StripeTable compileStripes(
+    Stripe const& sIn, size_t inSize, Stripe const& sOut, size_t outSize);
+
+/** Call f(cIn[i], cOut[o]) on each pair of indices in a StripeTable.  Returns
+    false and does nothing if the containers don't match the table's sizes. */
+template <typename C1, typename C2, typename Function>
+bool combine(StripeTable const&, C1& cIn, C2& cOut, Function f);
+
+/** Copy cIn[i] to cOut[o] for each pair of indices in a StripeTable. */
+template <typename C1, typename C2>
+bool gather(StripeTable const&, C1 const& cIn, C2& cOut);
+
 template <typename C1, typename C2, typename Function>
-void combine(Stripe sIn, C1& cIn, Stripe sOut, C2& cOut, Function f) {
+void combine(Stripe const& sIn, C1& cIn, Stripe const& sOut, C2& cOut,
+             Function f) {
     if (not (sIn.repeats or sOut.repeats)) {
         log("Infinite loop in combiner.");
         return;
@@ -42,7 +92,7 @@ void combine(Stripe sIn, C1& cIn, Stripe sOut, C2& cOut, Function f) {
     for (Stripe::Iterator ii(sIn, cIn.size()), io(sOut, cOut.size());
          not (ii.done() or io.done()); ii.next(), io.next()) {
         if (ii.hasValue() and io.hasValue())
-            f(cIn[ii], cOut[io]);
+            f(cIn[ii.value()], cOut[io.value()]);
     }
 }
 
@@ -1,43 +1,168 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+
 #include <timedata/signal/stripe.h>
 
 namespace timedata {
 
-Stripe::Iterator::Iterator(Stripe const& stripe, size_t size)
+/** Implementation details follow. */
+
+namespace detail {
+
+/** Step k of a forward walk: the pass it is in and its position within the
+    list, or a negative position for a gap before the first pass. */
+inline void stripeForward(int64_t begin, int64_t skip, size_t size, size_t k,
+                          int64_t& pass, int64_t& position) {
+    auto p = begin + static_cast<int64_t>(k) * skip;
+    auto s = static_cast<int64_t>(size);
+    pass = p < 0 ? 0 : p / s;
+    position = p - pass * s;
+}
+
+/** A walk with a negative skip is the mirror image of a forward walk. */
+inline bool stripeMirrored(Stripe const& stripe) {
+    return stripe.skip < 0;
+}
+
+inline int64_t stripeForwardBegin(Stripe const& stripe, size_t size) {
+    auto begin = static_cast<int64_t>(stripe.begin);
+    return stripeMirrored(stripe) ? int64_t(size) - 1 - begin : begin;
+}
+
+} // detail
+
+inline size_t stripeSteps(Stripe const& stripe, size_t size) {
+    if (not (stripe.skip and size))
+        return 0;
+    if (not stripe.repeats)
+        return std::numeric_limits<size_t>::max();
+
+    // The walk is done at the first step at or past repeats * size.
+    auto begin = detail::stripeForwardBegin(stripe, size);
+    auto skip = std::abs(static_cast<int64_t>(stripe.skip));
+    auto end = static_cast<int64_t>(stripe.repeats * size) - begin;
+    return end <= 0 ? 0 : static_cast<size_t>((end + skip - 1) / skip);
+}
+
+inline int64_t stripeIndex(Stripe const& stripe, size_t size, size_t k) {
+    if (not (stripe.skip and size))
+        return -1;
+
+    int64_t pass, position;
+    auto skip = std::abs(static_cast<int64_t>(stripe.skip));
+    detail::stripeForward(detail::stripeForwardBegin(stripe, size), skip, size,
+                          k, pass, position);
+    if (position < 0)
+        return -1;
+
+    auto last = static_cast<int64_t>(size) - 1;
+    if (stripe.reflect and (pass & 1))
+        position = last - position;
+    return detail::stripeMirrored(stripe) ? last - position : position;
+}
+
+inline Stripe::Iterator::Iterator(Stripe const& stripe, size_t size)
         : stripe_(stripe),
           size_(size),
-          index_(stripe.begin),
-          done_(not stripe.skip) {
+          steps_(stripeSteps(stripe, size)),
+          done_(not steps_) {
     adjustIndex();
 }
 
 inline void Stripe::Iterator::adjustIndex() {
-    auto repeat = [&]() {
-        done_ = (stripe_.repeats <= ++repeat_ or not stripe_.repeats);
-        return done_;
-    };
-
-    while (not done_) {
-        if (stripe_.skip > 0 and index_ > size_ and repeat())
-            index_ = stripe_.reflect ? 2 * size_ - index_ : index_ - size_;
-        else if (stripe_.skip < 0 and index_ < 0 and repeat())
-            index_ = stripe_.reflect ? - index_ : index_ + size_;
-        else
-            return;
-    }
-    /* TODO: this is pretty neat, but inefficient if index_ is
-       either very much bigger than size_ or very negative. */
+    index_ = done_ ? -1 : stripeIndex(stripe_, size_, step_);
 }
 
 inline void Stripe::Iterator::next() {
-    if (not done_) {
+    if (done_) {
         log("Iterating when done!");
         return;
     }
 
-    index_ += stripe_.skip;
+    done_ = ++step_ >= steps_;
     adjustIndex();
 }
 
+inline size_t StripeTable::size() const {
+    size_t size = 0;
+    for (auto& run: runs)
+        size += run.size;
+    return size;
+}
+
+inline StripeTable compileStripes(
+        Stripe const& sIn, size_t inSize, Stripe const& sOut, size_t outSize) {
+    StripeTable table;
+    table.inSize = inSize;
+    table.outSize = outSize;
+    if (not (sIn.repeats or sOut.repeats)) {
+        log("Infinite loop in combiner.");
+        return table;
+    }
+
+    auto steps = std::min(stripeSteps(sIn, inSize), stripeSteps(sOut, outSize));
+    for (size_t k = 0; k < steps; ++k) {
+        auto i = stripeIndex(sIn, inSize, k), o = stripeIndex(sOut, outSize, k);
+        if (i < 0 or o < 0)
+            continue;
+
+        // Extend the last run if this pair continues it.
+        auto in = static_cast<uint32_t>(i), out = static_cast<uint32_t>(o);
+        if (not table.runs.empty()) {
+            auto& run = table.runs.back();
+            if (run.size == 1) {
+                run.inSkip = int32_t(in - run.in);
+                run.outSkip = int32_t(out - run.out);
+                ++run.size;
+                continue;
+            }
+            if (in == run.in + run.size * run.inSkip and
+                out == run.out + run.size * run.outSkip) {
+                ++run.size;
+                continue;
+            }
+        }
+        table.runs.push_back({in, out, 1, 0, 0});
+    }
+    return table;
+}
+
+template <typename C1, typename C2, typename Function>
+bool combine(StripeTable const& table, C1& cIn, C2& cOut, Function f) {
+    if (cIn.size() != table.inSize or cOut.size() != table.outSize)
+        return false;
+
+    for (auto& run: table.runs) {
+        auto in = &cIn[run.in];
+        auto out = &cOut[run.out];
+        auto inSkip = ptrdiff_t(run.inSkip), outSkip = ptrdiff_t(run.outSkip);
+        for (ptrdiff_t j = 0; j < ptrdiff_t(run.size); ++j)
+            f(in[j * inSkip], out[j * outSkip]);
+    }
+    return true;
+}
+
+template <typename C1, typename C2>
+bool gather(StripeTable const& table, C1 const& cIn, C2& cOut) {
+    if (cIn.size() != table.inSize or cOut.size() != table.outSize)
+        return false;
+
+    for (auto& run: table.runs) {
+        auto in = &cIn[run.in];
+        auto out = &cOut[run.out];
+        auto inSkip = ptrdiff_t(run.inSkip), outSkip = ptrdiff_t(run.outSkip);
+        if (inSkip == 1 and outSkip == 1) {
+            std::copy(in, in + run.size, out);
+        } else {
+            for (ptrdiff_t j = 0; j < ptrdiff_t(run.size); ++j)
+                out[j * outSkip] = in[j * inSkip];
+        }
+    }
+    return true;
+}
+
 } // timedata
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <timedata/signal/stripe_inl.h>
+
+namespace timedata {
+namespace stripe {
+
+namespace {
+
+/** The indices of a stripe's walk, found by stepping and wrapping one step at
+    a time, with -1 for gaps. */
+std::vector<int> walkStripe(Stripe const& stripe, int size, size_t maxSteps) {
+    std::vector<int> result;
+    if (not (stripe.skip and size))
+        return result;
+
+    int position = stripe.begin;
+    size_t pass = 0;
+    while (result.size() < maxSteps) {
+        auto forward = stripe.skip > 0;
+        while (forward ? position >= size : position < 0) {
+            position += forward ? -size : size;
+            ++pass;
+        }
+        if (stripe.repeats and pass >= stripe.repeats)
+            break;
+
+        auto inRange = position >= 0 and position < size;
+        auto index = stripe.reflect and (pass % 2) ? size - 1 - position :
+                position;
+        result.push_back(inRange ? index : -1);
+        position += stripe.skip;
+    }
+    return result;
+}
+
+Stripe makeStripe(int begin, int skip, size_t repeats = 1,
+                  bool reflect = false) {
+    Stripe stripe;
+    stripe.begin = begin;
+    stripe.skip = skip;
+    stripe.repeats = repeats;
+    stripe.reflect = reflect;
+    return stripe;
+}
+
+std::vector<int> iterateStripe(Stripe const& stripe, size_t size,
+                               size_t maxSteps) {
+    std::vector<int> result;
+    for (Stripe::Iterator i(stripe, size);
+         not i.done() and result.size() < maxSteps; i.next())
+        result.push_back(i.hasValue() ? int(i.value()) : -1);
+    return result;
+}
+
+std::vector<Stripe> testStripes() {
+    std::vector<Stripe> stripes;
+    for (auto begin: {-7, -1, 0, 3, 9, 25})
+        for (auto skip: {-11, -3, -1, 0, 1, 2, 5, 23})
+            for (auto repeats: {0, 1, 3})
+                for (auto reflect: {false, true})
+                    stripes.push_back(
+                        makeStripe(begin, skip, repeats, reflect));
+    return stripes;
+}
+
+} // namespace
+
+TEST_CASE("stripe", "[stripe]") {
+    REQUIRE(iterateStripe(makeStripe(0, 1), 4, 100) ==
+            (std::vector<int>{0, 1, 2, 3}));
+    REQUIRE(iterateStripe(makeStripe(2, 3, 3), 4, 100) ==
+            (std::vector<int>{2, 1, 0, 3}));
+    REQUIRE(iterateStripe(makeStripe(3, -1, 2, true), 4, 100) ==
+            (std::vector<int>{3, 2, 1, 0, 0, 1, 2, 3}));
+    REQUIRE(iterateStripe(makeStripe(-2, 1), 3, 100) ==
+            (std::vector<int>{-1, -1, 0, 1, 2}));
+    REQUIRE(iterateStripe(makeStripe(0, 1, 0), 2, 5) ==
+            (std::vector<int>{0, 1, 0, 1, 0}));
+    REQUIRE(stripeSteps(makeStripe(0, 1, 0), 2) == SIZE_MAX);
+    REQUIRE(stripeSteps(makeStripe(0, 0), 2) == 0);
+    REQUIRE(stripeSteps(makeStripe(0, 1), 0) == 0);
+
+    for (auto& stripe: testStripes()) {
+        for (auto size: {1, 4, 10}) {
+            auto expected = walkStripe(stripe, size, 200);
+            REQUIRE(iterateStripe(stripe, size, 200) == expected);
+            if (stripe.repeats)
+                REQUIRE(stripeSteps(stripe, size) == expected.size());
+        }
+    }
+
+    // A large skip takes the same time as a small one.
+    auto far = makeStripe(0, 1000000007, 2000000000);
+    REQUIRE(stripeSteps(far, 10) == 20);
+    REQUIRE(stripeIndex(far, 10, 19) == 3);
+}
+
+TEST_CASE("stripe tables", "[stripe]") {
+    std::vector<int> in(10);
+    for (size_t i = 0; i < in.size(); ++i)
+        in[i] = int(i) + 1;
+
+    auto stripes = testStripes();
+    for (auto& sIn: stripes) {
+        for (auto& sOut: stripes) {
+            if (not (sIn.repeats or sOut.repeats))
+                continue;
+            std::vector<int> out(7), expected(7);
+            auto copy = [](int x, int& y) { y = x; };
+            combine(sIn, in, sOut, expected, copy);
+
+            auto table = compileStripes(sIn, in.size(), sOut, out.size());
+            REQUIRE(gather(table, in, out));
+            REQUIRE(out == expected);
+
+            std::fill(out.begin(), out.end(), 0);
+            REQUIRE(combine(table, in, out, copy));
+            REQUIRE(out == expected);
+        }
+    }
+
+    // Contiguous pairs compile into a single run.
+    auto forward = makeStripe(0, 1), backward = makeStripe(99, -1);
+    auto table = compileStripes(forward, 100, backward, 100);
+    REQUIRE(table.runs.size() == 1);
+    REQUIRE(table.size() == 100);
+    REQUIRE(table.runs[0].out == 99);
+    REQUIRE(table.runs[0].outSkip == -1);
+
+    std::vector<int> out(5);
+    REQUIRE(not gather(table, in, out));
+}
+
+} // stripe
+} // timedata
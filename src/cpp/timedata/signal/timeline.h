@@ -0,0 +1,160 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <timedata/signal/fade.h>
+
+namespace timedata {
+
+/** A sequence of keyframes, each a list of samples at a time, that animates
+    from one keyframe to the next.
+
+    All the keyframes' lists have the same size.  Between two keyframes, the
+    frame is a crossfade of their lists, with the fader going from 0 to 1 and
+    the curve of the earlier keyframe's Fade::Type.  Before the first keyframe
+    the frame is the first list, and after the last keyframe it is the last
+    list.
+
+    Times are kept in an array of their own, so finding the segment for a time
+    is a binary search over contiguous doubles. */
+template <typename List>
+class Timeline {
+  public:
+    using Type = Fade::Type;
+
+    /** Add a keyframe at `time`, which fades to the next keyframe with a
+        curve of type `type`, replacing any keyframe already at that time.
+        Returns false and does nothing if the list is not the same size as the
+        other keyframes. */
+    bool add(double time, List const& list, Type type = Type::linear);
+
+    /** Remove the keyframe at index i. */
+    void remove(size_t i);
+    void clear();
+
+    /** The number of keyframes. */
+    size_t size() const { return times_.size(); }
+    bool empty() const { return times_.empty(); }
+
+    /** The size of each keyframe's list, or 0 if there are no keyframes. */
+    size_t listSize() const { return empty() ? 0 : lists_[0].size(); }
+
+    double time(size_t i) const { return times_[i]; }
+    List const& list(size_t i) const { return lists_[i]; }
+    Type type(size_t i) const { return types_[i]; }
+
+    /** Return the index of the last keyframe at or before time t, or 0 if t
+        is before the first keyframe. */
+    size_t segment(double t) const;
+
+    /** Put the frame at time t into `out`.  With no keyframes, `out` is
+        cleared.  This only allocates if `out` has to grow. */
+    void evaluate(double t, List& out) const;
+
+    /** Like evaluate, but remembers the segment that t fell into, so that
+        when t increases from call to call, as it does during playback, the
+        segment is usually found without a search. */
+    void stream(double t, List& out);
+
+    /** Forget the segment remembered by stream(). */
+    void rewind() { cursor_ = 0; }
+
+  private:
+    void evaluateSegment(size_t i, double t, List& out) const;
+
+    std::vector<double> times_;
+    std::vector<List> lists_;
+    std::vector<Type> types_;
+    size_t cursor_ = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Implementation details follow.
+
+template <typename List>
+bool Timeline<List>::add(double time, List const& list, Type type) {
+    if (not empty() and list.size() != listSize())
+        return false;
+
+    auto i = std::lower_bound(times_.begin(), times_.end(), time);
+    auto k = size_t(i - times_.begin());
+    if (i != times_.end() and *i == time) {
+        lists_[k] = list;
+        types_[k] = type;
+    } else {
+        times_.insert(i, time);
+        lists_.insert(lists_.begin() + k, list);
+        types_.insert(types_.begin() + k, type);
+    }
+    cursor_ = 0;
+    return true;
+}
+
+template <typename List>
+void Timeline<List>::remove(size_t i) {
+    times_.erase(times_.begin() + i);
+    lists_.erase(lists_.begin() + i);
+    types_.erase(types_.begin() + i);
+    cursor_ = 0;
+}
+
+template <typename List>
+void Timeline<List>::clear() {
+    times_.clear();
+    lists_.clear();
+    types_.clear();
+    cursor_ = 0;
+}
+
+template <typename List>
+size_t Timeline<List>::segment(double t) const {
+    auto i = std::upper_bound(times_.begin(), times_.end(), t);
+    return i == times_.begin() ? 0 : size_t(i - times_.begin()) - 1;
+}
+
+template <typename List>
+void Timeline<List>::evaluateSegment(size_t i, double t, List& out) const {
+    if (t <= times_[i] or i + 1 >= size()) {
+        out = lists_[i];
+        return;
+    }
+
+    Fade fade;
+    fade.type = types_[i];
+    auto fader = (t - times_[i]) / (times_[i + 1] - times_[i]);
+    fadeOver(float(fader), fade, lists_[i], lists_[i + 1], out);
+}
+
+template <typename List>
+void Timeline<List>::evaluate(double t, List& out) const {
+    if (empty())
+        out.clear();
+    else
+        evaluateSegment(segment(t), t, out);
+}
+
+template <typename List>
+void Timeline<List>::stream(double t, List& out) {
+    if (empty()) {
+        out.clear();
+        return;
+    }
+
+    // Try the remembered segment and the one after it before searching.
+    auto inSegment = [&](size_t i) {
+        return i < size() and (i == 0 or times_[i] <= t) and
+            (i + 1 == size() or t < times_[i + 1]);
+    };
+    if (not inSegment(cursor_)) {
+        if (inSegment(cursor_ + 1))
+            ++cursor_;
+        else
+            cursor_ = segment(t);
+    }
+    evaluateSegment(cursor_, t, out);
+}
+
+} // timedata
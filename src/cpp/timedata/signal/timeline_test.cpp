@@ -0,0 +1,97 @@
+#pragma once
+
+#include <timedata/signal/timeline.h>
+
+namespace timedata {
+namespace color_list {
+namespace timeline {
+
+using Timeline = timedata::Timeline<CColorListRGB>;
+
+TEST_CASE("timeline", "[timeline]") {
+    Timeline timeline;
+    CColorListRGB out = randomColors(3);
+    timeline.evaluate(1, out);
+    REQUIRE(out.empty());
+
+    auto a = randomColors(50), b = randomColors(50), c = randomColors(50);
+    REQUIRE(timeline.add(2, c, Fade::Type::sqr));
+    REQUIRE(timeline.add(0, a));
+    REQUIRE(timeline.add(1, b, Fade::Type::sqrt));
+    REQUIRE(not timeline.add(3, randomColors(49)));
+    REQUIRE(timeline.size() == 3);
+    REQUIRE(timeline.listSize() == 50);
+    REQUIRE(timeline.time(1) == 1);
+    REQUIRE(timeline.list(2) == c);
+    REQUIRE(timeline.type(1) == Fade::Type::sqrt);
+
+    REQUIRE(timeline.segment(-1) == 0);
+    REQUIRE(timeline.segment(0) == 0);
+    REQUIRE(timeline.segment(0.5) == 0);
+    REQUIRE(timeline.segment(1) == 1);
+    REQUIRE(timeline.segment(5) == 2);
+
+    // Outside the keyframes, and exactly on them.
+    timeline.evaluate(-1, out);
+    REQUIRE(out == a);
+    timeline.evaluate(1, out);
+    REQUIRE(out == b);
+    timeline.evaluate(2, out);
+    REQUIRE(out == c);
+    timeline.evaluate(7, out);
+    REQUIRE(out == c);
+
+    // Between keyframes, with the earlier keyframe's curve.
+    Fade fade;
+    fade.type = Fade::Type::sqrt;
+    CColorListRGB expected;
+    fadeOver(0.25f, fade, b, c, expected);
+    timeline.evaluate(1.25, out);
+    REQUIRE(out == expected);
+
+    fade.type = Fade::Type::linear;
+    fadeOver(0.5f, fade, a, b, expected);
+    timeline.evaluate(0.5, out);
+    REQUIRE(out == expected);
+
+    // Replacing a keyframe.
+    REQUIRE(timeline.add(1, a));
+    REQUIRE(timeline.size() == 3);
+    timeline.evaluate(0.5, out);
+    REQUIRE(out == a);
+
+    timeline.remove(0);
+    REQUIRE(timeline.time(0) == 1);
+    timeline.clear();
+    REQUIRE(timeline.empty());
+    REQUIRE(timeline.listSize() == 0);
+}
+
+TEST_CASE("timeline stream matches evaluate", "[timeline]") {
+    Timeline timeline;
+    for (auto i = 0; i < 20; ++i)
+        timeline.add(i * 0.5, randomColors(10), Fade::Type(i % 3));
+
+    // Forward in small and large steps, then backward.
+    std::vector<double> times;
+    for (auto t = -1.0; t < 12; t += 0.1)
+        times.push_back(t);
+    for (auto t: {3.0, 3.0, 9.5, 10.0, 0.2, -5.0, 4.75})
+        times.push_back(t);
+
+    CColorListRGB streamed, evaluated;
+    for (auto t: times) {
+        timeline.stream(t, streamed);
+        timeline.evaluate(t, evaluated);
+        REQUIRE(streamed == evaluated);
+    }
+
+    timeline.rewind();
+    timeline.stream(8.2, streamed);
+    timeline.evaluate(8.2, evaluated);
+    REQUIRE(streamed == evaluated);
+}
+
+} // timeline
+} // color_list
+} // timedata
@@ -8,14 +8,19 @@ What do we need to know when reporting a test?
       compilation flags (string)
       size:  (number of "items" in the test)
       results:
-         test name: test result
+         test name: median test result
          ...
+      repetitions:
+         test name: [each test result]
+         ...
+
+compare.py reads these files back and compares them.
 """
 
 import collections, datetime, importlib, json, os, pathlib, platform, sys
-import time, timeit
+import statistics, time, timeit
 
-from . import lists
+from . import convert, fade, generate, lists, render
 
 # The format for timestamps and thus filenames.
 TIMESTAMP_FORMAT = '%Y%m%d-%H%M%S'
@@ -66,7 +71,7 @@ def version():
     return (platform.version(), '', '')
 
 
-def run_benchmarks(args, filename_suffix, size, number):
+def run_benchmarks(args, filename_suffix, size, number, repeat=5):
     # Read and remove flags.
     for arg in args:
         if arg.startswith('--'):
@@ -75,6 +80,8 @@ def run_benchmarks(args, filename_suffix, size, number):
                 size = int(value)
             elif name == '--number':
                 number = int(value)
+            elif name == '--repeat':
+                repeat = int(value)
             else:
                 raise ValueError('Bad flag ' + name)
     args = [a for a in args if not a.startswith('--')]
@@ -82,6 +89,7 @@ def run_benchmarks(args, filename_suffix, size, number):
     metadata = dict(
         size=size,
         number=number,
+        repeat=repeat,
         optimization_flags=timedata.optimization_flags(),
         git_tags=timedata.git_tags(),
         platform=dict(
@@ -96,11 +104,14 @@ def run_benchmarks(args, filename_suffix, size, number):
         except:
             print(sys.path)
             raise
-        results = dict()
+        results, repetitions = dict(), dict()
         for test, function in module.benchmarks():
             data = module.make_data(size)
             timer = timeit.Timer(lambda: function(*data))
-            results[test] = timer.timeit(number=number)
+            times = timer.repeat(repeat=int(repeat), number=number)
+            results[test] = statistics.median(times)
+            repetitions[test] = times
 
         write_result(name, filename_suffix,
-                     results=sorted_dict(**results), **metadata)
+                     results=sorted_dict(**results),
+                     repetitions=sorted_dict(**repetitions), **metadata)
@@ -0,0 +1,260 @@
+#!/usr/bin/env python3
+
+"""
+Read back the results that write_result() and build/benchmark leave under
+results/, and compare them.
+
+Result files are grouped into configurations, which have the same name,
+git_tags, optimization_flags and size.  The times for each test in a
+configuration are pooled over all its files and repetitions, and summarized
+by their median and their median absolute deviation (MAD), which a single
+slow run can't skew the way it skews a total or a mean.
+
+A test regresses if its median time grows by more than --threshold, and if
+the growth is also more than --noise times the combined spread of the two
+configurations, so that noisy tests don't fail by chance.
+
+    # Compare the latest results with the latest other configuration.
+    $ python3 -m benchmark.compare
+
+    # Compare two configurations from a flag sweep, selected by any part of
+    # their file names, git tags or optimization flags.
+    $ python3 -m benchmark.compare --baseline=o3.json --candidate=fast-math
+
+    # Show how each test has changed over the history.
+    $ python3 -m benchmark.compare --trend --name=lists
+
+The exit status is 1 if any test regressed, and 2 if there was nothing to
+compare.
+"""
+
+import argparse, collections, json, math, pathlib, statistics, sys
+
+# The MAD times this estimates the standard deviation of normal data.
+MAD_SCALE = 1.4826
+
+Configuration = collections.namedtuple(
+    'Configuration', 'name git_tags optimization_flags size')
+
+Summary = collections.namedtuple('Summary', 'median mad count')
+
+Comparison = collections.namedtuple(
+    'Comparison', 'test baseline candidate speedup regression')
+
+
+class ResultSet(object):
+    """The results from one JSON file, as seconds per call of each test."""
+
+    def __init__(self, filename, data):
+        self.filename = str(filename)
+        self.data = data
+        self.configuration = Configuration(
+            data.get('name', ''),
+            data.get('git_tags', ''),
+            data.get('optimization_flags', ''),
+            data.get('size'))
+
+        # Python benchmarks time `number` calls; native ones time one call.
+        number = data.get('number') or 1
+        repetitions = data.get('repetitions') or {}
+        if not isinstance(repetitions, dict):
+            repetitions = {}
+
+        self.times = {}
+        for test, total in data.get('results', {}).items():
+            totals = repetitions.get(test) or [total]
+            self.times[test] = [t / number for t in totals]
+
+    def sort_key(self):
+        # Files are named results/<name>/<date>/<time>[-<suffix>].json.
+        path = pathlib.Path(self.filename)
+        return path.parent.name, path.name
+
+    def matches(self, text):
+        c = self.configuration
+        return any(text in s for s in
+                   (self.filename, c.git_tags, c.optimization_flags))
+
+
+def load(*paths):
+    """Load every result file in a list of files and directories, oldest
+       first."""
+    result_sets = []
+    for path in paths:
+        path = pathlib.Path(path)
+        files = sorted(path.rglob('*.json')) if path.is_dir() else [path]
+        for f in files:
+            with f.open() as fp:
+                result_sets.append(ResultSet(f, json.load(fp)))
+    return sorted(result_sets, key=ResultSet.sort_key)
+
+
+def group(result_sets):
+    """Return an OrderedDict from each configuration to its result sets,
+       with the configurations in order of their most recent result."""
+    groups = collections.OrderedDict()
+    for r in result_sets:
+        groups.setdefault(r.configuration, []).append(r)
+    latest = lambda item: item[1][-1].sort_key()
+    return collections.OrderedDict(sorted(groups.items(), key=latest))
+
+
+def median_absolute_deviation(samples, median=None):
+    if median is None:
+        median = statistics.median(samples)
+    return statistics.median(abs(s - median) for s in samples)
+
+
+def summarize(result_sets):
+    """Return a dict from each test to a Summary of its times over all the
+       result sets."""
+    pooled = {}
+    for r in result_sets:
+        for test, times in r.times.items():
+            pooled.setdefault(test, []).extend(times)
+
+    summaries = {}
+    for test, times in pooled.items():
+        median = statistics.median(times)
+        mad = median_absolute_deviation(times, median)
+        summaries[test] = Summary(median, mad, len(times))
+    return summaries
+
+
+def compare(baseline, candidate, threshold=0.05, noise=3):
+    """Compare two dicts of Summaries, returning a Comparison for each test
+       that is in both, in test order."""
+    comparisons = []
+    for test in sorted(set(baseline) & set(candidate)):
+        b, c = baseline[test], candidate[test]
+        speedup = b.median / c.median if c.median else math.inf
+        spread = noise * MAD_SCALE * math.hypot(b.mad, c.mad)
+        slowdown = c.median - b.median
+        regression = (slowdown > threshold * b.median and slowdown > spread)
+        comparisons.append(Comparison(test, b, c, speedup, regression))
+    return comparisons
+
+
+def select(groups, text, exclude=None, like=None):
+    """Return the most recent configuration with a result set matching text,
+       other than `exclude` and with the same name and size as `like`."""
+    for configuration, result_sets in reversed(groups.items()):
+        if configuration == exclude:
+            continue
+        if like and (configuration.name, configuration.size) != (
+                like.name, like.size):
+            continue
+        if not text or any(r.matches(text) for r in result_sets):
+            return configuration
+
+
+def format_time(seconds):
+    for unit, scale in (('s', 1), ('ms', 1e3), ('us', 1e6)):
+        if seconds >= 1 / scale:
+            return '%.3f%s' % (seconds * scale, unit)
+    return '%.3fns' % (seconds * 1e9)
+
+
+def format_summary(s):
+    if not s.median:
+        return format_time(s.median)
+    return '%s ±%.1f%%' % (format_time(s.median), 100 * s.mad / s.median)
+
+
+def describe(configuration):
+    c = configuration
+    size = '' if c.size is None else ', size %s' % c.size
+    return '%s: %s %s%s' % (c.name, c.git_tags, c.optimization_flags, size)
+
+
+def report_comparison(comparisons, file=None):
+    width = max([len(c.test) for c in comparisons] + [4])
+    print('%-*s %20s %20s %8s' % (width, 'test', 'baseline', 'candidate',
+                                   'speedup'), file=file)
+    for c in comparisons:
+        print('%-*s %20s %20s %7.3fx%s' % (
+            width, c.test, format_summary(c.baseline),
+            format_summary(c.candidate), c.speedup,
+            '  REGRESSION' if c.regression else ''), file=file)
+
+
+def report_trend(groups, file=None):
+    """For each name and size, print each configuration in order with the
+       geometric mean of its speedups over the first configuration."""
+    by_name = collections.OrderedDict()
+    for configuration, result_sets in groups.items():
+        key = configuration.name, configuration.size
+        by_name.setdefault(key, []).append((configuration, result_sets))
+
+    for (name, size), configurations in by_name.items():
+        print('%s%s' % (name, '' if size is None else ' (size %s)' % size),
+              file=file)
+        first = None
+        for i, (configuration, result_sets) in enumerate(configurations):
+            summaries = summarize(result_sets)
+            first = first or summaries
+            ratios = [first[t].median / s.median
+                      for t, s in summaries.items()
+                      if t in first and s.median]
+            geomean = (math.exp(statistics.mean(math.log(r) for r in ratios))
+                       if ratios else math.nan)
+            print('  %2d  %7.3fx  %s %s' % (
+                i, geomean, configuration.git_tags,
+                configuration.optimization_flags), file=file)
+
+
+def main(args=None):
+    parser = argparse.ArgumentParser(
+        description='Compare benchmark results.',
+        epilog='Selectors match any part of a file name, git tag or '
+        'optimization flags.')
+    parser.add_argument('paths', nargs='*', default=['results'],
+                        help='result files or directories')
+    parser.add_argument('--name', default='',
+                        help='only use results with this benchmark name')
+    parser.add_argument('--baseline', default='',
+                        help='select the baseline configuration')
+    parser.add_argument('--candidate', default='',
+                        help='select the candidate configuration')
+    parser.add_argument('--threshold', type=float, default=0.05,
+                        help='the slowdown that counts as a regression')
+    parser.add_argument('--noise', type=float, default=3,
+                        help='how many standard deviations of noise a '
+                        'regression must exceed')
+    parser.add_argument('--trend', action='store_true',
+                        help='report the history instead of comparing')
+    args = parser.parse_args(args)
+
+    result_sets = [r for r in load(*args.paths)
+                   if not args.name or r.configuration.name == args.name]
+    groups = group(result_sets)
+    if not groups:
+        print('No results in', *args.paths, file=sys.stderr)
+        return 2
+
+    if args.trend:
+        report_trend(groups)
+        return 0
+
+    candidate = select(groups, args.candidate)
+    baseline = candidate and select(
+        groups, args.baseline, exclude=candidate, like=candidate)
+    if not baseline:
+        print('Need two configurations to compare', file=sys.stderr)
+        return 2
+
+    comparisons = compare(summarize(groups[baseline]),
+                          summarize(groups[candidate]),
+                          args.threshold, args.noise)
+    print('baseline: ', describe(baseline))
+    print('candidate:', describe(candidate))
+    report_comparison(comparisons)
+
+    regressions = sum(c.regression for c in comparisons)
+    if regressions:
+        print('%d of %d tests regressed' % (regressions, len(comparisons)))
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
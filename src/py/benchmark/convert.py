@@ -0,0 +1,38 @@
+"""Compare converting a whole list between color models with converting it
+one sample at a time, and time constructing single samples from another
+model.
+
+Run with:
+
+    TIMEDATA_BENCHMARK=convert ./setup.py benchmark
+"""
+
+from timedata import ColorHSV, ColorListHSV, ColorListRGB, ColorRGB
+
+
+def make_data(size):
+    hsv = ColorListHSV().resize(size)
+    for i in range(size):
+        hsv[i] = (i % 256) / 255, (i % 7) / 6, (i % 11) / 10
+    return hsv, ColorListRGB(hsv)
+
+
+SAMPLES = [ColorHSV(i / 1000, 0.5, 0.75) for i in range(1000)]
+
+
+def benchmarks():
+    def hsv_to_rgb(hsv, rgb):
+        ColorListRGB(hsv)
+
+    def rgb_to_hsv(hsv, rgb):
+        ColorListHSV(rgb)
+
+    def hsv_to_rgb_by_sample(hsv, rgb):
+        ColorListRGB([ColorRGB(c) for c in hsv])
+
+    def samples_hsv_to_rgb(hsv, rgb):
+        # Only the cross-model constructors, without making a list.
+        for c in SAMPLES:
+            ColorRGB(c)
+
+    return sorted(locals().items())
@@ -0,0 +1,38 @@
+"""Compare crossfading and mixing whole lists with doing it in Python.
+
+Run with:
+
+    TIMEDATA_BENCHMARK=fade ./setup.py benchmark
+"""
+
+from timedata import ColorList, Fade, mix
+
+DEFAULT_SIZE = 10240
+
+FADE = Fade(type='sqr')
+
+
+def make_data(size):
+    x = ColorList().resize(size)
+    for i in range(size):
+        x[i] = (i % 256) / 255, (i % 7) / 6, (i % 11) / 10
+    return x, x.copy().invert()
+
+
+def benchmarks():
+    def fade(x, y):
+        FADE(0.3, x, y, x)
+
+    def fade_new_list(x, y):
+        FADE(0.3, x, y)
+
+    def mix_three(x, y):
+        mix([x, y, x], [0.2, 0.3, 0.5], x)
+
+    def fade_by_sample(x, y):
+        # A loop in Python, as crossfading had to be done before.
+        a, b = 0.7 * 0.7, 0.3 * 0.3
+        ColorList([(a * p + b * q, a * r + b * s, a * t + b * u)
+                   for (p, r, t), (q, s, u) in zip(x, y)])
+
+    return sorted(locals().items())
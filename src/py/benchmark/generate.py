@@ -0,0 +1,50 @@
+"""Compare filling ColorLists with the signal generators against computing
+the same waves and ramps per color in Python.
+
+Run with:
+
+    TIMEDATA_BENCHMARK=generate ./setup.py benchmark
+"""
+
+import math
+
+from timedata import ColorList, Noise, Oscillator, Ramp
+
+SINE = Oscillator(step=0.01)
+TRIANGLE = Oscillator(wave='triangle', step=0.01)
+NOISE = Noise(scale=0.05, time=0.5)
+
+
+def make_data(size):
+    return ColorList().resize(size),
+
+
+def benchmarks():
+    def sine(out):
+        SINE(out)
+
+    def sine_one_channel(out):
+        SINE(out, 1)
+
+    def triangle(out):
+        TRIANGLE(out)
+
+    def noise(out):
+        NOISE(out)
+
+    def ramp(out):
+        Ramp(end=len(out))(out)
+
+    def sine_by_sample(out):
+        # A loop in Python with math.sin, as pulses had to be done before.
+        for i in range(len(out)):
+            v = 0.5 - 0.5 * math.cos(2 * math.pi * 0.01 * i)
+            out[i] = v, v, v
+
+    def ramp_by_sample(out):
+        size = len(out)
+        for i in range(size):
+            v = i / size
+            out[i] = v, v, v
+
+    return sorted(locals().items())
@@ -43,4 +43,22 @@ def benchmarks():
     def add_to_number(x, y):
         x.add_to(0, y)
 
+    def chain(x, y):
+        x.mul(y).add(y).pow(2).min_limit(0).max_limit(1)
+
+    def chain_expression(x, y):
+        x.expression().mul(y).add(y).pow(2).min_limit(0).max_limit(1).into(x)
+
+    def to_tuples(x, y):
+        [tuple(c) for c in x]
+
+    def to_buffer(x, y):
+        memoryview(x).tolist()
+
+    def from_tuples(x, y):
+        ColorList(x)
+
+    def from_buffer(x, y):
+        ColorList.from_buffer(x)
+
     return sorted(locals().items())
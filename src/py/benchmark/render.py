@@ -0,0 +1,87 @@
+"""Compare the rendering kernels for each instruction set and each output
+against each other, rendering many strips in one call against rendering
+them one at a time, and the full gamma tables against the compact ones when
+many renderers with different gammas share the cache.
+
+Run with:
+
+    TIMEDATA_BENCHMARK=render ./setup.py benchmark
+"""
+
+from timedata import ColorList, Renderer, SegmentRenderer, ISA_NAMES
+
+RENDERERS = {isa: Renderer(gamma=2.5, permutation='grb', isa=isa)
+             for isa in ISA_NAMES}
+
+OUTPUTS = 'dither8', 'bits16'
+OUTPUT_RENDERERS = {o: Renderer(gamma=2.5, permutation='grb', output=o)
+                    for o in OUTPUTS}
+
+# Strips with two different chipsets.
+STRIPS = 32
+STRIP_SETTINGS = (dict(gamma=2.5, permutation='grb'),
+                  dict(gamma=2.2, permutation='brg'))
+STRIP_RENDERERS = [Renderer(**s) for s in STRIP_SETTINGS]
+
+# Strips which each have their own gamma, and so their own table.
+GAMMAS = 64
+TABLES = 'full', 'compact'
+
+
+def make_data(size):
+    colors = ColorList().resize(size)
+    for i in range(size):
+        colors[i] = (i % 256) / 255, (i % 7) / 6, (i % 11) / 10
+    # Big enough for the bits16 output.
+    return colors, bytearray(6 * size)
+
+
+def benchmarks():
+    def render(isa):
+        renderer = RENDERERS[isa]
+        return lambda colors, output: renderer.render(colors, output)
+
+    def strips(size):
+        step = -(-size // STRIPS)
+        return [(b, min(b + step, size)) for b in range(0, size, step)]
+
+    def render_strips(colors, output):
+        for i, (begin, end) in enumerate(strips(len(colors))):
+            r = STRIP_RENDERERS[i % len(STRIP_RENDERERS)]
+            output[3 * begin:3 * end] = r.render(colors[begin:end])
+
+    segment_renderers = {}
+
+    def render_segments(colors, output):
+        size = len(colors)
+        if size not in segment_renderers:
+            segment_renderers[size] = SegmentRenderer(
+                (b, e, 3 * b, STRIP_SETTINGS[i % len(STRIP_SETTINGS)])
+                for i, (b, e) in enumerate(strips(size)))
+        segment_renderers[size].render(colors, output)
+
+    gamma_renderers = {}
+
+    def render_gammas(table):
+        def render(colors, output):
+            size = len(colors)
+            key = size, table
+            if key not in gamma_renderers:
+                step = -(-size // GAMMAS)
+                gamma_renderers[key] = SegmentRenderer(
+                    (b, min(b + step, size), 3 * b,
+                     dict(gamma=1.5 + b / size, table=table))
+                    for b in range(0, size, step))
+            gamma_renderers[key].render(colors, output)
+        return render
+
+    def render_output(o):
+        renderer = OUTPUT_RENDERERS[o]
+        return lambda colors, output: renderer.render(colors, output)
+
+    results = [('render_' + isa, render(isa)) for isa in ISA_NAMES]
+    results += [('render_' + o, render_output(o)) for o in OUTPUTS]
+    results += [('render_gammas_' + t, render_gammas(t)) for t in TABLES]
+    results += [('render_strips', render_strips),
+                ('render_segments', render_segments)]
+    return sorted(results)
@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+
+"""
+A representative workload for profile-guided optimization: rendering, list
+arithmetic, conversion, fades, generators and parsing and printing colors.
+
+`TIMEDATA_BUILDTYPE=pgo ./setup.py build_ext` runs this on an instrumented
+build of timedata, and then rebuilds timedata using the profile it leaves.
+
+It reuses the benchmarks, which cover the hot paths, at a range of sizes so
+that the profile sees both the short lists of a single strip and the long
+lists that are split across threads.  The `_by_sample` benchmarks are
+baselines that do their work in Python, so they add nothing to the profile and
+are skipped.
+"""
+
+import sys
+
+from timedata import Color, ColorList
+
+from . import convert, fade, generate, lists, render
+
+MODULES = convert, fade, generate, lists, render
+
+SIZES = 16, 256, 4096, 65536
+
+# Each benchmark runs on about this many elements at each size.
+ELEMENTS = 1 << 18
+
+STRINGS = ('red', 'gray 50', 'grey 25', '0xff8000', '0.5, 0.25, 0.125',
+           'red-++', 'light goldenrod yellow', 'white---')
+
+
+def parse(rounds):
+    """Parse color names and numbers, and print colors back as strings."""
+    names = Color.names
+    for i in range(rounds):
+        cl = ColorList(names + STRINGS)
+        str(cl)
+        for s in STRINGS:
+            str(Color(s))
+
+
+def training_benchmarks(module):
+    return [(test, function) for test, function in module.benchmarks()
+            if not test.endswith('_by_sample')]
+
+
+def train(sizes=SIZES, elements=ELEMENTS, file=None):
+    for module in MODULES:
+        for size in sizes:
+            data = module.make_data(size)
+            repeat = max(1, elements // size)
+            for test, function in training_benchmarks(module):
+                print(module.__name__, test, size, file=file)
+                for i in range(repeat):
+                    function(*data)
+
+    print('parse', file=file)
+    parse(max(1, elements // 65536))
+
+
+if __name__ == '__main__':
+    train(file=sys.stderr)
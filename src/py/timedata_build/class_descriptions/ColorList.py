@@ -10,9 +10,9 @@ documentation = 'FIXME'
 
 methods = add_methods(
     methods,
-    base='sample_list',
+    base=('sample_list', 'buffer', 'expression_source'),
     zero=dict(
-        simple_mutator=('clear', 'zero'),
+        simple_mutator=('zero',),
         mutator=('abs', 'floor', 'ceil', 'invert', 'neg', 'reverse', 'trunc'),
         ),
 
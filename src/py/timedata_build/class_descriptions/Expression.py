@@ -0,0 +1,25 @@
+from timedata_build.util import add_methods
+
+include_file = 'timedata/color/cython_list_inl.h'
+namespace = 'timedata::color_list'
+number_type = 'float'
+
+methods = add_methods(
+    {},
+    base='expression',
+    zero=dict(
+        expression_op=('abs', 'ceil', 'floor', 'invert', 'neg', 'trunc'),
+        ),
+
+    one=dict(
+        expression_op=('add', 'div', 'mul', 'pow', 'sub', 'rdiv', 'rpow',
+                       'rsub', 'max_limit', 'min_limit'),
+        ),
+)
+
+substitutions = dict(
+    classname='$name',
+    listclass='$listclass',
+    sampleclass='$sampleclass',
+    output_file='build/genfiles/timedata/color/$name.pyx',
+    )
@@ -4,7 +4,10 @@ import os
 from . import read_classes, write_classes, make_structs, util
 
 
-STRUCT_FILES = ['timedata/signal/render3']
+STRUCT_FILES = [
+    'timedata/signal/fade', 'timedata/signal/noise',
+    'timedata/signal/oscillator', 'timedata/signal/ramp',
+    'timedata/signal/render3']
 
 
 def generate(tiny=False, models=''):
@@ -1,4 +1,4 @@
-from . class_descriptions import Color, ColorList
+from . class_descriptions import Color, ColorList, Expression
 from . util import substitute_context
 
 MODELS = (
@@ -35,3 +35,6 @@ def read_classes(tiny=False, models=[]):
 
             yield sub(Color, cname)
             yield sub(ColorList, lname, sampleclass=cname)
+            yield substitute_context(
+                Expression.__dict__, name=lname + 'Expression',
+                listclass=lname, sampleclass=cname)
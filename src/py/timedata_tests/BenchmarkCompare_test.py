@@ -0,0 +1,73 @@
+import contextlib, io, json, pathlib, tempfile, unittest
+
+from benchmark import compare
+
+
+def write(root, name, date, time, results, repetitions=None, **kwds):
+    directory = pathlib.Path(root, 'results', name, date)
+    directory.mkdir(parents=True, exist_ok=True)
+    data = dict(name=name, git_tags='v1', optimization_flags='-O3',
+                size=100, number=10, results=results)
+    data.update(kwds)
+    if repetitions:
+        data['repetitions'] = repetitions
+    with directory.joinpath(time + '.json').open('w') as fp:
+        json.dump(data, fp)
+
+
+class TestBenchmarkCompare(unittest.TestCase):
+    def setUp(self):
+        self.directory = tempfile.TemporaryDirectory()
+        self.root = self.directory.name
+
+    def tearDown(self):
+        self.directory.cleanup()
+
+    def test_statistics(self):
+        self.assertEqual(
+            compare.median_absolute_deviation([1, 2, 3, 4, 100]), 1)
+
+        write(self.root, 'lists', '20160101', '010101', {'a': 20},
+              {'a': [10, 20, 30, 1000]})
+        write(self.root, 'native', '20160101', '010102', {'b': 0.5},
+              number=None)
+        old, native = compare.load(self.root)
+        self.assertEqual(old.times, {'a': [1, 2, 3, 100]})
+        self.assertEqual(native.times, {'b': [0.5]})
+
+        summary = compare.summarize([old])['a']
+        self.assertEqual(summary, compare.Summary(2.5, 1, 4))
+
+    def test_regression(self):
+        noisy = [9, 10, 11, 10, 16]
+        write(self.root, 'lists', '20160101', '010101',
+              {'fast': 100, 'same': 100, 'slow': 100, 'noisy': 100},
+              {'noisy': [10 * n for n in noisy]})
+        write(self.root, 'lists', '20160102', '010101',
+              {'fast': 50, 'same': 102, 'slow': 200, 'noisy': 120},
+              {'noisy': [12 * n for n in noisy]},
+              optimization_flags='-O3 -ffast-math')
+
+        groups = compare.group(compare.load(self.root))
+        baseline, candidate = groups
+        self.assertEqual(candidate.optimization_flags, '-O3 -ffast-math')
+
+        comparisons = compare.compare(compare.summarize(groups[baseline]),
+                                      compare.summarize(groups[candidate]))
+        self.assertEqual([c.test for c in comparisons],
+                         ['fast', 'noisy', 'same', 'slow'])
+        self.assertEqual([c.regression for c in comparisons],
+                         [False, False, False, True])
+        self.assertEqual(comparisons[0].speedup, 2)
+
+        results = str(pathlib.Path(self.root, 'results'))
+        def main(*args):
+            with contextlib.redirect_stdout(io.StringIO()):
+                with contextlib.redirect_stderr(io.StringIO()):
+                    return compare.main([results] + list(args))
+
+        self.assertEqual(main('--candidate=v1'), 1)
+        self.assertEqual(main('--baseline=fast-math', '--candidate=20160101',
+                              '--threshold=2'), 0)
+        self.assertEqual(main('--trend'), 0)
+        self.assertEqual(main('--name=other'), 2)
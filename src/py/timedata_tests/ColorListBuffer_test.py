@@ -0,0 +1,117 @@
+import array, struct, unittest
+
+import timedata
+from timedata import *
+
+
+class TestColorListBuffer(unittest.TestCase):
+    def test_export(self):
+        cl = ColorList([(0.25, 0.5, 1), (2, 3, 4)])
+        m = memoryview(cl)
+        self.assertEqual(m.format, 'f')
+        self.assertEqual(m.itemsize, 4)
+        self.assertEqual(m.shape, (2, 3))
+        self.assertEqual(m.strides, (12, 4))
+        self.assertFalse(m.readonly)
+        self.assertTrue(m.c_contiguous)
+        self.assertEqual(m.tolist(), [[0.25, 0.5, 1], [2, 3, 4]])
+        self.assertEqual(bytes(m), struct.pack('6f', 0.25, 0.5, 1, 2, 3, 4))
+        m.release()
+
+    def test_export_empty(self):
+        m = memoryview(ColorList())
+        self.assertEqual(m.shape, (0, 3))
+        self.assertEqual(m.tolist(), [])
+
+    def test_export_writes_through(self):
+        cl = ColorList([(0, 0, 0), (0, 0, 0)])
+        with memoryview(cl) as m:
+            m[1, 2] = 0.5
+        self.assertEqual(cl, ColorList([(0, 0, 0), (0, 0, 0.5)]))
+
+    def test_all_lists(self):
+        # A tiny build only has some of the list classes.
+        for name in 'RGB', 'HSV', 'RGB255', 'RGB256':
+            cls = getattr(timedata, 'ColorList' + name, None)
+            if not cls:
+                continue
+            cl = cls([(1, 2, 3)])
+            with memoryview(cl) as m:
+                self.assertEqual(m.tolist(), [[1, 2, 3]])
+            self.assertEqual(cls.from_buffer(cl), cl)
+
+    def test_not_a_buffer_copy(self):
+        # ColorListHSV exports a float32 buffer, which must not be copied
+        # into a ColorListRGB without converting it.
+        hsv = ColorListHSV([(0.5, 1, 1)])
+        self.assertEqual(ColorListRGB(hsv), ColorListRGB([(0, 1, 1)]))
+
+    def test_no_resize_while_exported(self):
+        cl = ColorList([(0, 0, 0), (1, 1, 1)])
+        other = ColorList([(1, 2, 3)] * 3)
+        m = memoryview(cl)
+
+        resizes = [
+            lambda: cl.append(Color()),
+            lambda: cl.extend([(0, 0, 0)]),
+            lambda: cl.insert(0, Color()),
+            lambda: cl.pop(),
+            lambda: cl.resize(5),
+            lambda: cl.clear(),
+            lambda: cl.__delitem__(0),
+            lambda: cl.__setitem__(slice(0, 1), other),
+            lambda: cl.__iadd__(other),
+            lambda: cl.__imul__(2),
+            lambda: other.add_to(1, cl),
+            lambda: other.abs_to(cl),
+            lambda: other.expression().into(cl),
+        ]
+        for resize in resizes:
+            with self.assertRaises(BufferError):
+                resize()
+        self.assertEqual(len(cl), 2)
+
+        # Operations that keep the size are still fine.
+        cl.add(1).resize(2)
+        cl[:] = other[:2]
+        self.assertEqual(cl, other[:2])
+
+        m.release()
+        cl.append(Color())
+        self.assertEqual(len(cl), 3)
+
+    def test_from_buffer(self):
+        floats = [0.5, 1, 2, 3, 4, 5]
+        expected = ColorList([(0.5, 1, 2), (3, 4, 5)])
+        a = array.array('f', floats)
+        self.assertEqual(ColorList.from_buffer(a), expected)
+
+        shaped = memoryview(a).cast('B').cast('f', (2, 3))
+        self.assertEqual(ColorList.from_buffer(shaped), expected)
+        self.assertEqual(ColorList(shaped), expected)
+        self.assertEqual(ColorList.from_buffer(expected), expected)
+
+    def test_from_bad_buffer(self):
+        with self.assertRaises(ValueError):
+            ColorList.from_buffer(array.array('d', [1, 2, 3]))
+        with self.assertRaises(ValueError):
+            ColorList.from_buffer(array.array('f', [1, 2, 3, 4]))
+
+        two_by_two = memoryview(array.array('f', [1, 2, 3, 4]))
+        with self.assertRaises(ValueError):
+            ColorList.from_buffer(two_by_two.cast('B').cast('f', (2, 2)))
+
+        with self.assertRaises(TypeError):
+            ColorList.from_buffer([1, 2, 3])
+
+    def test_round_trip(self):
+        cl = ColorList([(i, i / 2, i / 4) for i in range(100)])
+        copy = ColorList.from_buffer(cl)
+        self.assertEqual(copy, cl)
+        self.assertEqual(ColorList(memoryview(cl)), cl)
+
+    def test_flat_buffer_in_constructor(self):
+        # A flat array isn't read as a buffer by the constructor, but one
+        # element at a time, as before.
+        a = array.array('f', [1, 2, 3])
+        self.assertEqual(len(ColorList(a)), 3)
@@ -0,0 +1,80 @@
+import math, unittest
+
+from timedata import *
+
+
+def make_list(offset, size=600):
+    # With a fractional offset, no component is ever zero.
+    return ColorListRGB([
+        ((i + offset) / 100 - 1, ((i + offset) % 5) / 4, (i % 3) - 1.5)
+        for i in range(size)])
+
+
+class TestColorListExpression(unittest.TestCase):
+    def assertListsAlmostEqual(self, actual, expected):
+        # A fused expression can round differently from the chained methods.
+        self.assertEqual(len(actual), len(expected))
+        for a, e in zip(actual, expected):
+            for x, y in zip(a, e):
+                if not (math.isnan(x) and math.isnan(y)):
+                    self.assertAlmostEqual(x, y, delta=1e-5 * max(1, abs(y)))
+
+    def test_empty(self):
+        cl = make_list(0.25)
+        e = cl.expression()
+        self.assertEqual(len(e), 0)
+        self.assertIs(e.input, cl)
+        self.assertEqual(e.evaluate(), cl)
+
+    def test_chain(self):
+        cl, a, b = make_list(0.25), make_list(1.5), make_list(2.5)
+        expected = cl.copy().mul(a).add(b).abs().pow(2.5)
+        expected.min_limit(0).max_limit(1)
+
+        e = cl.expression().mul(a).add(b).abs().pow(2.5)
+        e.min_limit(0).max_limit(1)
+        self.assertEqual(len(e), 6)
+        self.assertListsAlmostEqual(e.evaluate(), expected)
+
+        out = ColorListRGB()
+        self.assertIs(e.into(out), out)
+        self.assertListsAlmostEqual(out, expected)
+
+    def test_operands(self):
+        cl = make_list(0.25)
+        for operand in 2, Color(0.5, -2, 3), make_list(3.5):
+            for name in ('add', 'div', 'mul', 'pow', 'sub', 'rdiv', 'rpow',
+                         'rsub', 'max_limit', 'min_limit'):
+                expected = getattr(cl.copy(), name)(operand)
+                e = getattr(cl.expression(), name)(operand)
+                self.assertListsAlmostEqual(e.evaluate(), expected)
+
+        for name in 'abs', 'ceil', 'floor', 'invert', 'neg', 'trunc':
+            expected = getattr(cl.copy(), name)()
+            self.assertEqual(getattr(cl.expression(), name)().evaluate(),
+                             expected)
+
+    def test_in_place(self):
+        cl, a = make_list(0.25), make_list(1.5)
+        expected = cl.copy().mul(a).add(1)
+        cl.expression().mul(a).add(1).into(cl)
+        self.assertListsAlmostEqual(cl, expected)
+
+    def test_lazy(self):
+        cl, a = make_list(0.25), make_list(1.5)
+        e = cl.expression().add(a)
+        a.mul(2)
+        self.assertEqual(e.evaluate(), cl.copy().add(a))
+
+    def test_short_operand(self):
+        cl = make_list(0.25)
+        with self.assertRaises(ValueError):
+            cl.expression().add(make_list(0, 10)).evaluate()
+        with self.assertRaises(TypeError):
+            cl.expression().add('red')
+
+    def test_clear(self):
+        cl = make_list(0.25)
+        e = cl.expression().add(1).neg()
+        self.assertEqual(len(e.clear()), 0)
+        self.assertEqual(e.evaluate(), cl)
@@ -1,10 +1,23 @@
-import unittest
+import math, unittest
 
+import timedata
 from timedata import *
 
 Colors = Color.by_name
 
-class TestColorList(unittest.TestCase):
+
+class SamplesTestCase(unittest.TestCase):
+    def assertSamplesAlmostEqual(self, samples, expected):
+        # Optimized list code can round differently from the simpler code it's
+        # checked against.  NaNs, like the hue of gray, are equal.
+        self.assertEqual(len(samples), len(expected))
+        for s, e in zip(samples, expected):
+            for x, y in zip(s, e):
+                if not (math.isnan(x) and math.isnan(y)):
+                    self.assertAlmostEqual(x, y, delta=1e-5 * max(1, abs(y)))
+
+
+class TestColorList(SamplesTestCase):
     def test_trivial(self):
         cl = ColorList()
         self.assertEqual(len(cl), 0)
@@ -49,6 +62,14 @@ class TestColorList(unittest.TestCase):
 
         del cl[1:7:3]
         self.assertEqual(cl, ColorList(('red', 'blue', 'tan', 'tan')))
+
+        colors = [(i, 0, 0) for i in range(10)]
+        for s in (slice(2, 4), slice(1, 8, 3), slice(8, 1, -2),
+                  slice(None, None, -3), slice(5, 5), slice(-3, None)):
+            cl, expected = ColorList(colors), list(colors)
+            del cl[s]
+            del expected[s]
+            self.assertEqual(cl, ColorList(expected))
         for i in range(5):
             if i != 2:
                 with self.assertRaises(ValueError):
@@ -195,6 +216,40 @@ class TestColorList(unittest.TestCase):
 
         self.assertEqual(cl.distance2(ColorList(['white'])), 3)
 
+    def test_math_isa(self):
+        self.assertEqual(math_isa(), best_isa())
+        cl = ColorList(['red', 'gray 30', 'yellow', 'blue'] * 9)
+        other = ColorList(['white', 'green'] * 18)
+
+        def run():
+            x = cl.copy().mul(0.7).add(other).sub(0.25).abs()
+            return x, x.min(), x.max(), x.distance2(cl)
+
+        try:
+            set_math_isa('scalar')
+            self.assertEqual(math_isa(), 'scalar')
+            expected = run()
+            for isa in ISA_NAMES:
+                set_math_isa(isa)
+                result = run()
+                self.assertSamplesAlmostEqual(result[0], expected[0])
+                self.assertSamplesAlmostEqual(result[1:3], expected[1:3])
+                self.assertAlmostEqual(result[3], expected[3],
+                                       delta=1e-5 * expected[3])
+        finally:
+            set_math_isa(best_isa())
+        self.assertEqual(math_isa(), best_isa())
+
+    def test_math_short_operand(self):
+        # Only the samples with an operand change.
+        cl = ColorList(['red', 'green', 'blue'])
+        white = ColorList(['white'])
+        expected = ColorList([(2, 1, 1), 'green', 'blue'])
+        self.assertEqual(cl.copy().add(white), expected)
+        out = ColorList()
+        self.assertIs(cl.add_to(white, out), out)
+        self.assertEqual(out, expected)
+
     def test_list_ops(self):
         cl = ColorList(('red', 'green', 'blue'))
         cl2 = cl.copy()
@@ -229,6 +284,11 @@ class TestColorList(unittest.TestCase):
         self.assertEqual(cl.copy().insert(-5, Colors.white),
                          ColorList(('white', 'red', 'green', 'blue')))
 
+    def test_insert_in_place(self):
+        cl = ColorList(('red', 'green', 'blue'))
+        cl.insert(1, Colors.white)
+        self.assertEqual(cl, ColorList(('red', 'white', 'green', 'blue')))
+
     def test_pop(self):
         cl = ColorList(('red', 'green', 'blue'))
         cl2 = cl.copy()
@@ -293,3 +353,48 @@ class TestColorList(unittest.TestCase):
         self.assertEqual(sys.getsizeof(cl.resize(0)), 24)
         self.assertEqual(sys.getsizeof(cl.resize(1)), 36)
         self.assertEqual(sys.getsizeof(cl.resize(2)), 48)
+
+
+class TestColorListConvert(SamplesTestCase):
+    def hsv(self, size=600):
+        return ColorListHSV([(i / size, (i % 7) / 6, (i % 11) / 10)
+                             for i in range(size)])
+
+    def test_convert(self):
+        hsv = self.hsv()
+        rgb = ColorListRGB(hsv)
+        self.assertSamplesAlmostEqual(rgb, [ColorRGB(h) for h in hsv])
+
+    def test_round_trip(self):
+        hsv = self.hsv()[1:]
+        for h, h2 in zip(hsv, ColorListHSV(ColorListRGB(hsv))):
+            # Black has no saturation, and gray has no hue.
+            self.assertAlmostEqual(h[2], h2[2], places=5)
+            if h[2]:
+                self.assertAlmostEqual(h[1], h2[1], places=5)
+                if h[1]:
+                    self.assertAlmostEqual(h[0], h2[0], places=5)
+
+    def test_convert_ranges(self):
+        # A tiny build only has some of the list classes.  Black and white are
+        # special cases for HSL.
+        hsv = ColorListHSV(list(self.hsv(30)) + [(0.5, 0.5, 0), (0.5, 0, 1)])
+        for name in 'RGB255', 'RGB256', 'HSL', 'XYZ', 'YIQ', 'YUV':
+            cls = getattr(timedata, 'ColorList' + name, None)
+            sample_cls = getattr(timedata, 'Color' + name, None)
+            if cls and sample_cls:
+                cl = cls(hsv)
+                self.assertSamplesAlmostEqual(cl, [sample_cls(h) for h in hsv])
+
+    def test_convert_black_and_white(self):
+        # Black and white have no saturation in HSL, rather than NaN.
+        cls = getattr(timedata, 'ColorListHSL', None)
+        if cls:
+            hsl = cls(ColorListHSV([(0.5, 0.5, 0), (0.5, 0, 1)]))
+            self.assertEqual([(c[1], c[2]) for c in hsl], [(0, 0), (0, 1)])
+
+    def test_convert_resize_while_exported(self):
+        rgb = ColorListRGB()
+        with memoryview(rgb):
+            with self.assertRaises(BufferError):
+                rgb.__init__(self.hsv(3))
@@ -0,0 +1,99 @@
+import unittest
+
+from timedata import *
+
+
+def clean(size=10):
+    return ColorListRGB(['black'] * size).clear_dirty()
+
+
+class TestDirty(unittest.TestCase):
+    def test_new(self):
+        self.assertEqual(ColorListRGB().dirty, ())
+        self.assertEqual(ColorListRGB(['red', 'green']).dirty, ((0, 2),))
+        self.assertEqual(clean().dirty, ())
+
+    def test_setitem(self):
+        cl = clean()
+        cl[3] = 'red'
+        cl[-1] = 'red'
+        cl[4] = 'red'
+        self.assertEqual(cl.dirty, ((3, 5), (9, 10)))
+
+    def test_slices(self):
+        cl = clean()
+        cl[2:4] = ['red', 'blue']
+        self.assertEqual(cl.dirty, ((2, 4),))
+
+        cl.clear_dirty()[7:1:-2] = ['red', 'green', 'blue']
+        self.assertEqual(cl.dirty, ((3, 8),))
+
+        # Changing the size moves everything after the slice.
+        cl.clear_dirty()[5:6] = ['red', 'green']
+        self.assertEqual(cl.dirty, ((5, 11),))
+
+        del cl.clear_dirty()[8:]
+        self.assertEqual(cl.dirty, ())
+        del cl[2:4]
+        self.assertEqual(cl.dirty, ((2, 6),))
+
+    def test_resize(self):
+        cl = clean()
+        cl.append(Color('red'))
+        cl.extend(['red', 'green'])
+        self.assertEqual(cl.dirty, ((10, 13),))
+
+        cl.clear_dirty().insert(-2, Color('red'))
+        self.assertEqual(cl.dirty, ((11, 14),))
+        cl.clear_dirty().pop(3)
+        self.assertEqual(cl.dirty, ((3, 13),))
+        cl.clear_dirty().resize(5)
+        self.assertEqual(cl.dirty, ())
+        cl.resize(6)
+        self.assertEqual(cl.dirty, ((5, 6),))
+
+    def test_math(self):
+        cl = clean(4)
+        cl.add(1)
+        self.assertEqual(cl.dirty, ((0, 4),))
+
+        cl2 = clean(2)
+        cl.clear_dirty().add_to(1, cl2)
+        self.assertEqual(cl.dirty, ())
+        self.assertEqual(cl2.dirty, ((0, 4),))
+        cl.neg()
+        self.assertEqual(cl.dirty, ((0, 4),))
+
+    def test_spread(self):
+        self.assertEqual(ColorListRGB.spread('red', 2, 'green').dirty,
+                         ((0, 4),))
+
+    def test_mark(self):
+        cl = clean()
+        self.assertIs(cl.mark_dirty(2, 3), cl)
+        cl.mark_dirty(5)
+        self.assertEqual(cl.dirty, ((2, 3), (5, 10)))
+        cl.mark_dirty()
+        self.assertEqual(cl.dirty, ((0, 10),))
+
+
+class TestRenderDirty(unittest.TestCase):
+    def test_render_dirty(self):
+        renderer = Renderer()
+        cl = ColorListRGB(['red', 'green', 'blue', 'white'])
+        out = bytearray(12)
+        self.assertEqual(renderer.render_dirty(cl, out), ((0, 12),))
+        self.assertEqual(cl.dirty, ())
+        self.assertEqual(renderer.render_dirty(cl, out), ())
+
+        cl[2] = 'black'
+        self.assertEqual(renderer.render_dirty(cl, out, False), ((6, 9),))
+        self.assertEqual(cl.dirty, ((2, 3),))
+        self.assertEqual(out, renderer.render(cl))
+
+        renderer.level = 0.5
+        self.assertEqual(renderer.render_dirty(cl, out), ((0, 12),))
+        self.assertEqual(out, renderer.render(cl))
+
+        with self.assertRaises(ValueError):
+            renderer.render_dirty(cl, bytearray(3))
@@ -0,0 +1,52 @@
+import copy, unittest
+
+from timedata import *
+
+RED_GREEN = ColorListRGB(['red', 'green'])
+BLUE_WHITE = ColorListRGB(['blue', 'white', 'black'])
+
+
+class TestFade(unittest.TestCase):
+    def test_repr(self):
+        fade = Fade(type='sqr', end=0.5)
+        self.assertEqual(
+            repr(fade), "timedata.Fade(begin=0.0, end=0.5, type='sqr')")
+        self.assertEqual(copy.copy(fade).type, 'sqr')
+
+    def test_linear(self):
+        out = Fade()(0.25, RED_GREEN, BLUE_WHITE)
+        self.assertEqual(out, ColorListRGB([(0.75, 0, 0.25),
+                                            (0.25, 1, 0.25)]))
+
+    def test_ends(self):
+        for type in Fade.TYPE_NAMES:
+            fade = Fade(type=type)
+            self.assertEqual(fade(0, RED_GREEN, BLUE_WHITE), RED_GREEN)
+            self.assertEqual(fade(1, RED_GREEN, BLUE_WHITE), BLUE_WHITE[:2])
+
+    def test_curves(self):
+        out = Fade(type='sqr')(0.5, RED_GREEN, BLUE_WHITE)
+        self.assertEqual(out[0], Color(0.25, 0, 0.25))
+        out = Fade(type='sqrt')(0.25, RED_GREEN, BLUE_WHITE)
+        self.assertAlmostEqual(out[0][2], 0.5)
+
+    def test_in_place(self):
+        cl = RED_GREEN.copy()
+        out = Fade()(0.5, cl, BLUE_WHITE, cl)
+        self.assertIs(out, cl)
+        self.assertEqual(cl, ColorListRGB([(0.5, 0, 0.5), (0.5, 1, 0.5)]))
+
+    def test_mix(self):
+        out = mix([RED_GREEN, BLUE_WHITE, [(1, 1, 1)] * 2], [0.5, 0.25, -1])
+        self.assertEqual(out, ColorListRGB([(-0.5, -1, -0.75),
+                                            (-0.75, -0.25, -0.75)]))
+        self.assertEqual(mix([RED_GREEN, BLUE_WHITE], [0.75, 0.25]),
+                         Fade()(0.25, RED_GREEN, BLUE_WHITE))
+        self.assertEqual(mix([], []), ColorListRGB())
+
+        cl = BLUE_WHITE.copy()
+        self.assertIs(mix([RED_GREEN, cl], [1, 1], cl), cl)
+        self.assertEqual(cl, ColorListRGB([(1, 0, 1), (1, 2, 1)]))
+
+        with self.assertRaises(ValueError):
+            mix([RED_GREEN], [1, 2])
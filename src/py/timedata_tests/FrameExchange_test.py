@@ -0,0 +1,53 @@
+import threading, unittest
+
+from timedata import *
+
+COLORS = ColorListRGB(['red', 'green', 'blue'])
+
+
+class TestFrameExchange(unittest.TestCase):
+    def test_render(self):
+        exchange = FrameExchange(9)
+        self.assertEqual(exchange.color_count, 3)
+        self.assertIsNone(exchange.acquire())
+        self.assertEqual(exchange.sequence, 0)
+
+        renderer = Renderer()
+        exchange.render(renderer, COLORS)
+        frame = exchange.acquire()
+        self.assertEqual(bytes(frame), bytes(renderer.render(COLORS)))
+        self.assertTrue(frame.readonly)
+        self.assertEqual(exchange.sequence, 1)
+        self.assertEqual(exchange.colors(), COLORS)
+        self.assertIsNone(exchange.acquire())
+
+        with self.assertRaises(ValueError):
+            exchange.render(renderer, COLORS + COLORS)
+
+    def test_publish(self):
+        exchange = FrameExchange(4)
+        exchange.publish(b'ab')
+        exchange.publish(bytearray(b'cde'))
+        self.assertEqual(bytes(exchange.acquire()), b'cde')
+        self.assertEqual(exchange.sequence, 2)
+        with self.assertRaises(ValueError):
+            exchange.publish(b'abcde')
+
+    def test_threads(self):
+        exchange = FrameExchange(64)
+        frames = 2000
+
+        def write():
+            for i in range(1, frames + 1):
+                exchange.publish(bytes([i % 256]) * 64)
+
+        writer = threading.Thread(target=write)
+        writer.start()
+        last = 0
+        while last < frames:
+            frame = exchange.acquire()
+            if frame is not None:
+                self.assertGreater(exchange.sequence, last)
+                last = exchange.sequence
+                self.assertEqual(bytes(frame), bytes([last % 256]) * 64)
+        writer.join()
@@ -0,0 +1,74 @@
+import threading, time, unittest
+
+from timedata import *
+
+
+class TestFrameScheduler(unittest.TestCase):
+    def test_run(self):
+        calls = []
+        scheduler = FrameScheduler(
+            fps=500,
+            compute=lambda t: calls.append(('compute', t)),
+            render=lambda t: calls.append(('render', t)),
+            output=lambda t: calls.append(('output', t)))
+        self.assertEqual(scheduler.fps, 500)
+        self.assertEqual(scheduler.run(10), 10)
+        self.assertEqual(len(calls), 30)
+        self.assertEqual([c[0] for c in calls[:3]],
+                         ['compute', 'render', 'output'])
+        self.assertEqual(calls[0][1], 0)
+        self.assertGreaterEqual(calls[3][1], 0.002 - 1e-9)
+
+        self.assertEqual(scheduler.frames, 10)
+        stats = scheduler.stats()
+        self.assertEqual(stats['frames'], 10)
+        for name in 'compute', 'render', 'output', 'frame', 'lateness':
+            self.assertEqual(stats[name]['count'], 10)
+            self.assertLessEqual(stats[name]['min'], stats[name]['p50'])
+            self.assertLessEqual(stats[name]['p50'], stats[name]['max'])
+        self.assertLessEqual(scheduler.percentile('frame', 50),
+                             stats['frame']['max'])
+        with self.assertRaises(ValueError):
+            scheduler.percentile('nothing', 50)
+
+        scheduler.reset_stats()
+        self.assertEqual(scheduler.frames, 0)
+
+    def test_overrun(self):
+        scheduler = FrameScheduler(fps=200, render=lambda t: time.sleep(0.015))
+        scheduler.run(3)
+        self.assertEqual(scheduler.overruns, 3)
+        self.assertGreaterEqual(scheduler.dropped, 4)
+        self.assertGreaterEqual(scheduler.percentile('render', 50), 0.014)
+
+    def test_thread(self):
+        frames = []
+        ready = threading.Event()
+
+        def output(t):
+            frames.append(t)
+            if len(frames) >= 5:
+                ready.set()
+
+        with FrameScheduler(fps=200, output=output) as scheduler:
+            self.assertTrue(scheduler.running)
+            self.assertFalse(scheduler.start())
+            self.assertTrue(ready.wait(5))
+        self.assertFalse(scheduler.running)
+        self.assertGreaterEqual(len(frames), 5)
+        self.assertEqual(scheduler.frames, len(frames))
+
+    def test_error(self):
+        def compute(t):
+            raise ValueError('bad frame')
+
+        scheduler = FrameScheduler(fps=1000, compute=compute)
+        with self.assertRaises(ValueError):
+            scheduler.run(0)
+        self.assertEqual(scheduler.frames, 1)
+
+        scheduler.start()
+        while scheduler.running:
+            time.sleep(0.001)
+        with self.assertRaises(ValueError):
+            scheduler.stop()
@@ -5,13 +5,17 @@ from timedata import Render3
 class TestGenerated(unittest.TestCase):
     def test_render3(self):
         r = Render3()
-        s = "(gamma=1.0, min=0, max=255, permutation='rgb')"
+        s = ("(gamma=1.0, min=0, max=255, permutation='rgb', output='bits8', "
+             "table='full')")
         self.assertEqual(str(r), s)
         self.assertEqual(repr(r), 'timedata.Render3' + s)
 
         r.gamma = 2.5
         r.permutation = 'grb'
-        s = "(gamma=2.5, min=0, max=255, permutation='grb')"
+        r.output = 'bits16'
+        r.table = 'compact'
+        s = ("(gamma=2.5, min=0, max=255, permutation='grb', output='bits16', "
+             "table='compact')")
         self.assertEqual(str(r), s)
         self.assertEqual(repr(r), 'timedata.Render3' + s)
 
@@ -22,6 +26,9 @@ class TestGenerated(unittest.TestCase):
         r.permutation = 5
         self.assertEqual(r.permutation, 'bgr')
 
+        r.output = 1
+        self.assertEqual(r.output, 'dither8')
+
     def test_raises(self):
         r = Render3()
         with self.assertRaises(ValueError):
@@ -0,0 +1,49 @@
+import math, unittest
+
+from timedata import *
+
+
+class TestGenerator(unittest.TestCase):
+    def test_oscillator(self):
+        osc = Oscillator(step=0.125, low=0.25, high=0.75)
+        self.assertEqual(osc.wave, 'sine')
+        out = osc(8)
+        self.assertEqual(len(out), 8)
+        for i, color in enumerate(out):
+            expected = 0.5 - 0.25 * math.cos(2 * math.pi * i / 8)
+            for c in color:
+                self.assertAlmostEqual(c, expected, delta=0.001)
+
+        osc.wave = 'saw'
+        self.assertEqual([c[0] for c in osc(4)], [0.25, 0.3125, 0.375, 0.4375])
+        osc.wave = 'square'
+        self.assertEqual([c[0] for c in osc(8)],
+                         [0.25, 0.25, 0.75, 0.75, 0.75, 0.75, 0.25, 0.25])
+        self.assertEqual(
+            repr(Oscillator(wave='triangle')),
+            "timedata.Oscillator(wave='triangle', phase=0.0, step=0.0, "
+            "low=0.0, high=1.0)")
+
+    def test_channel(self):
+        out = ColorList(['red'] * 4)
+        result = Oscillator(wave='saw', step=0.25)(out, 2)
+        self.assertIs(result, out)
+        self.assertEqual(out, ColorList([(1, 0, 0), (1, 0, 0.25),
+                                         (1, 0, 0.5), (1, 0, 0.75)]))
+        with self.assertRaises(ValueError):
+            Oscillator()(out, 3)
+
+    def test_noise(self):
+        noise = Noise(seed=3, scale=0.25)
+        a, b = noise(100), noise(100)
+        self.assertEqual(a, b)
+        values = [c[1] for c in a]
+        self.assertTrue(all(0 <= v < 1 for v in values))
+        self.assertNotEqual(noise(100, 0), Noise(seed=4, scale=0.25)(100, 0))
+
+    def test_ramp(self):
+        ramp = Ramp(begin=1, end=3)
+        self.assertEqual([c[0] for c in ramp(5)], [0, 0, 0.5, 1, 1])
+
+        ramp = Ramp(shape='circle', end=2, x=1, y=1, width=3)
+        self.assertEqual([c[0] for c in ramp(9)[3:6]], [0.5, 0, 0.5])
@@ -0,0 +1,32 @@
+import unittest
+
+from timedata import *
+
+
+class TestInstrument(unittest.TestCase):
+    def setUp(self):
+        instrument_reset()
+
+    def tearDown(self):
+        instrument_reset()
+
+    def test_snapshot(self):
+        cl = ColorList(['red', 'green', 'blue', 'white'])
+        cl.add(0.5)
+        cl.add(cl)
+        cl.sort()
+
+        ops = instrument_snapshot()
+        if not instrument_enabled():
+            self.assertEqual(ops, {})
+            return
+
+        add = ops['math_add']
+        self.assertEqual(add['calls'], 2)
+        self.assertEqual(add['elements'], 8)
+        self.assertLessEqual(add['min'], add['p50'])
+        self.assertLessEqual(add['p50'], add['max'])
+        self.assertEqual(ops['sort']['calls'], 1)
+
+        instrument_reset()
+        self.assertEqual(instrument_snapshot(), {})
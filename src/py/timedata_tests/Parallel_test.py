@@ -0,0 +1,100 @@
+import os, signal, threading, unittest
+
+from timedata import *
+
+
+def make_list(size=5000):
+    return ColorList([(i / 1000, (i % 7) / 6, 2 - i / 2000)
+                      for i in range(size)])
+
+
+class TestParallel(unittest.TestCase):
+    def setUp(self):
+        self.threads = thread_count()
+        self.threshold = parallel_threshold()
+
+    def tearDown(self):
+        set_thread_count(self.threads)
+        set_parallel_threshold(self.threshold)
+
+    def compute(self, cl):
+        return cl.copy().mul(cl).add(0.5).pow(1.5).invert()
+
+    def test_settings(self):
+        set_thread_count(3)
+        self.assertEqual(thread_count(), 3)
+        set_thread_count(0)
+        self.assertGreaterEqual(thread_count(), 1)
+        set_parallel_threshold(1234)
+        self.assertEqual(parallel_threshold(), 1234)
+
+    def test_matches_serial(self):
+        cl = make_list()
+        set_thread_count(1)
+        serial = self.compute(cl)
+
+        set_thread_count(4)
+        set_parallel_threshold(0)
+        self.assertEqual(self.compute(cl), serial)
+
+    @unittest.skipUnless(hasattr(os, 'fork'), 'needs os.fork')
+    def test_fork(self):
+        # As multiprocessing does on Linux: the child has none of the
+        # parent's worker threads, so it must not wait for them.
+        cl = make_list()
+        set_thread_count(4)
+        set_parallel_threshold(0)
+        expected = self.compute(cl)
+
+        pid = os.fork()
+        if not pid:
+            signal.alarm(10)
+            os._exit(0 if self.compute(cl) == expected else 1)
+
+        _, status = os.waitpid(pid, 0)
+        self.assertTrue(os.WIFEXITED(status))
+        self.assertEqual(os.WEXITSTATUS(status), 0)
+
+    def test_python_threads(self):
+        cl = make_list()
+        expected = self.compute(cl)
+        set_thread_count(4)
+        set_parallel_threshold(0)
+
+        results = [None] * 4
+        def run(i):
+            results[i] = self.compute(cl)
+
+        threads = [threading.Thread(target=run, args=(i,)) for i in range(4)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        self.assertEqual(results, [expected] * 4)
+
+    def test_gil_released(self):
+        # These methods run without the GIL, so they must be safe to call
+        # concurrently from several Python threads.
+        cl = make_list()
+        other = make_list().rotate(3)
+        renderer = Renderer()
+
+        def work():
+            out = cl.copy()
+            out.rotate(17).sort()
+            out.round(2)
+            return (out, out.max(), out.min(), cl.distance(other),
+                    cl.count(cl[10]), cl.index(cl[20]), cl * 2, cl + other,
+                    bytes(renderer.render(cl)))
+
+        expected = work()
+        results = [None] * 4
+        def run(i):
+            results[i] = work()
+
+        threads = [threading.Thread(target=run, args=(i,)) for i in range(4)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        self.assertEqual(results, [expected] * 4)
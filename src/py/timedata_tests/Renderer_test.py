@@ -36,3 +36,125 @@ class TestRenderer(unittest.TestCase):
         r = render(COLORS.copy().mul(0.9), gamma=2.5)
         self.assertEqual(r, [196, 0, 0, 0, 196, 0, 0, 0, 196])
         self.assertEqual(r, render(COLORS, gamma=2.5, level=0.9))
+
+    def test_isa(self):
+        self.assertIn(best_isa(), ISA_NAMES)
+        self.assertEqual(Renderer(isa='scalar').isa, 'scalar')
+        self.assertEqual(Renderer().isa, best_isa())
+
+    def test_isa_matches_scalar(self):
+        colors = ColorListRGB(COLORS * 11).mul(0.73)
+        expected = render(colors, gamma=2.5, permutation='gbr', isa='scalar')
+        for isa in ISA_NAMES:
+            self.assertEqual(
+                render(colors, gamma=2.5, permutation='gbr', isa=isa),
+                expected)
+
+
+class TestSegmentRenderer(unittest.TestCase):
+    def test_segments(self):
+        colors = ColorListRGB(COLORS * 4).mul(0.73)
+        segments = (
+            (3, 9, 12, dict(gamma=2.5, permutation='grb')),
+            (0, 3, 0, None),
+            (9, 12, None, Render3(permutation='bgr')),
+        )
+        renderer = SegmentRenderer(segments)
+        self.assertEqual(len(renderer), 3)
+        self.assertEqual(renderer.input_size, 12)
+        self.assertEqual(renderer.frame_size, 39)
+
+        expected = (render(colors[0:3]) + [0, 0, 0] +
+                    render(colors[3:9], gamma=2.5, permutation='grb') +
+                    render(colors[9:12], permutation='bgr'))
+        for isa in ISA_NAMES:
+            renderer.isa = isa
+            self.assertEqual(list(renderer.render(colors)), expected)
+
+        output = bytearray(b'x' * 40)
+        self.assertIs(renderer.render(colors, output), output)
+        self.assertEqual(output[9:12], b'xxx')
+        self.assertEqual(output[39:], b'x')
+
+        renderer.level = 0.5
+        self.assertEqual(list(renderer.render(colors))[:9],
+                         render(colors[0:3], level=0.5))
+
+    def test_errors(self):
+        renderer = SegmentRenderer([(0, 3)])
+        with self.assertRaises(ValueError):
+            renderer.add(0, 1, 8)
+        with self.assertRaises(ValueError):
+            renderer.add(2, 1)
+        with self.assertRaises(ValueError):
+            renderer.render(COLORS[:2])
+        with self.assertRaises(ValueError):
+            renderer.render(COLORS, bytearray(8))
+        with self.assertRaises(BufferError):
+            renderer.render(COLORS, bytes(9))
+
+        renderer.clear()
+        self.assertEqual(len(renderer), 0)
+        self.assertEqual(renderer.render(COLORS), bytearray())
+
+
+class TestRenderOutputs(unittest.TestCase):
+    def test_bits16(self):
+        r = render(output='bits16')
+        self.assertEqual(r, [255, 255, 0, 0, 0, 0, 0, 0, 255, 255, 0, 0,
+                             0, 0, 0, 0, 255, 255])
+        r = render(HALF_COLORS, output='bits16')
+        self.assertEqual(r[:2], [0x80, 0])
+
+        with self.assertRaises(ValueError):
+            Renderer(output='bits16').render(COLORS, bytearray(9))
+
+    def test_dither8(self):
+        colors = ColorListRGB([(0.1, 0.2, 0.05)])
+        renderer = Renderer(gamma=2.5, output='dither8')
+        self.assertEqual(renderer.output, 'dither8')
+        self.assertEqual(render(colors, gamma=2.5), [0, 4, 0])
+
+        frames = [list(renderer.render(colors)) for i in range(100)]
+        means = [sum(f[i] for f in frames) / 100 for i in range(3)]
+        expected = [255 * x ** 2.5 for x in (0.1, 0.2, 0.05)]
+        for m, e in zip(means, expected):
+            self.assertAlmostEqual(m, e, delta=0.02)
+        renderer.reset_dither()
+
+    def test_segments(self):
+        renderer = SegmentRenderer([
+            (0, 3, None, dict(output='bits16')),
+            (0, 3, None, dict(output='dither8')),
+        ])
+        self.assertEqual(renderer.frame_size, 27)
+        frame = renderer.render(COLORS)
+        self.assertEqual(list(frame[:18]), render(output='bits16'))
+        self.assertEqual(list(frame[18:]), render())
+        renderer.reset_dither()
+
+
+class TestRenderTables(unittest.TestCase):
+    def test_compact(self):
+        self.assertEqual(Renderer(table='compact').table, 'compact')
+        self.assertEqual(render(table='compact'), render())
+        self.assertEqual(render(HALF_COLORS, table='compact'),
+                         render(HALF_COLORS))
+
+    def test_compact_gamma(self):
+        colors = ColorListRGB([(i / 99, i / 99, i / 99) for i in range(100)])
+        full = render(colors, gamma=2.5, min=4)
+        compact = render(colors, gamma=2.5, min=4, table='compact')
+        self.assertEqual(len(full), len(compact))
+        for f, c in zip(full, compact):
+            self.assertLessEqual(abs(f - c), 1)
+
+    def test_compact_segments(self):
+        renderer = SegmentRenderer([
+            (0, 3, None, dict(gamma=2.5)),
+            (0, 3, None, dict(gamma=2.5, table='compact')),
+        ])
+        frame = renderer.render(HALF_COLORS)
+        self.assertEqual(list(frame[:9]), render(HALF_COLORS, gamma=2.5))
+        self.assertEqual(list(frame[9:]),
+                         render(HALF_COLORS, gamma=2.5, table='compact'))
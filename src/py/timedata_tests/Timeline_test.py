@@ -0,0 +1,51 @@
+import unittest
+
+from timedata import *
+
+A = ColorListRGB(['red', 'green'])
+B = ColorListRGB(['blue', 'white'])
+C = ColorListRGB(['black', 'yellow'])
+
+
+class TestTimeline(unittest.TestCase):
+    def test_keyframes(self):
+        timeline = Timeline([(2, C), (0, A),
+                             (1, [(0, 0, 1), (1, 1, 1)], 'sqr')])
+        self.assertEqual(len(timeline), 3)
+        self.assertEqual(timeline[1], (1, B, 'sqr'))
+        self.assertEqual(timeline.segment(1.5), 1)
+
+        with self.assertRaises(ValueError):
+            timeline.add(3, ['red'])
+        with self.assertRaises(ValueError):
+            timeline.add(3, C, 'cubic')
+        with self.assertRaises(IndexError):
+            timeline[3]
+
+        timeline.remove(0)
+        self.assertEqual(timeline[0][0], 1)
+        timeline.clear()
+        self.assertEqual(len(timeline), 0)
+        self.assertEqual(timeline(1), ColorListRGB())
+
+    def test_evaluate(self):
+        timeline = Timeline([(0, A), (1, B, 'sqr'), (3, C)])
+        self.assertEqual(timeline(-1), A)
+        self.assertEqual(timeline(1), B)
+        self.assertEqual(timeline(5), C)
+        self.assertEqual(timeline(0.25), Fade()(0.25, A, B))
+        self.assertEqual(timeline(2), Fade(type='sqr')(0.5, B, C))
+
+        out = ColorListRGB()
+        self.assertIs(timeline(0.5, out), out)
+        self.assertEqual(out, Fade()(0.5, A, B))
+
+    def test_stream(self):
+        timeline = Timeline([(i, ColorListRGB([(i, 0, 1 - i)] * 4))
+                             for i in range(10)])
+        out = ColorListRGB()
+        for i in range(100):
+            t = i * 0.11
+            self.assertEqual(timeline.stream(t, out), timeline(t))
+        timeline.rewind()
+        self.assertEqual(timeline.stream(2.5), timeline(2.5))
@@ -0,0 +1,25 @@
+from cpython.buffer cimport (
+    PyBUF_C_CONTIGUOUS, PyBUF_FORMAT, PyBUF_ND, PyBUF_STRIDES, PyBUF_WRITABLE,
+    PyBuffer_Release, PyObject_CheckBuffer, PyObject_GetBuffer)
+from libc.string cimport memmove
+
+import sys
+
+# The struct module formats that mean a native float32.
+_FLOAT32_FORMATS = {'f', '@f', '=f',
+                    '<f' if sys.byteorder == 'little' else '>f'}
+
+
+cdef str _sample_buffer_error(Py_buffer* view, size_t size, bool flat):
+    """Return why a buffer can't be read as samples of `size` float32s, or
+       None if it can.  If `flat` is true, a one-dimensional buffer is read as
+       consecutive samples."""
+    format = view.format.decode('ascii')
+    if view.itemsize != sizeof(float) or format not in _FLOAT32_FORMATS:
+        return 'expected a buffer of float32, not format "%s"' % format
+    if view.ndim > 1 and view.shape[view.ndim - 1] != <Py_ssize_t> size:
+        return 'expected a buffer of shape (..., %d)' % size
+    if view.ndim < 2 and not flat:
+        return 'expected a buffer of shape (..., %d)' % size
+    if (view.len // view.itemsize) % size:
+        return 'expected a buffer with a multiple of %d floats' % size
@@ -0,0 +1,38 @@
+cdef extern from "<timedata/base/cpu.h>" namespace "timedata":
+    cdef cppclass Isa:
+        pass
+
+    Isa bestIsa()
+    string isaName(Isa)
+
+cdef extern from "<timedata/color/mathKernels.h>" namespace "timedata":
+    Isa mathIsa "timedata::color_list::mathIsa"()
+    void setMathIsa "timedata::color_list::setMathIsa"(Isa)
+
+ISA_NAMES = 'scalar', 'sse2', 'avx2', 'avx512'
+
+cdef Isa _to_isa(object x) except *:
+    cdef uint8_t i
+    if isinstance(x, str):
+        i = ISA_NAMES.index(x)
+    else:
+        i = <uint8_t> x
+        if i >= len(ISA_NAMES):
+            raise ValueError("Can't understand instruction set " + str(x))
+    return <Isa>(i)
+
+def best_isa():
+    """Return the name of the best instruction set that timedata's kernels
+       can use on this CPU."""
+    return isaName(bestIsa()).decode('ascii')
+
+def math_isa():
+    """Return the name of the instruction set that ColorList arithmetic,
+       distance() and min() and max() use.  This starts as best_isa()."""
+    return isaName(mathIsa()).decode('ascii')
+
+def set_math_isa(isa):
+    """Select the instruction set for ColorList arithmetic, by name or by its
+       index in ISA_NAMES.  If the CPU doesn't support it, the best one that
+       it does support is used instead."""
+    setMathIsa(_to_isa(isa))
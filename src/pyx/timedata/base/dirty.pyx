@@ -0,0 +1,20 @@
+cdef extern from "<timedata/base/dirtyRanges.h>" namespace "timedata":
+    cdef cppclass DirtyRanges:
+        void add(size_t begin, size_t end)
+        void add(DirtyRanges&)
+        void truncate(size_t size)
+        void clear()
+        bool empty()
+        size_t count()
+        size_t size()
+        pair[size_t, size_t]& operator[](size_t)
+
+
+cdef tuple _dirty_tuple(DirtyRanges& ranges, size_t scale):
+    """Return the ranges as a tuple of pairs (begin, end), each multiplied by
+       `scale`."""
+    cdef size_t i
+    result = []
+    for i in range(ranges.size()):
+        result.append((ranges[i].first * scale, ranges[i].second * scale))
+    return tuple(result)
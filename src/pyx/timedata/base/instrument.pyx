@@ -0,0 +1,45 @@
+cdef extern from "<timedata/base/instrument.h>" namespace "timedata":
+    cdef cppclass OperationStats "timedata::instrument::OperationStats":
+        uint64_t calls, elements
+        LatencyHistogram latency
+
+    vector[pair[string, OperationStats]] instrumentSnapshot "timedata::instrument::snapshot"()
+    void instrumentReset "timedata::instrument::reset"()
+    bool instrumentEnabled "timedata::instrument::enabled"()
+
+
+def instrument_enabled():
+    """Return True if this build of timedata counts and times its list
+       operations, which needs the TIMEDATA_INSTRUMENT build flag."""
+    return instrumentEnabled()
+
+
+def instrument_snapshot():
+    """Return a dictionary with an entry for each instrumented operation that
+       has been called since the last instrument_reset(), summed over all
+       threads.
+
+       Each entry has the number of calls and of elements, and the 'min',
+       'max', 'mean' and percentiles like 'p99' of the calls' durations in
+       seconds."""
+    cdef vector[pair[string, OperationStats]] ops = instrumentSnapshot()
+    cdef LatencyHistogram* h
+    result = {}
+    for i in range(ops.size()):
+        h = &ops[i].second.latency
+        summary = {
+            'calls': ops[i].second.calls,
+            'elements': ops[i].second.elements,
+            'min': h.min() / 1e9,
+            'max': h.max() / 1e9,
+            'mean': h.mean() / 1e9,
+        }
+        for p in _FRAME_PERCENTILES:
+            summary['p%s' % p] = h.percentile(p) / 1e9
+        result[ops[i].first.decode('ascii')] = summary
+    return result
+
+
+def instrument_reset():
+    """Clear the counters of every instrumented operation."""
+    instrumentReset()
@@ -0,0 +1,25 @@
+cdef extern from "<timedata/base/parallel.h>" namespace "timedata":
+    size_t threadCount()
+    void setThreadCount(size_t)
+    size_t parallelThreshold()
+    void setParallelThreshold(size_t)
+
+def thread_count():
+    """Return the number of threads that list arithmetic uses on large lists,
+       including the calling thread."""
+    return threadCount()
+
+def set_thread_count(size_t threads):
+    """Set the number of threads that list arithmetic uses on large lists.
+       0 means one thread per CPU core, and 1 means never use extra threads."""
+    setThreadCount(threads)
+
+def parallel_threshold():
+    """Return the length of the shortest list whose arithmetic is split across
+       threads."""
+    return parallelThreshold()
+
+def set_parallel_threshold(size_t threshold):
+    """Set the length of the shortest list whose arithmetic is split across
+       threads."""
+    setParallelThreshold(threshold)
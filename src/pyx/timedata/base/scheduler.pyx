@@ -0,0 +1,230 @@
+from cpython.ref cimport Py_INCREF, Py_DECREF
+
+cdef extern from "<timedata/base/frameScheduler.h>" namespace "timedata":
+    cdef cppclass LatencyHistogram:
+        uint64_t count()
+        uint64_t min()
+        uint64_t max()
+        double mean()
+        uint64_t percentile(double percent)
+
+    cdef cppclass FrameStats:
+        LatencyHistogram compute, render, output, frame, lateness
+        uint64_t frames, overruns, dropped
+
+    cdef cppclass FrameStage "timedata::FramePipeline::Stage":
+        pass
+
+    cdef cppclass FramePipeline:
+        FrameStage compute, render, output
+
+    ctypedef void (*FrameCallback)(void* context, double time) noexcept
+
+    FrameStage callbackStage(FrameCallback, void* context)
+
+    cdef cppclass CFrameScheduler "timedata::FrameScheduler":
+        void setPipeline(FramePipeline)
+        double fps()
+        void setFps(double)
+        double spin()
+        void setSpin(double)
+        bool start()
+        void stop() nogil
+        void requestStop()
+        bool running()
+        uint64_t run(uint64_t frames) nogil
+        FrameStats stats()
+        void resetStats()
+
+
+_FRAME_HISTOGRAMS = 'compute', 'render', 'output', 'frame', 'lateness'
+_FRAME_PERCENTILES = 50, 90, 99, 99.9
+
+
+cdef LatencyHistogram* _frame_histogram(FrameStats& stats,
+                                        str name) except NULL:
+    if name == 'compute':
+        return &stats.compute
+    if name == 'render':
+        return &stats.render
+    if name == 'output':
+        return &stats.output
+    if name == 'frame':
+        return &stats.frame
+    if name == 'lateness':
+        return &stats.lateness
+    raise ValueError('Unknown histogram %s' % name)
+
+
+cdef void _run_stage(FrameScheduler scheduler, object stage, double time):
+    try:
+        stage(time)
+    except BaseException as e:
+        if scheduler._error is None:
+            scheduler._error = e
+        scheduler.cdata.requestStop()
+
+
+cdef void _frame_compute(void* context, double time) noexcept with gil:
+    scheduler = <FrameScheduler> context
+    _run_stage(scheduler, scheduler.compute, time)
+
+
+cdef void _frame_render(void* context, double time) noexcept with gil:
+    scheduler = <FrameScheduler> context
+    _run_stage(scheduler, scheduler.render, time)
+
+
+cdef void _frame_output(void* context, double time) noexcept with gil:
+    scheduler = <FrameScheduler> context
+    _run_stage(scheduler, scheduler.output, time)
+
+
+cdef class FrameScheduler:
+    """Call up to three functions - compute, render and output - once per
+       frame at a steady frame rate, and measure how long each one takes.
+
+       Each function is called with the frame's scheduled time in seconds since
+       the scheduler started.  Frames are due on a fixed grid of deadlines on
+       the monotonic clock, so the frame rate never drifts, and a frame that
+       overruns its deadline causes the deadlines it covered to be dropped.
+
+       start() runs frames on a separate thread until stop() is called, and
+       run() runs a number of frames on the calling thread.  The GIL is
+       released between frames.  If a function raises an exception, frames
+       stop, and the exception is raised again by the next call to stop() or
+       run().
+
+       All durations are in seconds."""
+    cdef CFrameScheduler cdata
+    cdef readonly object compute, render, output
+    cdef object _error
+    cdef bint _held
+
+    def __init__(self, double fps=60, compute=None, render=None, output=None,
+                 double spin=0):
+        cdef FramePipeline pipeline
+        self.compute, self.render, self.output = compute, render, output
+        if compute is not None:
+            pipeline.compute = callbackStage(_frame_compute, <void*> self)
+        if render is not None:
+            pipeline.render = callbackStage(_frame_render, <void*> self)
+        if output is not None:
+            pipeline.output = callbackStage(_frame_output, <void*> self)
+        self.cdata.setPipeline(pipeline)
+        self.cdata.setFps(fps)
+        self.cdata.setSpin(spin)
+
+    def __dealloc__(self):
+        with nogil:
+            self.cdata.stop()
+
+    property fps:
+        def __get__(self):
+            return self.cdata.fps()
+
+        def __set__(self, double fps):
+            self.cdata.setFps(fps)
+
+    property spin:
+        """How long before each deadline to stop sleeping and spin on the
+           clock instead, for more precise timing at the cost of CPU."""
+        def __get__(self):
+            return self.cdata.spin()
+
+        def __set__(self, double spin):
+            self.cdata.setSpin(spin)
+
+    property running:
+        def __get__(self):
+            return self.cdata.running()
+
+    property frames:
+        def __get__(self):
+            return self.cdata.stats().frames
+
+    property overruns:
+        """The number of frames that finished after the next deadline."""
+        def __get__(self):
+            return self.cdata.stats().overruns
+
+    property dropped:
+        """The number of deadlines skipped because of overruns."""
+        def __get__(self):
+            return self.cdata.stats().dropped
+
+    def start(self):
+        """Start running frames on a new thread.  Returns False if frames
+           are already running."""
+        if not self.cdata.start():
+            return False
+
+        # The thread calls back into this object until it is stopped.
+        if not self._held:
+            Py_INCREF(self)
+            self._held = True
+        return True
+
+    def stop(self):
+        """Stop the thread started by start() and wait for it to finish."""
+        with nogil:
+            self.cdata.stop()
+        if self._held:
+            self._held = False
+            Py_DECREF(self)
+        self._raise_error()
+
+    def run(self, uint64_t frames):
+        """Run `frames` frames on the calling thread - or never stop, if
+           `frames` is 0, until a function raises an exception - and return
+           the number that ran, which is 0 if frames were already running."""
+        cdef uint64_t count
+        with nogil:
+            count = self.cdata.run(frames)
+        self._raise_error()
+        return count
+
+    def __enter__(self):
+        self.start()
+        return self
+
+    def __exit__(self, *args):
+        self.stop()
+
+    def percentile(self, str name, double percent):
+        """Return a percentile of one of the histograms 'compute', 'render',
+           'output', 'frame' - the whole frame - or 'lateness' - how late each
+           frame started."""
+        cdef FrameStats stats = self.cdata.stats()
+        return _frame_histogram(stats, name).percentile(percent) / 1e9
+
+    def stats(self):
+        """Return a dictionary with the frame, overrun and dropped counts, and
+           a summary of each histogram."""
+        cdef FrameStats stats = self.cdata.stats()
+        cdef LatencyHistogram* h
+        result = {
+            'frames': stats.frames,
+            'overruns': stats.overruns,
+            'dropped': stats.dropped,
+        }
+        for name in _FRAME_HISTOGRAMS:
+            h = _frame_histogram(stats, name)
+            summary = {
+                'count': h.count(),
+                'min': h.min() / 1e9,
+                'max': h.max() / 1e9,
+                'mean': h.mean() / 1e9,
+            }
+            for p in _FRAME_PERCENTILES:
+                summary['p%s' % p] = h.percentile(p) / 1e9
+            result[name] = summary
+        return result
+
+    def reset_stats(self):
+        self.cdata.resetStats()
+
+    def _raise_error(self):
+        error, self._error = self._error, None
+        if error is not None:
+            raise error
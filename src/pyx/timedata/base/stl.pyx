@@ -1,6 +1,7 @@
 from libcpp cimport bool
 from libcpp.map cimport map
 from libcpp.string cimport string
+from libcpp.utility cimport pair
 from libcpp.vector cimport vector
 
 from libc.stdint cimport uint8_t, uint16_t, uint32_t, uint64_t
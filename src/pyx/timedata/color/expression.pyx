@@ -0,0 +1,18 @@
+cdef extern from "<timedata/color/expression.h>" namespace "timedata::color_list":
+    cdef enum Op "timedata::color_list::Op":
+        OP_add "timedata::color_list::Op::add"
+        OP_div "timedata::color_list::Op::div"
+        OP_mul "timedata::color_list::Op::mul"
+        OP_pow "timedata::color_list::Op::pow"
+        OP_sub "timedata::color_list::Op::sub"
+        OP_rdiv "timedata::color_list::Op::rdiv"
+        OP_rpow "timedata::color_list::Op::rpow"
+        OP_rsub "timedata::color_list::Op::rsub"
+        OP_max_limit "timedata::color_list::Op::max_limit"
+        OP_min_limit "timedata::color_list::Op::min_limit"
+        OP_abs "timedata::color_list::Op::abs"
+        OP_ceil "timedata::color_list::Op::ceil"
+        OP_floor "timedata::color_list::Op::floor"
+        OP_invert "timedata::color_list::Op::invert"
+        OP_neg "timedata::color_list::Op::neg"
+        OP_trunc "timedata::color_list::Op::trunc"
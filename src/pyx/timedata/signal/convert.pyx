@@ -4,4 +4,6 @@ cdef extern from "<timedata/signal/convert_inl.h>" namespace "timedata::converte
     cdef PointerAsInt referenceToInteger[T](T&)
 
     string loadConverter[T]()
-    bool convertSampleCython[T](PointerAsInt input, string model, T& out)
+    size_t converterId[T]()
+    bool convertSampleCython[T](PointerAsInt input, size_t model, T& out)
+    bool convertListCython[T](PointerAsInt input, size_t model, T& out) nogil
@@ -1,11 +1,50 @@
-include "build/genfiles/timedata/signal/fade.pyx"
-
 cdef extern from "<timedata/signal/fade.h>" namespace "timedata":
-    void fadeOver(float fader, Fade& fade, ColorVector& in1, ColorVector& in2,
-                  ColorVector& out)
+    void fadeOver(float fader, Fade& fade, CColorListRGB& in1,
+                  CColorListRGB& in2, CColorListRGB& out) nogil
+    void mixOver(float* weights, CColorListRGB** inputs, size_t count,
+                 CColorListRGB& out) nogil
 
 
 cdef class _FadeImpl(_Fade):
-    def __call__(self, float fader, ColorList in1, ColorList in2,
-                 ColorList out):
-        fadeOver(fader, self._instance, in1.colors, in2.colors, out.colors)
+    """A crossfade between two ColorLists, with a fader between 0 and 1."""
+
+    def __call__(self, float fader, ColorListRGB in1, ColorListRGB in2,
+                 ColorListRGB out=None):
+        """Crossfade in1 and in2 into out, which is resized to the shorter of
+           the two and may be either of them, and return out.  If out is None,
+           a new ColorList is returned."""
+        if out is None:
+            out = ColorListRGB()
+        out._check_resize(min(in1.cdata.size(), in2.cdata.size()))
+        with nogil:
+            fadeOver(fader, self.cdata, in1.cdata, in2.cdata, out.cdata)
+        out._touch_all()
+        return out
+
+    def __repr__(self):
+        return '%s.Fade(%s)' % (self.__class__.__module__, str(self)[1:-1])
+
+
+def mix(object lists, object weights, ColorListRGB out=None):
+    """Mix ColorLists in proportion to a weight for each list into out, which
+       is resized to the shortest of the lists and may be any of them, and
+       return out.  If out is None, a new ColorList is returned."""
+    lists = [i if isinstance(i, ColorListRGB) else ColorListRGB(i)
+             for i in lists]
+    cdef vector[float] w = weights
+    if w.size() != len(lists):
+        raise ValueError('Got %d lists but %d weights' %
+                         (len(lists), w.size()))
+
+    cdef vector[CColorListRGB*] inputs
+    cdef ColorListRGB cl
+    for cl in lists:
+        inputs.push_back(&cl.cdata)
+
+    if out is None:
+        out = ColorListRGB()
+    out._check_resize(min((len(i) for i in lists), default=0))
+    with nogil:
+        mixOver(w.data(), inputs.data(), inputs.size(), out.cdata)
+    out._touch_all()
+    return out
@@ -0,0 +1,84 @@
+cdef extern from "<timedata/signal/generator.h>" namespace "timedata":
+    int ALL_CHANNELS
+    void generate(Oscillator&, CColorListRGB&, int channel) nogil
+    void generate(Noise&, CColorListRGB&, int channel) nogil
+    void generate(Ramp&, CColorListRGB&, int channel) nogil
+
+
+cdef ColorListRGB _generator_output(object out):
+    """Return `out` if it's a ColorList, or else a new ColorList of length
+       `out`."""
+    if isinstance(out, ColorListRGB):
+        return out
+    cdef ColorListRGB cl = ColorListRGB()
+    cl.cdata.resize(<size_t> out)
+    return cl
+
+
+cdef int _generator_channel(object channel) except -2:
+    if channel is None:
+        return ALL_CHANNELS
+    if not 0 <= channel < 3:
+        raise ValueError('Channel %s is not 0, 1 or 2' % channel)
+    return channel
+
+
+cdef class _OscillatorImpl(_Oscillator):
+    """A periodic wave - 'sine', 'triangle', 'saw' or 'square' - along a
+       ColorList, starting at `phase` and advancing by `step` turns from each
+       color to the next, going between `low` and `high`."""
+
+    def __call__(self, object out, object channel=None):
+        """Fill one channel of out - or every channel, if channel is None -
+           with the wave, and return out.  If out is a number, a new ColorList
+           of that length is returned."""
+        cdef ColorListRGB cl = _generator_output(out)
+        cdef int c = _generator_channel(channel)
+        with nogil:
+            generate(self.cdata, cl.cdata, c)
+        cl._touch_all()
+        return cl
+
+    def __repr__(self):
+        return '%s.Oscillator(%s)' % (
+            self.__class__.__module__, str(self)[1:-1])
+
+
+cdef class _NoiseImpl(_Noise):
+    """Smooth random values between `low` and `high` along a ColorList, with
+       `scale` random points per color, that change smoothly with `time`.  The
+       same seed always gives the same noise."""
+
+    def __call__(self, object out, object channel=None):
+        """Fill one channel of out - or every channel, if channel is None -
+           with the noise, and return out.  If out is a number, a new
+           ColorList of that length is returned."""
+        cdef ColorListRGB cl = _generator_output(out)
+        cdef int c = _generator_channel(channel)
+        with nogil:
+            generate(self.cdata, cl.cdata, c)
+        cl._touch_all()
+        return cl
+
+    def __repr__(self):
+        return '%s.Noise(%s)' % (self.__class__.__module__, str(self)[1:-1])
+
+
+cdef class _RampImpl(_Ramp):
+    """A ramp from `low` at distance `begin` to `high` at distance `end`.
+       A 'line' ramp measures distance along a ColorList, and a 'circle' ramp
+       measures it from the point (x, y) in rows of `width` colors."""
+
+    def __call__(self, object out, object channel=None):
+        """Fill one channel of out - or every channel, if channel is None -
+           with the ramp, and return out.  If out is a number, a new ColorList
+           of that length is returned."""
+        cdef ColorListRGB cl = _generator_output(out)
+        cdef int c = _generator_channel(channel)
+        with nogil:
+            generate(self.cdata, cl.cdata, c)
+        cl._touch_all()
+        return cl
+
+    def __repr__(self):
+        return '%s.Ramp(%s)' % (self.__class__.__module__, str(self)[1:-1])
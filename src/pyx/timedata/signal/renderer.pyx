@@ -2,17 +2,25 @@ cdef extern from "<timedata/color/renderer.h>" namespace "timedata::color_list":
     cdef cppclass CRenderer:
         CRenderer(Render3&)
         CRenderer()
-        void render(float level, CColorListRGB& input, char* output)
+        void render(float level, CColorListRGB& input, char* output) nogil
+        DirtyRanges& renderDirty(float level, CColorListRGB& input,
+                                 DirtyRanges& dirty, char* output) nogil
+        size_t bytesPerColor()
+        void resetDither()
+        Isa isa()
+        void setIsa(Isa)
 
 
 cdef class Renderer(_Render3):
     cdef CRenderer renderer
     cdef float level
 
-    def __init__(self, *, level=1.0, **kwds):
+    def __init__(self, *, level=1.0, isa=None, **kwds):
         super().__init__(**kwds)
         self.renderer = CRenderer(self.cdata)
         self.level = level
+        if isa is not None:
+            self.isa = isa
 
     property level:
         def __get__(self):
@@ -20,12 +28,313 @@ cdef class Renderer(_Render3):
         def __set__(self, float x):
             self.level = x
 
+    property isa:
+        """The instruction set used to render: one of ISA_NAMES.
+
+           If the CPU doesn't support the requested instruction set, the best
+           one that it does support is used instead."""
+        def __get__(self):
+            return isaName(self.renderer.isa()).decode('ascii')
+        def __set__(self, object x):
+            self.renderer.setIsa(_to_isa(x))
+
+    def reset_dither(self):
+        """Forget the rounding errors that the dither8 output carries over
+           from one frame to the next."""
+        self.renderer.resetDither()
+
     def render(self, object colors, bytearray output=None):
+        """Render colors into output, a bytearray with at least 3 bytes per
+           color, or 6 for the bits16 output.  bits16 writes each component
+           as two bytes, most significant first."""
         cdef ColorListRGB _colors
         if isinstance(colors, ColorListRGB):
             _colors = colors
         else:
             _colors = ColorListRGB(colors)
-        output = output or bytearray(3 * _colors.cdata.size())
-        self.renderer.render(self.level, _colors.cdata, output)
+        cdef size_t size = self.renderer.bytesPerColor() * _colors.cdata.size()
+        output = output or bytearray(size)
+        if <size_t> len(output) < size:
+            raise ValueError('Need %d bytes of output, not %d' %
+                             (size, len(output)))
+        cdef char* buffer = output
+        with nogil:
+            self.renderer.render(self.level, _colors.cdata, buffer)
+        return output
+
+    def render_dirty(self, ColorListRGB colors, bytearray output,
+                     bool clear=True):
+        """Render only the dirty colors of `colors` into output, which must
+           already hold the last frame that this Renderer rendered, and return
+           a tuple of the ranges (begin, end) of bytes that were written, for
+           transports that send partial updates.
+
+           Every color is rendered if there was no last frame, if the level or
+           the number of colors changed since then, or for the dither8
+           output.  If `clear` is true, colors.clear_dirty() is called."""
+        cdef size_t size = self.renderer.bytesPerColor() * colors.cdata.size()
+        if <size_t> len(output) < size:
+            raise ValueError('Need %d bytes of output, not %d' %
+                             (size, len(output)))
+        cdef char* buffer = output
+        cdef DirtyRanges rendered
+        with nogil:
+            rendered = self.renderer.renderDirty(
+                self.level, colors.cdata, colors._dirty, buffer)
+        if clear:
+            colors._dirty.clear()
+        return _dirty_tuple(rendered, self.renderer.bytesPerColor())
+
+
+cdef extern from "<timedata/color/frameExchange.h>" namespace "timedata::color_list":
+    cdef cppclass RenderedFrame:
+        vector[char] bytes
+        size_t size
+        CColorListRGB colors
+        uint64_t sequence
+
+    cdef cppclass CFrameExchange:
+        CFrameExchange()
+        void resize(size_t frameSize, size_t colorCount)
+        size_t frameSize()
+        size_t colorCount()
+        bool render(CRenderer&, float level, CColorListRGB& colors) nogil
+        bool publish(char* data, size_t size) nogil
+        bool acquire() nogil
+        RenderedFrame& front()
+
+
+cdef class _FrameView:
+    """A read-only view of the bytes of one frame of a FrameExchange."""
+    cdef FrameExchange exchange
+    cdef char* data
+    cdef Py_ssize_t size
+
+    def __getbuffer__(self, Py_buffer* buffer, int flags):
+        if flags & PyBUF_WRITABLE:
+            raise BufferError('Frames are read-only')
+        buffer.buf = self.data
+        buffer.obj = self
+        buffer.len = self.size
+        buffer.readonly = 1
+        buffer.itemsize = 1
+        buffer.format = NULL
+        buffer.ndim = 1
+        buffer.shape = NULL
+        buffer.strides = NULL
+        buffer.suboffsets = NULL
+        buffer.internal = NULL
+        if flags & PyBUF_FORMAT:
+            buffer.format = 'B'
+        if (flags & PyBUF_ND) == PyBUF_ND:
+            buffer.shape = &self.size
+
+    def __releasebuffer__(self, Py_buffer* buffer):
+        pass
+
+
+cdef class FrameExchange:
+    """Hands rendered frames from one compute thread to one output thread
+       without locks or copies, holding the latest frame in one of three
+       preallocated frames.
+
+       The compute thread calls render() or publish(), and the output thread
+       calls acquire() to get the latest complete frame.  Neither ever waits
+       for the other, and both release the GIL while they work.  Frames that
+       the output thread was too slow to see are dropped, as shown by gaps in
+       `sequence`."""
+    cdef CFrameExchange cdata
+
+    def __init__(self, size_t frame_size, size_t color_count=0):
+        """Hold frames of up to frame_size bytes, rendered from up to
+           color_count colors.  If color_count is 0, enough colors for
+           frame_size bytes of 8-bit output are allowed."""
+        self.cdata.resize(frame_size, color_count or frame_size // 3)
+
+    property frame_size:
+        def __get__(self):
+            return self.cdata.frameSize()
+
+    property color_count:
+        def __get__(self):
+            return self.cdata.colorCount()
+
+    property sequence:
+        """The number of the latest acquired frame: frames are numbered from 1
+           as they are published, and 0 means no frame has been acquired."""
+        def __get__(self):
+            return self.cdata.front().sequence
+
+    def render(self, Renderer renderer, ColorListRGB colors):
+        """Render colors into the next frame with renderer, and publish it.
+           The compute thread calls this."""
+        cdef bool ok
+        with nogil:
+            ok = self.cdata.render(renderer.renderer, renderer.level,
+                                   colors.cdata)
+        if not ok:
+            raise ValueError('%d colors do not fit in a frame' %
+                             colors.cdata.size())
+
+    def publish(self, object data):
+        """Copy a buffer of bytes into the next frame, and publish it.  The
+           compute thread calls this."""
+        cdef Py_buffer view
+        cdef bool ok
+        PyObject_GetBuffer(data, &view, PyBUF_C_CONTIGUOUS)
+        try:
+            with nogil:
+                ok = self.cdata.publish(<char*> view.buf, view.len)
+        finally:
+            PyBuffer_Release(&view)
+        if not ok:
+            raise ValueError('%d bytes do not fit in a frame of %d' %
+                             (len(data), self.cdata.frameSize()))
+
+    def acquire(self):
+        """Return a read-only memoryview of the bytes of the latest frame, or
+           None if no frame has been published since the last call.  The
+           output thread calls this.
+
+           The view holds no copy of the frame: it is only good until the next
+           call to acquire(), after which the compute thread can overwrite
+           it."""
+        cdef bool fresh
+        with nogil:
+            fresh = self.cdata.acquire()
+        if not fresh:
+            return None
+        cdef _FrameView view = _FrameView()
+        view.exchange = self
+        view.data = <char*> self.cdata.front().bytes.data()
+        view.size = self.cdata.front().size
+        return memoryview(view)
+
+    def colors(self):
+        """Return a copy of the colors that the latest acquired frame was
+           rendered from."""
+        cdef ColorListRGB colors = ColorListRGB()
+        colors.cdata = self.cdata.front().colors
+        return colors
+
+
+cdef extern from "<timedata/color/segmentRenderer.h>" namespace "timedata::color_list":
+    cdef cppclass CSegmentRenderer:
+        CSegmentRenderer()
+        bool add(Render3&, size_t begin, size_t end, size_t offset)
+        void clear()
+        size_t size()
+        size_t inputSize()
+        size_t frameSize()
+        bool render(float level, CColorListRGB& input, char* output,
+                    size_t size) nogil
+        void resetDither()
+        Isa isa()
+        void setIsa(Isa)
+
+
+cdef class SegmentRenderer:
+    """Render a whole frame for many LED strips in one call.
+
+       Each segment renders a range of colors from one ColorListRGB into its
+       own place in one output frame, with its own gamma, limits and
+       permutation, so strips with different chipsets can share one buffer.
+
+       A segment is a tuple (begin, end, offset, render): it renders
+       colors[begin:end] into the bytes of the frame starting at `offset`.
+       `render` is a Render3, a dictionary of Render3 settings, or None for
+       the default settings.  If `offset` is None, the segment starts at the
+       end of the frame so far."""
+    cdef CSegmentRenderer cdata
+    cdef float level
+
+    def __init__(self, segments=(), *, level=1.0, isa=None):
+        self.level = level
+        if isa is not None:
+            self.isa = isa
+        for s in segments:
+            self.add(*s)
+
+    def __len__(self):
+        return self.cdata.size()
+
+    property level:
+        def __get__(self):
+            return self.level
+        def __set__(self, float x):
+            self.level = x
+
+    property isa:
+        """The instruction set used to render: one of ISA_NAMES."""
+        def __get__(self):
+            return isaName(self.cdata.isa()).decode('ascii')
+        def __set__(self, object x):
+            self.cdata.setIsa(_to_isa(x))
+
+    property frame_size:
+        """The smallest number of bytes in an output frame."""
+        def __get__(self):
+            return self.cdata.frameSize()
+
+    property input_size:
+        """The smallest number of colors in an input list."""
+        def __get__(self):
+            return self.cdata.inputSize()
+
+    def add(self, size_t begin, size_t end, offset=None, render=None):
+        """Add one segment, and return self."""
+        cdef _Render3 r
+        if render is None:
+            r = _Render3()
+        elif isinstance(render, _Render3):
+            r = render
+        else:
+            r = _Render3(**render)
+
+        cdef size_t off = self.cdata.frameSize() if offset is None else offset
+        if not self.cdata.add(r.cdata, begin, end, off):
+            raise ValueError('Segment (%s, %s, %s) is backward or overlaps '
+                             'another segment' % (begin, end, off))
+        return self
+
+    def clear(self):
+        """Remove all the segments."""
+        self.cdata.clear()
+
+    def reset_dither(self):
+        """Forget the rounding errors that the dither8 output carries over
+           from one frame to the next."""
+        self.cdata.resetDither()
+
+    def render(self, object colors, object output=None):
+        """Render all the segments of `colors` into `output`, which may be any
+           writable buffer, and return it.  If `output` is None, a new
+           bytearray of frame_size bytes is returned.  Bytes of the output
+           that no segment covers are left unchanged."""
+        cdef ColorListRGB _colors
+        cdef Py_buffer view
+        cdef Py_ssize_t size
+        cdef bool ok
+
+        if isinstance(colors, ColorListRGB):
+            _colors = colors
+        else:
+            _colors = ColorListRGB(colors)
+        if output is None:
+            output = bytearray(self.cdata.frameSize())
+
+        PyObject_GetBuffer(output, &view, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS)
+        size = view.len
+        try:
+            with nogil:
+                ok = self.cdata.render(self.level, _colors.cdata,
+                                       <char*> view.buf, size)
+        finally:
+            PyBuffer_Release(&view)
+
+        if not ok:
+            raise ValueError(
+                'Need at least %d colors and %d bytes of output, not %d and %d'
+                % (self.cdata.inputSize(), self.cdata.frameSize(),
+                   _colors.cdata.size(), size))
         return output
@@ -0,0 +1,94 @@
+cdef extern from "<timedata/signal/timeline.h>" namespace "timedata":
+    cdef cppclass CTimelineRGB "timedata::Timeline<timedata::color_list::CColorListRGB>":
+        bool add(double time, CColorListRGB& list, Type type)
+        void remove(size_t i)
+        void clear()
+        size_t size()
+        size_t listSize()
+        double time(size_t i)
+        CColorListRGB& list(size_t i)
+        Type type(size_t i)
+        size_t segment(double t)
+        void evaluate(double t, CColorListRGB& out) nogil
+        void stream(double t, CColorListRGB& out) nogil
+        void rewind()
+
+
+cdef class Timeline:
+    """A sequence of keyframes, each a ColorList at a time, that animates from
+       each keyframe to the next with a Fade curve of type 'linear', 'sqr' or
+       'sqrt'.
+
+       Every keyframe's ColorList has the same length.  Before the first
+       keyframe, the frame is the first ColorList, and after the last
+       keyframe it is the last one."""
+    cdef CTimelineRGB cdata
+
+    def __init__(self, keyframes=()):
+        """Create a Timeline from a sequence of keyframes, each a pair
+           (time, colors) or a triple (time, colors, type)."""
+        for k in keyframes:
+            self.add(*k)
+
+    def add(self, double time, object colors, object type='linear'):
+        """Add a keyframe at `time`, replacing any keyframe at that time."""
+        cdef ColorListRGB cl = (colors if isinstance(colors, ColorListRGB)
+                                else ColorListRGB(colors))
+        cdef _Fade fade = _Fade()
+        fade.type = type
+        if not self.cdata.add(time, cl.cdata, fade.cdata.type):
+            raise ValueError('Keyframe has %d colors but the timeline has %d' %
+                             (cl.cdata.size(), self.cdata.listSize()))
+
+    def remove(self, size_t index):
+        """Remove the keyframe at index `index`."""
+        if index >= self.cdata.size():
+            raise IndexError('Timeline index out of range')
+        self.cdata.remove(index)
+
+    def clear(self):
+        self.cdata.clear()
+
+    def __len__(self):
+        return self.cdata.size()
+
+    def __getitem__(self, size_t index):
+        """Return the keyframe at index `index` as a triple
+           (time, colors, type)."""
+        if index >= self.cdata.size():
+            raise IndexError('Timeline index out of range')
+        cdef ColorListRGB cl = ColorListRGB()
+        cl.cdata = self.cdata.list(index)
+        return (self.cdata.time(index), cl,
+                _Fade.TYPE_NAMES[<int> self.cdata.type(index)])
+
+    def segment(self, double t):
+        """Return the index of the last keyframe at or before time t, or 0 if
+           t is before the first keyframe."""
+        return self.cdata.segment(t)
+
+    def __call__(self, double t, ColorListRGB out=None):
+        """Put the frame at time t into out and return it.  If out is None, a
+           new ColorList is returned."""
+        if out is None:
+            out = ColorListRGB()
+        out._check_resize(self.cdata.listSize())
+        with nogil:
+            self.cdata.evaluate(t, out.cdata)
+        out._touch_all()
+        return out
+
+    def stream(self, double t, ColorListRGB out=None):
+        """Like calling the Timeline, but faster when t increases from call to
+           call, as it does during playback."""
+        if out is None:
+            out = ColorListRGB()
+        out._check_resize(self.cdata.listSize())
+        with nogil:
+            self.cdata.stream(t, out.cdata)
+        out._touch_all()
+        return out
+
+    def rewind(self):
+        """Forget the position remembered by stream()."""
+        self.cdata.rewind()
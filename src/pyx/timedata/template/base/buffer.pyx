@@ -0,0 +1,79 @@
+### comment
+"""The Python buffer protocol for lists of samples."""
+
+### define
+    cdef Py_ssize_t _exports
+    cdef Py_ssize_t _shape[2]
+    cdef Py_ssize_t _strides[2]
+
+    def __getbuffer__($classname self, Py_buffer* buffer, int flags):
+        # Expose the samples without copying as a writable array of float32
+        # of shape (N, $size).
+        self._shape[0] = self.cdata.size()
+        self._shape[1] = $size
+        self._strides[0] = sizeof(C$sampleclass)
+        self._strides[1] = sizeof($number_type)
+
+        buffer.buf = <void*> self.cdata.data()
+        buffer.obj = self
+        buffer.len = self._shape[0] * self._strides[0]
+        buffer.readonly = 0
+        buffer.itemsize = sizeof($number_type)
+        buffer.format = NULL
+        buffer.ndim = 2
+        buffer.shape = NULL
+        buffer.strides = NULL
+        buffer.suboffsets = NULL
+        buffer.internal = NULL
+        if flags & PyBUF_FORMAT:
+            buffer.format = 'f'
+        if (flags & PyBUF_ND) == PyBUF_ND:
+            buffer.shape = self._shape
+        if (flags & PyBUF_STRIDES) == PyBUF_STRIDES:
+            buffer.strides = self._strides
+        self._exports += 1
+
+    def __releasebuffer__($classname self, Py_buffer* buffer):
+        self._exports -= 1
+
+    cdef int _check_resize($classname self, size_t size) except -1:
+        """Raise a BufferError if this list has exported its buffer and is
+           about to change to a different size, which could move its data."""
+        if self._exports and size != self.cdata.size():
+            raise BufferError('Existing exports of data: '
+                              '$classname cannot change size')
+        return 0
+
+    cdef str _read_buffer($classname self, object data, bool flat):
+        """Copy the samples from a buffer in a single pass, or return why the
+           buffer couldn't be read without changing this list."""
+        cdef Py_buffer view
+        cdef size_t size
+        try:
+            PyObject_GetBuffer(data, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT)
+        except (BufferError, ValueError) as e:
+            return str(e)
+
+        try:
+            error = _sample_buffer_error(&view, $size, flat)
+            if error:
+                return error
+            size = view.len // sizeof(C$sampleclass)
+            self._check_resize(size)
+            self.cdata.resize(size)
+            with nogil:
+                memmove(self.cdata.data(), view.buf, view.len)
+            self._touch_all()
+        finally:
+            PyBuffer_Release(&view)
+
+    @staticmethod
+    def from_buffer(object data):
+        """Return a new $classname holding a copy of a C-contiguous buffer of
+           float32, like a numpy array with shape (N, $size), or with shape
+           (..., $size), or a flat array of $size * N floats."""
+        cdef $classname cl = $classname()
+        error = cl._read_buffer(data, True)
+        if error:
+            raise ValueError(error)
+        return cl
@@ -0,0 +1,83 @@
+### comment
+"""A chain of arithmetic on a list, recorded to be evaluated in one pass."""
+
+### declare
+
+cdef extern from "<$include_file>" namespace "$namespace":
+    cdef cppclass C$classname:
+        void push(Op)
+        void push(Op, $number_type)
+        void push(Op, C$sampleclass&)
+        void push(Op, C$listclass&)
+        size_t size()
+        void clear()
+
+    bool evaluate(C$classname&, C$listclass&, C$listclass&) nogil
+
+### define
+
+cdef class $classname:
+    """A chain of elementwise arithmetic on a $listclass, recorded to be
+       evaluated later in a single pass.
+
+       Calling a chain of methods like `cl.mul(a).add(b).pow(g)` directly
+       on a $listclass sweeps the whole list through memory once for each
+       operation.  An expression instead evaluates the whole chain on a small
+       tile of colors at a time, so each color is read and written just once.
+
+       Each method records one operation that means the same as the
+       $listclass method of the same name, and returns self, so calls can be
+       chained:
+
+           e = cl.expression().mul(a).add(b).pow(g).min_limit(0)
+           e.into(out)       # Evaluate into an existing list.
+           e.evaluate()      # Evaluate into a new list.
+
+       An expression keeps its input list and any list operands alive, and
+       sees any changes made to them before it's evaluated."""
+    cdef C$classname cdata
+    cdef $listclass input
+    cdef list operands
+
+    def __init__($classname self, $listclass input):
+        self.input = input
+        self.operands = []
+
+    def __len__($classname self):
+        return self.cdata.size()
+
+    property input:
+        def __get__($classname self):
+            return self.input
+
+    cpdef $classname clear($classname self):
+        """Forget all the recorded operations."""
+        self.cdata.clear()
+        self.operands = []
+        return self
+
+    cpdef $listclass into($classname self, $listclass out):
+        """Evaluate the expression into `out`, which may be the input list or
+           any of the list operands."""
+        cdef bool ok
+        out._check_resize(max(out.cdata.size(), self.input.cdata.size()))
+        with nogil:
+            ok = evaluate(self.cdata, self.input.cdata, out.cdata)
+        if not ok:
+            raise ValueError('A list operand is shorter than the input list')
+        out._touch_all()
+        return out
+
+    cpdef $listclass evaluate($classname self):
+        """Evaluate the expression into a new $listclass."""
+        return self.into($listclass())
+
+    cdef $classname _push($classname self, Op op, object c):
+        if isinstance(c, Number):
+            self.cdata.push(op, <$number_type> c)
+        elif isinstance(c, $sampleclass):
+            self.cdata.push(op, (<$sampleclass> c).cdata)
+        else:
+            self.cdata.push(op, (<$listclass?> c).cdata)
+            self.operands.append(c)
+        return self
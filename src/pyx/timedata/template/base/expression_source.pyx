@@ -0,0 +1,8 @@
+### comment
+"""Start an Expression on a list."""
+
+### define
+    def expression($classname self):
+        """Return a new ${classname}Expression, which records a chain of
+           arithmetic on this list to be evaluated later in a single pass."""
+        return ${classname}Expression(self)
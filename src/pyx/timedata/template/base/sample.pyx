@@ -17,6 +17,7 @@ cdef extern from "<$include_file>" namespace "$namespace":
 
 ### define
     MODEL = loadConverter[C$classname]()
+    MODEL_ID = converterId[C$classname]()
 
     names, by_name = _colors_by_name($classname)
 
@@ -39,7 +40,6 @@ cdef extern from "<$include_file>" namespace "$namespace":
 
         * Anything else throws an exception.
 """
-        cdef string model
         cdef uint64_t pointer
         while len(args) == 1:
             a = args[0]
@@ -53,14 +53,14 @@ cdef extern from "<$include_file>" namespace "$namespace":
             if isinstance(a, $classname):
                 self.cdata = (<$classname> a).cdata
                 return
-            m = getattr(a, 'MODEL', None)
-            if m:
-                model = m
+            model_id = getattr(a, 'MODEL_ID', None)
+            if model_id is not None:
                 pointer = a._get_pointer()
-                if convertSampleCython[C$classname](pointer, model, self.cdata):
+                if convertSampleCython[C$classname](
+                        pointer, model_id, self.cdata):
                     return
                 raise ValueError("Can't convert from model %s, value %s" %
-                                 (model, a))
+                                 (a.MODEL, a))
 
             try:
                 args = tuple(a)
@@ -7,57 +7,134 @@ cdef extern from "<$include_file>" namespace "$namespace":
     ctypedef vector[C$sampleclass] C$classname
 
     string toString(C$classname&)
-    C$classname sliceOut(C$classname&, int begin, int end, int step)
-    C$sampleclass max_cpp(C$classname&)
-    C$sampleclass min_cpp(C$classname&)
+    C$classname sliceOut(C$classname&, int begin, int end, int step) nogil
+    C$sampleclass max_cpp(C$classname&) nogil
+    C$sampleclass min_cpp(C$classname&) nogil
 
     bool cmpToRichcmp(float cmp, int richcmp)
-    $number_type compare(C$classname&, C$classname&)
-    $number_type compare(C$sampleclass&, C$classname&)
-    $number_type compare($number_type, C$classname&)
-    bool pop(C$classname&, int key, C$sampleclass&)
+    $number_type compare(C$classname&, C$classname&) nogil
+    $number_type compare(C$sampleclass&, C$classname&) nogil
+    $number_type compare($number_type, C$classname&) nogil
+    bool pop(C$classname&, int key, C$sampleclass&) nogil
     bool resolvePythonIndex(int& index, size_t size)
-    bool sliceInto(C$classname&, C$classname&, int begin, int end, int step)
+    bool sliceInto(C$classname&, C$classname&, int begin, int end, int step) nogil
 
-    int index(C$classname&, C$sampleclass&)
+    int index(C$classname&, C$sampleclass&) nogil
 
-    size_t count(C$classname&, C$sampleclass&)
+    size_t count(C$classname&, C$sampleclass&) nogil
 
-    void erase(int key, C$classname&)
-    void extend(C$classname&, C$classname&)
-    void insert(int key, C$sampleclass&, C$classname)
-    void rotate(C$classname&, int pos)
-    void rotate(C$classname&, C$classname&, int pos)
-    void round_cpp(C$classname&, size_t digits)
-    void round_cpp(C$classname&, C$classname&, size_t digits)
-    void sliceDelete(C$classname&, int begin, int end, int step)
-    void sort(C$classname&)
-    void sort(C$classname&, C$classname&, bool reverse)
-    void spreadAppend(C$sampleclass& end, size_t size, C$classname& out)
+    void erase(int key, C$classname&) nogil
+    void extend(C$classname&, C$classname&) nogil
+    void insert(int key, C$sampleclass&, C$classname&) nogil
+    void rotate(C$classname&, int pos) nogil
+    void rotate(C$classname&, C$classname&, int pos) nogil
+    void round_cpp(C$classname&, size_t digits) nogil
+    void round_cpp(C$classname&, C$classname&, size_t digits) nogil
+    void sliceDelete(C$classname&, int begin, int end, int step) nogil
+    void sort(C$classname&) nogil
+    void sort(C$classname&, C$classname&, bool reverse) nogil
+    void spreadAppend(C$sampleclass& end, size_t size, C$classname& out) nogil
 
 ### define
+    SAMPLE_MODEL = loadConverter[C$sampleclass]()
+    SAMPLE_MODEL_ID = converterId[C$sampleclass]()
+
+    cdef DirtyRanges _dirty
+
+    cdef void _touch($classname self, size_t begin, size_t end):
+        """Mark the samples [begin, end) as dirty."""
+        self._dirty.add(begin, end)
+
+    cdef void _touch_from($classname self, size_t begin):
+        """Mark every sample from `begin` on as dirty, after a change that
+           might have moved them or changed the size of the list."""
+        self._dirty.truncate(self.cdata.size())
+        self._dirty.add(begin, self.cdata.size())
+
+    cdef void _touch_all($classname self):
+        self._touch_from(0)
+
+    property dirty:
+        """A tuple of ranges (begin, end) of the samples that have changed
+           since clear_dirty() was last called, sorted and never touching.
+
+           Changes made through the buffer protocol, as by numpy, can't be
+           seen: call mark_dirty() after them."""
+        def __get__($classname self):
+            return _dirty_tuple(self._dirty, 1)
+
+    def mark_dirty($classname self, size_t begin=0, end=None):
+        """Mark the samples [begin, end) as dirty, by default all of them,
+           and return self."""
+        self._touch(begin, self.cdata.size() if end is None else end)
+        return self
+
+    def clear_dirty($classname self):
+        """Mark every sample as clean, and return self."""
+        self._dirty.clear()
+        return self
+
     def __init__($classname self, items=None):
         """Construct a $classname with an iterator of items, each of which looks
-           like a $sampleclass."""
+           like a $sampleclass.
+
+           A list of samples of another model, like a ColorListHSV, is
+           converted in a single pass, as is a buffer of float32 with shape
+           (N, $size), like a numpy array."""
         cdef $sampleclass s
         cdef size_t i
+        cdef size_t model_id
+        cdef uint64_t pointer
+        cdef bool ok
         if items is not None:
             if isinstance(items, $classname):
                 self.cdata = (<$classname> items).cdata
+            elif getattr(items, 'SAMPLE_MODEL_ID', None) is not None:
+                # Another list class - this has to come before the buffer
+                # protocol, which would copy its samples without converting.
+                model_id = items.SAMPLE_MODEL_ID
+                pointer = items._get_pointer()
+                self._check_resize(len(items))
+                with nogil:
+                    ok = convertListCython[C$classname](
+                        pointer, model_id, self.cdata)
+                if not ok:
+                    raise ValueError("Can't convert from model %s" %
+                                     items.SAMPLE_MODEL)
+            elif (PyObject_CheckBuffer(items) and
+                  self._read_buffer(items, False) is None):
+                pass
             else:
                 # A list of tuples, $classname or strings.
                 self.cdata.resize(len(items))
                 for i, item in enumerate(items):
                     self.cdata[i] = $sampleclass(item).cdata
+            self._touch_all()
 
     def __setitem__($classname self, object key, object x):
         cdef size_t length, slice_length
         cdef int begin, end, step, index
+        cdef object indices
+        cdef bool ok
         cdef $classname cl
         if isinstance(key, slice):
             begin, end, step = key.indices(self.cdata.size())
             cl = x if isinstance(x, $classname) else $classname(x)
-            if sliceInto(cl.cdata, self.cdata, begin, end, step):
+            if step == 1:
+                self._check_resize(self.cdata.size() + cl.cdata.size() -
+                                   len(range(begin, end)))
+            with nogil:
+                ok = sliceInto(cl.cdata, self.cdata, begin, end, step)
+            if ok:
+                indices = range(begin, end, step)
+                if step != 1:
+                    if indices:
+                        self._touch(min(indices[0], indices[-1]),
+                                    max(indices[0], indices[-1]) + 1)
+                elif len(indices) == cl.cdata.size():
+                    self._touch(begin, begin + cl.cdata.size())
+                else:
+                    self._touch_from(begin)
                 return
             raise ValueError('attempt to assign sequence of one size '
                              'to extended slice of another size')
@@ -65,6 +142,7 @@ cdef extern from "<$include_file>" namespace "$namespace":
         if not resolvePythonIndex(index, self.cdata.size()):
             raise IndexError('$classname index out of range %s' % key)
         self.cdata[index] = $sampleclass(x).cdata
+        self._touch(index, index + 1)
 
     def __getitem__($classname self, object key):
         cdef $sampleclass s
@@ -73,7 +151,8 @@ cdef extern from "<$include_file>" namespace "$namespace":
         if isinstance(key, slice):
             begin, end, step = key.indices(self.cdata.size())
             cl = $classname()
-            cl.cdata = sliceOut(self.cdata, begin, end, step)
+            with nogil:
+                cl.cdata = sliceOut(self.cdata, begin, end, step)
             return cl
         k = key
         if not resolvePythonIndex(k, self.cdata.size()):
@@ -84,52 +163,84 @@ cdef extern from "<$include_file>" namespace "$namespace":
 
     def __delitem__($classname self, object key):
         cdef int k, begin, end, step
+        cdef object indices
         if isinstance(key, slice):
             begin, end, step = key.indices(self.cdata.size())
-            sliceDelete(self.cdata, begin, end, step)
+            self._check_resize(self.cdata.size() -
+                               len(range(begin, end, step)))
+            with nogil:
+                sliceDelete(self.cdata, begin, end, step)
+            indices = range(begin, end, step)
+            if indices:
+                self._touch_from(min(indices[0], indices[-1]))
         else:
             k = key
             if not resolvePythonIndex(k, self.cdata.size()):
                 raise IndexError('$classname index out of range %s' % key)
-            erase(k, self.cdata)
+            self._check_resize(self.cdata.size() - 1)
+            with nogil:
+                erase(k, self.cdata)
+            self._touch_from(k)
 
     def __len__($classname self):
         return self.cdata.size()
 
+    cpdef uint64_t _get_pointer($classname self):
+        return referenceToInteger(self.cdata)
+
     def __richcmp__(object self, object other, int rcmp):
-        cdef $classname cl
+        cdef $classname cl, x
+        cdef $sampleclass s
         cdef bool inv = not isinstance(self, $classname)
-        cdef $number_type c, mult = 1
+        cdef $number_type c, n, mult = 1
         if not inv:
             self, other = other, self
             mult = -1
         cl = <$classname> self
         if isinstance(other, Number):
-            c = compare((<$number_type> other), cl.cdata)
+            n = other
+            with nogil:
+                c = compare(n, cl.cdata)
         elif isinstance(other, $sampleclass):
-            c = compare((<$sampleclass> other).cdata, cl.cdata)
+            s = <$sampleclass> other
+            with nogil:
+                c = compare(s.cdata, cl.cdata)
         else:
-            c = compare((<$classname> other).cdata, cl.cdata)
+            x = <$classname> other
+            with nogil:
+                c = compare(x.cdata, cl.cdata)
         return cmpToRichcmp(mult * c, rcmp)
 
     cpdef $classname append($classname self, $sampleclass c):
         """Append to the list of samples."""
+        self._check_resize(self.cdata.size() + 1)
         self.cdata.push_back(c.cdata)
+        self._touch_from(self.cdata.size() - 1)
         return self
 
     cpdef size_t count(self, $sampleclass sample):
         """Return the number of times a sample appears in this list."""
-        return count(self.cdata, sample.cdata)
+        cdef size_t result
+        with nogil:
+            result = count(self.cdata, sample.cdata)
+        return result
 
     cpdef $classname extend($classname self, object values):
         """Extend the samples from an iterator."""
-        extend($classname(values).cdata, self.cdata)
+        cdef $classname cl = $classname(values)
+        cdef size_t size = self.cdata.size()
+        self._check_resize(size + cl.cdata.size())
+        with nogil:
+            extend(cl.cdata, self.cdata)
+        self._touch_from(size)
         return self
 
     cpdef index($classname self, $sampleclass sample):
         """Returns an index to the first occurance of that Sample, or
            raises a ValueError if that Sample isn't there."""
-        cdef int id = index(self.cdata, sample.cdata)
+        cdef int id
+        with nogil:
+            id = index(self.cdata, sample.cdata)
         if id >= 0:
             return id
         raise ValueError('Can\'t find sample %s' % sample)
@@ -137,13 +248,27 @@ cdef extern from "<$include_file>" namespace "$namespace":
     cpdef $classname insert($classname self, int key,
                            $sampleclass sample):
         """Insert a sample before key."""
-        insert(key, sample.cdata, self.cdata)
+        cdef int k = key
+        if not resolvePythonIndex(k, self.cdata.size()):
+            k = max(0, min(<int> self.cdata.size(), k))
+        self._check_resize(self.cdata.size() + 1)
+        with nogil:
+            insert(key, sample.cdata, self.cdata)
+        self._touch_from(k)
         return self
 
     cpdef $sampleclass pop($classname self, int key = -1):
         """Pop the sample at key."""
         cdef $sampleclass result = $sampleclass()
-        if pop(self.cdata, key, result.cdata):
+        cdef bool ok
+        cdef int k = key
+        if self.cdata.size():
+            self._check_resize(self.cdata.size() - 1)
+        resolvePythonIndex(k, self.cdata.size())
+        with nogil:
+            ok = pop(self.cdata, key, result.cdata)
+        if ok:
+            self._touch_from(k)
             return result
         raise IndexError('pop index out of range')
 
@@ -152,25 +277,42 @@ cdef extern from "<$include_file>" namespace "$namespace":
         self.pop(self.index(sample))
         return self
 
+    cpdef $classname clear($classname self):
+        """Remove all the samples."""
+        self._check_resize(0)
+        self.cdata.clear()
+        self._dirty.clear()
+        return self
+
     cpdef $classname resize($classname self, size_t size):
         """Set the size of the SampleList, filling with black if needed."""
+        cdef size_t old_size = self.cdata.size()
+        self._check_resize(size)
         self.cdata.resize(size)
+        self._touch_from(min(size, old_size))
         return self
 
     cpdef $classname rotate(self, int pos):
         """In-place rotation of the samples forward by `pos` positions."""
-        rotate(self.cdata, pos)
+        with nogil:
+            rotate(self.cdata, pos)
+        self._touch_all()
         return self
 
     cpdef $classname rotate_to(self, int pos, $classname out):
         """In-place rotation of the samples forward by `pos` positions."""
-        rotate(self.cdata, out.cdata, pos)
+        out._check_resize(max(out.cdata.size(), self.cdata.size()))
+        with nogil:
+            rotate(self.cdata, out.cdata, pos)
+        out._touch_all()
         return out
 
     def sort($classname self, object key=None, bool reverse=False):
         """Sort."""
         if key is None:
-            sort(self.cdata)
+            with nogil:
+                sort(self.cdata)
+            self._touch_all()
             if reverse:
                 self.reverse()
         else:
@@ -182,7 +324,10 @@ cdef extern from "<$include_file>" namespace "$namespace":
                 object key=None, bool reverse=False):
         """Sort to another vector."""
         if key is None:
-            sort(self.cdata, out.cdata, reverse)
+            out._check_resize(max(out.cdata.size(), self.cdata.size()))
+            with nogil:
+                sort(self.cdata, out.cdata, reverse)
+            out._touch_all()
         else:
             # Use Python.
             out[:] = sorted(self, key=key, reverse=reverse)
@@ -190,38 +335,51 @@ cdef extern from "<$include_file>" namespace "$namespace":
 
     cpdef $classname round($classname self, uint digits=0):
         """Round each element in each sample to the nearest integer."""
-        round_cpp(self.cdata, digits)
+        with nogil:
+            round_cpp(self.cdata, digits)
+        self._touch_all()
         return self
 
     cpdef $classname round_to($classname self, $classname out, uint digits=0):
         """Round each element in each sample to the nearest integer."""
-        round_cpp(self.cdata, out.cdata, digits)
+        out._check_resize(max(out.cdata.size(), self.cdata.size()))
+        with nogil:
+            round_cpp(self.cdata, out.cdata, digits)
+        out._touch_all()
         return out
 
     cpdef $sampleclass max(self):
         """Return the maximum values of each component."""
         cdef $sampleclass result = $sampleclass()
-        result.cdata = max_cpp(self.cdata)
+        with nogil:
+            result.cdata = max_cpp(self.cdata)
         return result
 
     cpdef $sampleclass min(self):
         """Return the minimum values of each component/"""
         cdef $sampleclass result = $sampleclass()
-        result.cdata = min_cpp(self.cdata)
+        with nogil:
+            result.cdata = min_cpp(self.cdata)
         return result
 
     @staticmethod
     def spread(*args):
         """Spreads!"""
         cdef $classname cl = $classname()
-        cdef $sampleclass sample
         cdef size_t last_number = 0
 
         def spread_append(item):
             nonlocal last_number
+            cdef $sampleclass end
+            cdef $classname out = cl
+            cdef size_t size, old_size
             if last_number:
-                sample = $sampleclass(item)
-                spreadAppend(sample.cdata, last_number - 1, cl.cdata)
+                end = $sampleclass(item)
+                size = last_number - 1
+                old_size = out.cdata.size()
+                with nogil:
+                    spreadAppend(end.cdata, size, out.cdata)
+                out._touch_from(old_size)
                 last_number = 0
 
         for a in args:
@@ -1,25 +1,30 @@
 ### declare
-    void math_$name(C$classname&, $number_type, C$classname&)
-    void math_$name(C$classname&, C$sampleclass&, C$classname&)
-    void math_$name(C$classname&, C$classname&, C$classname&)
+    void math_$name(C$classname&, $number_type, C$classname&) nogil
+    void math_$name(C$classname&, C$sampleclass&, C$classname&) nogil
+    void math_$name(C$classname&, C$classname&, C$classname&) nogil
 
 ### define
     cpdef $classname $name($classname self, object c):
         """$documentation into this $classname."""
-        if isinstance(c, Number):
-            math_$name(self.cdata, <$number_type> c, self.cdata)
-        elif isinstance(c, $sampleclass):
-            math_$name(self.cdata, (<$sampleclass> c).cdata, self.cdata)
-        else:
-            math_$name(self.cdata, (<$classname> c).cdata, self.cdata)
-        return self
+        return self.${name}_to(c, self)
 
     cpdef $classname ${name}_to($classname self, object c, $classname x):
         """$documentation onto another $classname."""
+        cdef $number_type n
+        cdef $sampleclass s
+        cdef $classname cl
+        x._check_resize(max(x.cdata.size(), self.cdata.size()))
         if isinstance(c, Number):
-            math_$name(self.cdata, <$number_type> c, x.cdata)
+            n = c
+            with nogil:
+                math_$name(self.cdata, n, x.cdata)
         elif isinstance(c, $sampleclass):
-            math_$name(self.cdata, (<$sampleclass> c).cdata, x.cdata)
+            s = c
+            with nogil:
+                math_$name(self.cdata, s.cdata, x.cdata)
         else:
-            math_$name(self.cdata, (<$classname> c).cdata, x.cdata)
+            cl = c
+            with nogil:
+                math_$name(self.cdata, cl.cdata, x.cdata)
+        x._touch_all()
         return x
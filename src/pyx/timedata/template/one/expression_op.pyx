@@ -0,0 +1,5 @@
+### define
+    cpdef $classname $name($classname self, object c):
+        """Record $listclass.$name() with a number, $sampleclass or $listclass
+           operand."""
+        return self._push(OP_$name, c)
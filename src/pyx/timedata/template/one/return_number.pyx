@@ -1,8 +1,11 @@
 ### declare
-    $number_type $name(C$classname&, C$classname&)
+    $number_type $name(C$classname&, C$classname&) nogil
 
 ### define
     cpdef $number_type $name($classname self, object x):
         """$documentation"""
         cdef $classname s = x if isinstance(x, $classname) else $classname(x)
-        return $name(self.cdata, s.cdata)
+        cdef $number_type result
+        with nogil:
+            result = $name(self.cdata, s.cdata)
+        return result
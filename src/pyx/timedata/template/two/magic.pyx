@@ -3,15 +3,20 @@
 """A magic method with two arguments that returns a class."""
 
 ### declare
-    void magic_$name(C$classname&, C$classname&)
+    void magic_$name(C$classname&, C$classname&) nogil
 
 ### define
     def __${name}__($classname self, $classname x):
         cdef $classname result = $classname()
-        result.cdata = self.cdata
-        magic_$name(x.cdata, result.cdata)
+        with nogil:
+            result.cdata = self.cdata
+            magic_$name(x.cdata, result.cdata)
         return result
 
     def __i${name}__($classname self, $classname x):
-        magic_$name(x.cdata, self.cdata)
+        cdef size_t size = self.cdata.size()
+        self._check_resize(size + x.cdata.size())
+        with nogil:
+            magic_$name(x.cdata, self.cdata)
+        self._touch_from(size)
         return self
@@ -3,7 +3,7 @@
 """The mul method for list like classes."""
 
 ### declare
-    void magic_$name(size_t size, C$classname&)
+    void magic_$name(size_t size, C$classname&) nogil
 
 ### define
     def __${name}__(object self, object other):
@@ -11,17 +11,23 @@
         # A little tricky because the $classname can appear on the left or the
         # right side of the argument.
         cdef size_t mult
-        cdef $classname cl = $classname()
+        cdef $classname cl = $classname(), source
         if isinstance(self, $classname):
-            cl.cdata = (<$classname> self).cdata
+            source = <$classname> self
             mult = <size_t> other
         else:
-            cl.cdata = (<$classname> other).cdata
+            source = <$classname> other
             mult = <size_t> self
-        magic_$name(mult, cl.cdata)
+        with nogil:
+            cl.cdata = source.cdata
+            magic_$name(mult, cl.cdata)
         return cl
 
     def __i${name}__($classname self, size_t mult):
         """$documentation that writes into self."""
-        magic_$name(mult, self.cdata)
+        cdef size_t size = self.cdata.size()
+        self._check_resize(size * mult)
+        with nogil:
+            magic_$name(mult, self.cdata)
+        self._touch_from(min(size, self.cdata.size()))
         return self
@@ -0,0 +1,5 @@
+### define
+    cpdef $classname $name($classname self):
+        """Record $listclass.$name()."""
+        self.cdata.push(OP_$name)
+        return self
@@ -1,13 +1,18 @@
 ### declare
-    void math_$name(C$classname&, C$classname&)
+    void math_$name(C$classname&, C$classname&) nogil
 
 ### define
     cpdef $classname $name($classname self):
         """$documentation that mutates self."""
-        math_$name(self.cdata, self.cdata)
+        with nogil:
+            math_$name(self.cdata, self.cdata)
+        self._touch_all()
         return self
 
     cpdef $classname ${name}_to($classname self, $classname out):
         """$documentation that writes to another $classname."""
-        math_$name(self.cdata, out.cdata)
+        out._check_resize(max(out.cdata.size(), self.cdata.size()))
+        with nogil:
+            math_$name(self.cdata, out.cdata)
+        out._touch_all()
         return out
@@ -1,8 +1,10 @@
 ### declare
-    void math_$name(C$classname&)
+    void math_$name(C$classname&) nogil
 
 ### define
     cpdef $classname $name($classname self):
         """$documentation."""
-        math_$name(self.cdata)
+        with nogil:
+            math_$name(self.cdata)
+        self._touch_all()
         return self
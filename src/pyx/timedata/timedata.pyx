@@ -1,16 +1,28 @@
 TEMP_LOG = print
 
 include "src/pyx/timedata/base/stl.pyx"
+include "src/pyx/timedata/base/buffer.pyx"
 include "src/pyx/timedata/base/math.pyx"
+include "src/pyx/timedata/base/cpu.pyx"
+include "src/pyx/timedata/base/parallel.pyx"
+include "src/pyx/timedata/base/dirty.pyx"
+include "src/pyx/timedata/base/scheduler.pyx"
+include "src/pyx/timedata/base/instrument.pyx"
 include "src/pyx/timedata/base/modules.pyx"
 include "src/pyx/timedata/base/wrapper.pyx"
 include "src/pyx/timedata/base/timestamp.pyx"
 include "src/pyx/timedata/color/colors.pyx"
+include "src/pyx/timedata/color/expression.pyx"
 include "src/pyx/timedata/signal/convert.pyx"
 
 include "build/genfiles/timedata/genfiles.pyx"
 
-locals().update(Render3=_Render3, **_make_module())
+include "src/pyx/timedata/signal/fade.pyx"
+include "src/pyx/timedata/signal/timeline.pyx"
+include "src/pyx/timedata/signal/generator.pyx"
+
+locals().update(Fade=_FadeImpl, Noise=_NoiseImpl, Oscillator=_OscillatorImpl,
+               Ramp=_RampImpl, Render3=_Render3, **_make_module())
 
 include "src/pyx/timedata/signal/renderer.pyx"
 